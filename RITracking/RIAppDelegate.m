@@ -32,4 +32,9 @@
     return YES;
 }
 
+- (void)applicationDidReceiveMemoryWarning:(UIApplication *)application
+{
+    [[RITracking sharedInstance] compactQueuedEvents];
+}
+
 @end
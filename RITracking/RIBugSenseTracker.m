@@ -7,6 +7,7 @@
 //
 
 #import "RIBugSenseTracker.h"
+#import "RITrackerRegistry.h"
 #import <BugSense-iOS/BugSenseController.h>
 
 NSString * const kRIBugsenseAPIKey = @"RIBugsenseAPIKey";
@@ -15,6 +16,15 @@ NSString * const kRIBugsenseAPIKey = @"RIBugsenseAPIKey";
 
 @synthesize queue;
 
++ (void)load
+{
+    [RITrackerRegistry registerTrackerNamed:@"RIBugsense"
+                  requiredConfigurationKeys:@[kRIBugsenseAPIKey]
+                                    factory:^id<RITracker>{
+                                        return [[RIBugSenseTracker alloc] init];
+                                    }];
+}
+
 - (id)init
 {
     RIDebugLog(@"Initializing BugSense tracker");
@@ -35,7 +45,7 @@ NSString * const kRIBugsenseAPIKey = @"RIBugsenseAPIKey";
     NSString *apiKey = [RITrackingConfiguration valueForKey:kRIBugsenseAPIKey];
     
     if (!apiKey) {
-        RIRaiseError(@"Missing Bugsense API key in tracking properties")
+        RIRaiseError(@"Missing Bugsense API key in tracking properties");
         return;
     }
     
@@ -52,6 +62,7 @@ NSString * const kRIBugsenseAPIKey = @"RIBugsenseAPIKey";
     
     if (!result) {
         RIRaiseError(@"Unexpected negative result on logging exception with name: %@", name);
+        RITrackerReportFailure();
     }
 }
 
@@ -0,0 +1,73 @@
+//
+//  RIEventArena.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "RIEventRecord.h"
+
+@class RIEventJournal;
+
+/**
+ *  Size in bytes of the blocks handed out by the event arenas
+ */
+#define RI_EVENT_ARENA_BLOCK_SIZE 80
+
+/**
+ *  Allocate a block of RI_EVENT_ARENA_BLOCK_SIZE bytes from the calling thread's arena.
+ *
+ *  Every thread allocates from its own arena of fixed-size blocks, which only falls back to malloc
+ *  for a new slab of blocks once all its blocks are in use. The arena of an exiting thread is handed
+ *  on to the next thread needing one.
+ *
+ *  @return The block, not initialised, NULL if out of memory
+ */
+void *RIEventArenaAllocate(void);
+
+/**
+ *  Return a block to the arena it was allocated from. May be called from any thread.
+ *
+ *  @param block A block returned by RIEventArenaAllocate.
+ */
+void RIEventArenaFree(void *block);
+
+/**
+ *  The number of slabs the event arenas allocated, to tell how often allocation fell back to malloc
+ *
+ *  @return The count
+ */
+uint64_t RIEventArenaSlabCount(void);
+
+/**
+ *  Event record shared by all trackers it is dispatched to, allocated from an event arena
+ */
+typedef struct RIEventArenaRecord {
+    RIEventRecord record;
+    int32_t pendingCount;
+    const void *journal;
+} RIEventArenaRecord;
+
+/**
+ *  Move a record into an arena record to be consumed by a number of trackers
+ *
+ *  @param record The record, owned by the arena record afterwards.
+ *  @param consumerCount The number of trackers to consume the record.
+ *  @param journal (optional) The journal to acknowledge the record to once consumed by all trackers.
+ *
+ *  @return The arena record, NULL if there is no consumer or no memory and the record was disposed
+ *          right away
+ */
+RIEventArenaRecord *RIEventArenaRecordCreate(RIEventRecord *record,
+                                             NSUInteger consumerCount,
+                                             RIEventJournal *journal);
+
+/**
+ *  Mark an arena record consumed by one of its trackers. Once consumed by all trackers the record is
+ *  acknowledged to its journal, disposed and its block recycled.
+ *
+ *  @param record The arena record.
+ */
+void RIEventArenaRecordConsume(RIEventArenaRecord *record);
@@ -0,0 +1,168 @@
+//
+//  RIEventArena.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIEventArena.h"
+#import "RIEventJournal.h"
+#import <pthread.h>
+
+/**
+ *  Number of blocks allocated at once when an arena runs out of blocks
+ */
+#define RI_EVENT_ARENA_SLAB_BLOCKS 64
+
+typedef struct RIEventArena RIEventArena;
+
+typedef struct RIEventArenaBlock {
+    RIEventArena *arena;
+    struct RIEventArenaBlock *next;
+    char payload[RI_EVENT_ARENA_BLOCK_SIZE];
+} RIEventArenaBlock;
+
+/**
+ *  Blocks freed by the owning thread go to the local list, blocks freed by other threads to the
+ *  remote stack, which the owner takes over as a whole once the local list ran empty. Taking the
+ *  whole stack by exchange spares the ABA problem of popping single blocks.
+ */
+struct RIEventArena {
+    RIEventArenaBlock *local;
+    RIEventArenaBlock *remote;
+    RIEventArena *nextAbandoned;
+};
+
+_Static_assert(sizeof(RIEventArenaRecord) <= RI_EVENT_ARENA_BLOCK_SIZE,
+               "Arena record has to fit into an arena block");
+
+static pthread_key_t RIEventArenaKey;
+static pthread_once_t RIEventArenaKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t RIEventArenaMutex = PTHREAD_MUTEX_INITIALIZER;
+static RIEventArena *RIEventArenaAbandoned;
+static uint64_t RIEventArenaSlabs;
+
+static void RIEventArenaAbandon(void *value)
+{
+    // Blocks may still be in use by other threads, so the arena is kept for the next thread
+    RIEventArena *arena = value;
+    pthread_mutex_lock(&RIEventArenaMutex);
+    arena->nextAbandoned = RIEventArenaAbandoned;
+    RIEventArenaAbandoned = arena;
+    pthread_mutex_unlock(&RIEventArenaMutex);
+}
+
+static void RIEventArenaKeyCreate(void)
+{
+    pthread_key_create(&RIEventArenaKey, RIEventArenaAbandon);
+}
+
+static RIEventArena *RIEventArenaCurrent(void)
+{
+    pthread_once(&RIEventArenaKeyOnce, RIEventArenaKeyCreate);
+    RIEventArena *arena = pthread_getspecific(RIEventArenaKey);
+    
+    if (!arena) {
+        pthread_mutex_lock(&RIEventArenaMutex);
+        arena = RIEventArenaAbandoned;
+        if (arena) RIEventArenaAbandoned = arena->nextAbandoned;
+        pthread_mutex_unlock(&RIEventArenaMutex);
+        
+        if (!arena) arena = calloc(1, sizeof(RIEventArena));
+        if (!arena) return NULL;
+        arena->nextAbandoned = NULL;
+        pthread_setspecific(RIEventArenaKey, arena);
+    }
+    
+    return arena;
+}
+
+void *RIEventArenaAllocate(void)
+{
+    RIEventArena *arena = RIEventArenaCurrent();
+    if (!arena) return NULL;
+    
+    RIEventArenaBlock *block = arena->local;
+    
+    if (!block) {
+        block = __atomic_exchange_n(&arena->remote, NULL, __ATOMIC_ACQUIRE);
+    }
+    
+    if (!block) {
+        RIEventArenaBlock *slab = calloc(RI_EVENT_ARENA_SLAB_BLOCKS, sizeof(RIEventArenaBlock));
+        if (!slab) return NULL;
+        for (NSUInteger idx = 0; idx < RI_EVENT_ARENA_SLAB_BLOCKS; idx++) {
+            slab[idx].arena = arena;
+            slab[idx].next = idx + 1 < RI_EVENT_ARENA_SLAB_BLOCKS ? &slab[idx + 1] : NULL;
+        }
+        __atomic_add_fetch(&RIEventArenaSlabs, 1, __ATOMIC_RELAXED);
+        block = slab;
+    }
+    
+    arena->local = block->next;
+    return block->payload;
+}
+
+void RIEventArenaFree(void *payload)
+{
+    RIEventArenaBlock *block = (RIEventArenaBlock *)((char *)payload - offsetof(RIEventArenaBlock, payload));
+    RIEventArena *arena = block->arena;
+    
+    // The key exists, as the block was allocated before
+    if (arena == pthread_getspecific(RIEventArenaKey)) {
+        block->next = arena->local;
+        arena->local = block;
+        return;
+    }
+    
+    RIEventArenaBlock *head = __atomic_load_n(&arena->remote, __ATOMIC_RELAXED);
+    do {
+        block->next = head;
+    } while (!__atomic_compare_exchange_n(&arena->remote, &head, block, YES,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+uint64_t RIEventArenaSlabCount(void)
+{
+    return __atomic_load_n(&RIEventArenaSlabs, __ATOMIC_RELAXED);
+}
+
+#pragma mark - Arena records
+
+RIEventArenaRecord *RIEventArenaRecordCreate(RIEventRecord *record,
+                                             NSUInteger consumerCount,
+                                             RIEventJournal *journal)
+{
+    if (0 == consumerCount) {
+        if (record->journalIdentifier) [journal acknowledgeIdentifier:record->journalIdentifier];
+        RIEventRecordDispose(record);
+        return NULL;
+    }
+    
+    RIEventArenaRecord *arenaRecord = RIEventArenaAllocate();
+    
+    if (!arenaRecord) {
+        if (record->journalIdentifier) [journal acknowledgeIdentifier:record->journalIdentifier];
+        RIEventRecordDispose(record);
+        return NULL;
+    }
+    
+    arenaRecord->record = *record;
+    arenaRecord->pendingCount = (int32_t)consumerCount;
+    arenaRecord->journal = record->journalIdentifier ? CFBridgingRetain(journal) : NULL;
+    return arenaRecord;
+}
+
+void RIEventArenaRecordConsume(RIEventArenaRecord *record)
+{
+    if (0 != __atomic_sub_fetch(&record->pendingCount, 1, __ATOMIC_ACQ_REL)) return;
+    
+    if (record->journal) {
+        RIEventJournal *journal = CFBridgingRelease(record->journal);
+        [journal acknowledgeIdentifier:record->record.journalIdentifier];
+    }
+    
+    RIEventRecordDispose(&record->record);
+    RIEventArenaFree(record);
+}
@@ -0,0 +1,68 @@
+//
+//  RIEventBudget.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Global budget of bytes held by the tracking calls queued for all trackers. Every tracker's inbox
+ *  acquires bytes for the entries added and releases them once the entries are processed or shed.
+ */
+
+/**
+ *  Set the number of bytes all queued tracking calls may hold
+ *
+ *  @param limit The limit in bytes, 0 for no limit.
+ */
+void RIEventBudgetSetLimit(size_t limit);
+
+/**
+ *  The number of bytes all queued tracking calls may hold, 0 for no limit
+ *
+ *  @return The limit
+ */
+size_t RIEventBudgetLimit(void);
+
+/**
+ *  The number of bytes held by queued tracking calls
+ *
+ *  @return The number of bytes
+ */
+size_t RIEventBudgetUsage(void);
+
+/**
+ *  Acquire bytes if the budget has room for them
+ *
+ *  @param size The number of bytes.
+ *
+ *  @return True if the bytes were acquired, false if the budget is full
+ */
+BOOL RIEventBudgetTryAcquire(size_t size);
+
+/**
+ *  Acquire bytes regardless of the limit, for entries that may never be shed
+ *
+ *  @param size The number of bytes.
+ */
+void RIEventBudgetAcquire(size_t size);
+
+/**
+ *  Acquire bytes, waiting for other inboxes to release bytes while the budget is full
+ *
+ *  @param size The number of bytes.
+ *  @param timeout The longest time to wait in seconds.
+ *
+ *  @return True if the bytes were acquired, false if the budget stayed full until the timeout
+ */
+BOOL RIEventBudgetWaitToAcquire(size_t size, NSTimeInterval timeout);
+
+/**
+ *  Release bytes acquired before, waking callers waiting for room
+ *
+ *  @param size The number of bytes.
+ */
+void RIEventBudgetRelease(size_t size);
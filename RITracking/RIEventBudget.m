@@ -0,0 +1,103 @@
+//
+//  RIEventBudget.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIEventBudget.h"
+#import <pthread.h>
+#import <sys/time.h>
+#import <errno.h>
+
+static size_t RIEventBudgetCurrentLimit;
+static size_t RIEventBudgetUsed;
+static int32_t RIEventBudgetWaiters;
+static pthread_mutex_t RIEventBudgetMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t RIEventBudgetRoom = PTHREAD_COND_INITIALIZER;
+
+void RIEventBudgetSetLimit(size_t limit)
+{
+    __atomic_store_n(&RIEventBudgetCurrentLimit, limit, __ATOMIC_RELAXED);
+    
+    // A raised limit may make room for waiting callers
+    pthread_mutex_lock(&RIEventBudgetMutex);
+    pthread_cond_broadcast(&RIEventBudgetRoom);
+    pthread_mutex_unlock(&RIEventBudgetMutex);
+}
+
+size_t RIEventBudgetLimit(void)
+{
+    return __atomic_load_n(&RIEventBudgetCurrentLimit, __ATOMIC_RELAXED);
+}
+
+size_t RIEventBudgetUsage(void)
+{
+    return __atomic_load_n(&RIEventBudgetUsed, __ATOMIC_RELAXED);
+}
+
+/**
+ *  Acquire bytes if the budget has room, backing out without waking waiters otherwise
+ */
+static BOOL RIEventBudgetTryAdd(size_t size)
+{
+    size_t limit = __atomic_load_n(&RIEventBudgetCurrentLimit, __ATOMIC_RELAXED);
+    size_t used = __atomic_add_fetch(&RIEventBudgetUsed, size, __ATOMIC_SEQ_CST);
+    
+    if (0 == limit || used <= limit) return YES;
+    
+    __atomic_sub_fetch(&RIEventBudgetUsed, size, __ATOMIC_SEQ_CST);
+    return NO;
+}
+
+BOOL RIEventBudgetTryAcquire(size_t size)
+{
+    return RIEventBudgetTryAdd(size);
+}
+
+void RIEventBudgetAcquire(size_t size)
+{
+    __atomic_add_fetch(&RIEventBudgetUsed, size, __ATOMIC_RELAXED);
+}
+
+BOOL RIEventBudgetWaitToAcquire(size_t size, NSTimeInterval timeout)
+{
+    if (RIEventBudgetTryAcquire(size)) return YES;
+    
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    double deadline = now.tv_sec + now.tv_usec / 1e6 + timeout;
+    struct timespec until = {
+        .tv_sec = (time_t)deadline,
+        .tv_nsec = (long)((deadline - (time_t)deadline) * 1e9)
+    };
+    
+    BOOL acquired = NO;
+    pthread_mutex_lock(&RIEventBudgetMutex);
+    __atomic_add_fetch(&RIEventBudgetWaiters, 1, __ATOMIC_SEQ_CST);
+    
+    // Called with the mutex held, backing out must not wake waiters
+    while (!(acquired = RIEventBudgetTryAdd(size))) {
+        if (ETIMEDOUT == pthread_cond_timedwait(&RIEventBudgetRoom, &RIEventBudgetMutex, &until)) {
+            acquired = RIEventBudgetTryAdd(size);
+            break;
+        }
+    }
+    
+    __atomic_sub_fetch(&RIEventBudgetWaiters, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&RIEventBudgetMutex);
+    return acquired;
+}
+
+void RIEventBudgetRelease(size_t size)
+{
+    __atomic_sub_fetch(&RIEventBudgetUsed, size, __ATOMIC_SEQ_CST);
+    
+    // Only pay for the mutex if someone is waiting for room
+    if (__atomic_load_n(&RIEventBudgetWaiters, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&RIEventBudgetMutex);
+        pthread_cond_broadcast(&RIEventBudgetRoom);
+        pthread_mutex_unlock(&RIEventBudgetMutex);
+    }
+}
@@ -0,0 +1,50 @@
+//
+//  RIEventBuffer.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "RIEventRecord.h"
+
+/**
+ *  Bounded buffer to hold event records until they can be replayed in order. On overflow the
+ *  oldest record is dropped and counted.
+ */
+@interface RIEventBuffer : NSObject
+
+/**
+ *  The number of records dropped on overflow
+ */
+@property (readonly) NSUInteger droppedCount;
+
+/**
+ *  Create and initialize a `RIEventBuffer` object
+ *
+ *  @param capacity The maximum number of records held.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+/**
+ *  Add a record to the buffer, unless the buffer was closed. The buffer takes ownership of the
+ *  record if added.
+ *
+ *  @param record The record to add.
+ *
+ *  @return True if the record was added, false if the buffer is closed or replaying
+ */
+- (BOOL)addRecord:(RIEventRecord *)record;
+
+/**
+ *  Replay all records in order and close the buffer. Records added concurrently wait for the
+ *  replay to finish and are then refused, so they cannot overtake replayed records.
+ *
+ *  @param handler A handler called with each record, taking ownership of the record.
+ */
+- (void)closeWithReplayHandler:(void (^)(RIEventRecord *))handler;
+
+@end
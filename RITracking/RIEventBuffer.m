@@ -0,0 +1,102 @@
+//
+//  RIEventBuffer.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIEventBuffer.h"
+#import <pthread.h>
+
+@interface RIEventBuffer ()
+{
+    RIEventRecord *_records;
+    NSUInteger _capacity;
+    NSUInteger _head;
+    NSUInteger _count;
+    NSUInteger _droppedCount;
+    BOOL _closed;
+    pthread_mutex_t _mutex;
+}
+
+@end
+
+@implementation RIEventBuffer
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    if ((self = [super init])) {
+        _capacity = MAX(capacity, 1);
+        _records = calloc(_capacity, sizeof(RIEventRecord));
+        
+        // Recursive to let the replay handler pass through addRecord: on the replaying thread
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+        pthread_mutex_init(&_mutex, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    for (NSUInteger idx = 0; idx < _count; idx++) {
+        RIEventRecordDispose(&_records[(_head + idx) % _capacity]);
+    }
+    free(_records);
+    pthread_mutex_destroy(&_mutex);
+}
+
+- (NSUInteger)droppedCount
+{
+    pthread_mutex_lock(&_mutex);
+    NSUInteger droppedCount = _droppedCount;
+    pthread_mutex_unlock(&_mutex);
+    return droppedCount;
+}
+
+- (BOOL)addRecord:(RIEventRecord *)record
+{
+    pthread_mutex_lock(&_mutex);
+    
+    if (_closed) {
+        pthread_mutex_unlock(&_mutex);
+        return NO;
+    }
+    
+    if (_count == _capacity) {
+        RIEventRecordDispose(&_records[_head]);
+        _head = (_head + 1) % _capacity;
+        _count--;
+        _droppedCount++;
+    }
+    
+    _records[(_head + _count) % _capacity] = *record;
+    _count++;
+    
+    pthread_mutex_unlock(&_mutex);
+    return YES;
+}
+
+- (void)closeWithReplayHandler:(void (^)(RIEventRecord *))handler
+{
+    pthread_mutex_lock(&_mutex);
+    
+    // Close first, so records tracked by the handler on this thread pass through
+    _closed = YES;
+    
+    while (0 < _count) {
+        RIEventRecord record = _records[_head];
+        _head = (_head + 1) % _capacity;
+        _count--;
+        @autoreleasepool {
+            handler(&record);
+        }
+    }
+    
+    pthread_mutex_unlock(&_mutex);
+}
+
+@end
@@ -0,0 +1,79 @@
+//
+//  RIEventExecutor.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class RIEventExecutor;
+
+/**
+ *  Serial unit of work run by an executor. A lane is submitted whenever it has work and must not be
+ *  submitted again before it ran, so its work never runs concurrently.
+ */
+@protocol RIEventExecutorLane <NSObject>
+
+/**
+ *  Run a slice of the lane's work on a worker thread. A lane with more work left submits itself
+ *  again to let other lanes run in between.
+ *
+ *  @param executor The executor running the lane.
+ */
+- (void)runOnExecutor:(RIEventExecutor *)executor;
+
+@end
+
+/**
+ *  Fixed-size pool of worker threads shared by the trackers, as an alternative to an operation
+ *  queue and its threads per tracker.
+ *
+ *  Each worker runs the lanes of its own deque in turn and steals lanes from other workers once its
+ *  deque is empty, balancing busy trackers across the workers. Lanes submitted by a worker go to its
+ *  own deque, lanes submitted by other threads are spread round robin.
+ *
+ *  Executors and their workers live as long as the process.
+ */
+@interface RIEventExecutor : NSObject
+
+/**
+ *  The number of worker threads
+ */
+@property (readonly) NSUInteger workerCount;
+
+/**
+ *  The number of lanes a worker took from another worker's deque
+ */
+@property (readonly) uint64_t stealCount;
+
+/**
+ *  The executor shared by the trackers, with a worker per active processor core
+ *
+ *  @return The shared executor
+ */
++ (instancetype)sharedExecutor;
+
+/**
+ *  Create and initialize a `RIEventExecutor` object and start its workers
+ *
+ *  @param workerCount The number of worker threads.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithWorkerCount:(NSUInteger)workerCount;
+
+/**
+ *  Submit a lane to be run by a worker. May be called from any thread.
+ *
+ *  @param lane The lane, retained until it ran.
+ */
+- (void)submitLane:(id<RIEventExecutorLane>)lane;
+
+/**
+ *  Wait for all lanes submitted, including those submitted meanwhile, to have run
+ */
+- (void)waitUntilIdle;
+
+@end
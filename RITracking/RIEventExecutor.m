@@ -0,0 +1,234 @@
+//
+//  RIEventExecutor.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIEventExecutor.h"
+#import <pthread.h>
+
+/**
+ *  Initial number of lanes a worker's deque holds, doubled whenever full
+ */
+#define RI_EVENT_EXECUTOR_DEQUE_CAPACITY 64
+
+/**
+ *  Deque of the lanes submitted to a worker. Lanes are pushed at the bottom, the worker takes them
+ *  from the top in turn, other workers steal from the bottom.
+ */
+typedef struct RIEventExecutorWorker {
+    pthread_mutex_t mutex;
+    const void **lanes;
+    NSUInteger capacity;
+    NSUInteger top;
+    NSUInteger count;
+    __unsafe_unretained RIEventExecutor *executor;
+} RIEventExecutorWorker;
+
+/**
+ *  The worker running on the calling thread, NULL on other threads
+ */
+static __thread RIEventExecutorWorker *RIEventExecutorCurrentWorker;
+
+static void RIEventExecutorWorkerPush(RIEventExecutorWorker *worker, const void *lane)
+{
+    pthread_mutex_lock(&worker->mutex);
+    
+    if (worker->count == worker->capacity) {
+        // Unroll the ring into a buffer twice the size
+        const void **lanes = malloc(2 * worker->capacity * sizeof(void *));
+        for (NSUInteger idx = 0; idx < worker->count; idx++) {
+            lanes[idx] = worker->lanes[(worker->top + idx) % worker->capacity];
+        }
+        free(worker->lanes);
+        worker->lanes = lanes;
+        worker->capacity *= 2;
+        worker->top = 0;
+    }
+    
+    worker->lanes[(worker->top + worker->count) % worker->capacity] = lane;
+    worker->count++;
+    
+    pthread_mutex_unlock(&worker->mutex);
+}
+
+static const void *RIEventExecutorWorkerPop(RIEventExecutorWorker *worker, BOOL steal)
+{
+    const void *lane = NULL;
+    
+    pthread_mutex_lock(&worker->mutex);
+    
+    if (worker->count) {
+        worker->count--;
+        if (steal) {
+            lane = worker->lanes[(worker->top + worker->count) % worker->capacity];
+        } else {
+            lane = worker->lanes[worker->top];
+            worker->top = (worker->top + 1) % worker->capacity;
+        }
+    }
+    
+    pthread_mutex_unlock(&worker->mutex);
+    return lane;
+}
+
+@interface RIEventExecutor ()
+{
+    RIEventExecutorWorker *_workers;
+    uint32_t _nextWorker;
+    uint64_t _queuedCount;
+    uint64_t _pendingCount;
+    int32_t _idleCount;
+    uint64_t _stealCount;
+    pthread_mutex_t _mutex;
+    pthread_cond_t _work;
+    pthread_cond_t _idle;
+}
+
+@property (readwrite) NSUInteger workerCount;
+
+@end
+
+@implementation RIEventExecutor
+
++ (instancetype)sharedExecutor
+{
+    static RIEventExecutor *sharedExecutor;
+    static dispatch_once_t sharedExecutorToken;
+    dispatch_once(&sharedExecutorToken, ^{
+        sharedExecutor = [[RIEventExecutor alloc] initWithWorkerCount:
+                          [NSProcessInfo processInfo].activeProcessorCount];
+    });
+    return sharedExecutor;
+}
+
+- (instancetype)initWithWorkerCount:(NSUInteger)workerCount
+{
+    if ((self = [super init])) {
+        self.workerCount = MAX(1, workerCount);
+        _workers = calloc(self.workerCount, sizeof(RIEventExecutorWorker));
+        pthread_mutex_init(&_mutex, NULL);
+        pthread_cond_init(&_work, NULL);
+        pthread_cond_init(&_idle, NULL);
+        
+        for (NSUInteger idx = 0; idx < self.workerCount; idx++) {
+            RIEventExecutorWorker *worker = &_workers[idx];
+            pthread_mutex_init(&worker->mutex, NULL);
+            worker->capacity = RI_EVENT_EXECUTOR_DEQUE_CAPACITY;
+            worker->lanes = malloc(worker->capacity * sizeof(void *));
+            worker->executor = self;
+        }
+        
+        // Workers retain the executor through their threads, so it is never deallocated
+        for (NSUInteger idx = 0; idx < self.workerCount; idx++) {
+            NSThread *thread = [[NSThread alloc] initWithTarget:self
+                                                       selector:@selector(runWorker:)
+                                                         object:@(idx)];
+            thread.name = [NSString stringWithFormat:@"de.rocket-internet.RITracking.executor.%lu",
+                           (unsigned long)idx];
+            [thread start];
+        }
+    }
+    return self;
+}
+
+- (uint64_t)stealCount
+{
+    return __atomic_load_n(&_stealCount, __ATOMIC_RELAXED);
+}
+
+- (void)submitLane:(id<RIEventExecutorLane>)lane
+{
+    RIEventExecutorWorker *worker = RIEventExecutorCurrentWorker;
+    
+    if (!worker || worker->executor != self) {
+        uint32_t next = __atomic_fetch_add(&_nextWorker, 1, __ATOMIC_RELAXED);
+        worker = &_workers[next % self.workerCount];
+    }
+    
+    // Counted before the push, so a worker about to sleep never misses the lane
+    __atomic_add_fetch(&_pendingCount, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&_queuedCount, 1, __ATOMIC_SEQ_CST);
+    RIEventExecutorWorkerPush(worker, CFBridgingRetain(lane));
+    
+    // Only pay for a wakeup if a worker went to sleep
+    if (__atomic_load_n(&_idleCount, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&_mutex);
+        pthread_cond_signal(&_work);
+        pthread_mutex_unlock(&_mutex);
+    }
+}
+
+- (void)waitUntilIdle
+{
+    pthread_mutex_lock(&_mutex);
+    while (__atomic_load_n(&_pendingCount, __ATOMIC_SEQ_CST)) {
+        pthread_cond_wait(&_idle, &_mutex);
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+#pragma mark - Workers
+
+- (void)runWorker:(NSNumber *)index
+{
+    NSUInteger workerIndex = index.unsignedIntegerValue;
+    RIEventExecutorWorker *worker = &_workers[workerIndex];
+    RIEventExecutorCurrentWorker = worker;
+    
+    while (YES) {
+        const void *lane = [self takeLaneForWorkerAtIndex:workerIndex];
+        
+        if (!lane) {
+            [self waitForWork];
+            continue;
+        }
+        
+        @autoreleasepool {
+            id<RIEventExecutorLane> runnable = CFBridgingRelease(lane);
+            [runnable runOnExecutor:self];
+        }
+        
+        if (0 == __atomic_sub_fetch(&_pendingCount, 1, __ATOMIC_SEQ_CST)) {
+            pthread_mutex_lock(&_mutex);
+            pthread_cond_broadcast(&_idle);
+            pthread_mutex_unlock(&_mutex);
+        }
+    }
+}
+
+/**
+ *  Take the oldest lane of the worker's own deque, so its lanes run in turn, or steal the newest lane
+ *  of another worker
+ */
+- (const void *)takeLaneForWorkerAtIndex:(NSUInteger)workerIndex
+{
+    NSUInteger workerCount = self.workerCount;
+    const void *lane = RIEventExecutorWorkerPop(&_workers[workerIndex], NO);
+    
+    for (NSUInteger idx = 1; !lane && idx < workerCount; idx++) {
+        lane = RIEventExecutorWorkerPop(&_workers[(workerIndex + idx) % workerCount], YES);
+        if (lane) __atomic_add_fetch(&_stealCount, 1, __ATOMIC_RELAXED);
+    }
+    
+    if (lane) __atomic_sub_fetch(&_queuedCount, 1, __ATOMIC_SEQ_CST);
+    return lane;
+}
+
+- (void)waitForWork
+{
+    pthread_mutex_lock(&_mutex);
+    __atomic_add_fetch(&_idleCount, 1, __ATOMIC_SEQ_CST);
+    
+    // Check again after announcing the sleep, a lane submitted meanwhile signals or is seen here
+    if (!__atomic_load_n(&_queuedCount, __ATOMIC_SEQ_CST)) {
+        pthread_cond_wait(&_work, &_mutex);
+    }
+    
+    __atomic_sub_fetch(&_idleCount, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&_mutex);
+}
+
+@end
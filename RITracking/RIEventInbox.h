@@ -0,0 +1,212 @@
+//
+//  RIEventInbox.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "RITracking.h"
+#import "RIEventArena.h"
+#import "RITrackerMetrics.h"
+#import "RITrackerHealth.h"
+#import "RIEventExecutor.h"
+
+/**
+ *  What an inbox does with a tracking call the global memory budget has no room for
+ */
+typedef NS_ENUM(NSUInteger, RIEventInboxOverflowPolicy) {
+    /**
+     *  Shed the call
+     */
+    RIEventInboxOverflowPolicyDropNewest,
+    /**
+     *  Shed the oldest calls queued in the inbox to make room, the call itself if there are none
+     */
+    RIEventInboxOverflowPolicyDropOldest,
+    /**
+     *  Block the caller until there is room, shedding the call if there is none after the timeout
+     */
+    RIEventInboxOverflowPolicyBlock,
+    /**
+     *  Write the call to a spill file, delivered once the tracker processed the calls in memory
+     */
+    RIEventInboxOverflowPolicySpill
+};
+
+/**
+ *  How urgently an inbox delivers an entry, relative to the other entries queued
+ */
+typedef NS_ENUM(NSUInteger, RIEventInboxPriority) {
+    /**
+     *  Delivered ahead of anything else queued, such as exceptions and checkouts
+     */
+    RIEventInboxPriorityCritical,
+    /**
+     *  Delivered ahead of bulk entries
+     */
+    RIEventInboxPriorityNormal,
+    /**
+     *  Delivered once nothing more urgent is queued
+     */
+    RIEventInboxPriorityBulk
+};
+
+/**
+ *  Lock-free inbox of a tracker, handing the arena records and operations added from any thread on
+ *  to the tracker's queue in order.
+ *
+ *  Instead of one operation per tracking call, a single drain operation is put on the tracker's
+ *  queue whenever the inbox turns non-empty, so adding a record does not allocate. With an executor
+ *  the inbox is a serial lane of the executor instead, run by its shared workers.
+ *
+ *  Queued entries hold bytes of the global RIEventBudget. Records and tracking calls made as
+ *  operations the budget has no room for are handled by the inbox's overflow policy, other
+ *  operations are never shed.
+ *
+ *  Every entry processed is reported to the tracker's health monitor. While its circuit is open,
+ *  records and tracking calls made as operations are rejected as they are added, records are spilled
+ *  with RIEventInboxOverflowPolicySpill and probe the tracker once the cooldown of the circuit
+ *  passed, even if no other tracking calls are made.
+ *
+ *  Each priority has a queue of its own and entries keep their order within a priority only. The
+ *  oldest entry of the highest priority is delivered next, but an entry of a lower priority waiting
+ *  for several entries of higher priorities goes first, so no priority starves. Records of the
+ *  lowest priorities are shed first.
+ */
+@interface RIEventInbox : NSObject
+
+/**
+ *  The tracker the inbox delivers to
+ */
+@property (readonly) id<RITracker> tracker;
+
+/**
+ *  The executor the inbox runs on as a lane, nil to run on the tracker's queue. To be set before
+ *  anything is added.
+ */
+@property RIEventExecutor *executor;
+
+/**
+ *  The health monitor and circuit breaker of the tracker
+ */
+@property (readonly) RITrackerHealth *health;
+
+/**
+ *  What to do with records the memory budget has no room for, defaults to dropping the newest
+ */
+@property RIEventInboxOverflowPolicy overflowPolicy;
+
+/**
+ *  The longest time in seconds to block a caller with RIEventInboxOverflowPolicyBlock
+ */
+@property NSTimeInterval blockTimeout;
+
+/**
+ *  The file records are spilled to with RIEventInboxOverflowPolicySpill, nil if spilling failed
+ */
+@property (nonatomic) NSString *spillPath;
+
+/**
+ *  Create and initialize a `RIEventInbox` object
+ *
+ *  @param tracker The tracker to deliver to, on its queue.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithTracker:(id<RITracker>)tracker;
+
+/**
+ *  Add an arena record, to be delivered to the tracker and consumed afterwards
+ *
+ *  @param record The arena record.
+ */
+- (void)addRecord:(RIEventArenaRecord *)record;
+
+/**
+ *  Add an arena record with a priority, to be delivered to the tracker and consumed afterwards
+ *
+ *  @param record   The arena record.
+ *  @param priority The priority of the record.
+ */
+- (void)addRecord:(RIEventArenaRecord *)record priority:(RIEventInboxPriority)priority;
+
+/**
+ *  Add an operation, to be run on the tracker's queue in order with the records added
+ *
+ *  @param block The operation.
+ */
+- (void)addOperationWithBlock:(void (^)(void))block;
+
+/**
+ *  Add an operation with a priority, to be run on the tracker's queue in order with the records of
+ *  the same priority
+ *
+ *  @param block    The operation.
+ *  @param priority The priority of the operation.
+ */
+- (void)addOperationWithBlock:(void (^)(void))block priority:(RIEventInboxPriority)priority;
+
+/**
+ *  Add a tracking call made as an operation, such as a batch of events or an e-commerce call. Unlike
+ *  other operations, calls are rejected while the tracker's circuit is open, charged to the memory
+ *  budget like the records they stand for and shed by the overflow policy. Calls cannot be spilled,
+ *  RIEventInboxOverflowPolicySpill sheds them.
+ *
+ *  @param block    The call, run on the tracker's queue with NO, or with YES from any thread if it
+ *                  was shed instead. Called exactly once.
+ *  @param count    The number of tracking calls the block makes.
+ *  @param priority The priority of the call.
+ */
+- (void)addCallWithBlock:(void (^)(BOOL shed))block
+                   count:(NSUInteger)count
+                priority:(RIEventInboxPriority)priority;
+
+/**
+ *  The number of tracking calls made as operations shed because the memory budget was full
+ *
+ *  @return The count
+ */
+- (uint64_t)shedCallCount;
+
+/**
+ *  The number of records of a kind shed because the memory budget was full
+ *
+ *  @param kind The kind of the records.
+ *
+ *  @return The count
+ */
+- (uint64_t)shedCountForRecordKind:(RIEventRecordKind)kind;
+
+/**
+ *  The number of records spilled to disk because the memory budget was full
+ *
+ *  @return The count
+ */
+- (uint64_t)spilledCount;
+
+/**
+ *  Release memory held by queued records and tracking calls as the overflow policy allows: shed them
+ *  with RIEventInboxOverflowPolicyDropOldest, spill records and shed calls with
+ *  RIEventInboxOverflowPolicySpill. Other policies keep their entries.
+ *
+ *  @param size The number of bytes to release at most.
+ *
+ *  @return The number of bytes released
+ */
+- (size_t)compactReleasingSize:(size_t)size;
+
+#if RI_TRACKER_METRICS
+
+/**
+ *  Snapshot of the inbox's instrumentation: its depth and the latencies of the tracker processing
+ *  the entries added
+ *
+ *  @return The snapshot
+ */
+- (RITrackerMetricsSnapshot *)metricsSnapshot;
+
+#endif
+
+@end
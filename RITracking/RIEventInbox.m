@@ -0,0 +1,731 @@
+//
+//  RIEventInbox.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIEventInbox.h"
+#import "RIEventBudget.h"
+#import "RIEventSpill.h"
+#import <pthread.h>
+
+/**
+ *  Operations are told from records by the lowest bit of the entry, tracking calls made as operations
+ *  from other operations by the second lowest bit
+ */
+#define RI_EVENT_INBOX_OPERATION ((uintptr_t)1)
+#define RI_EVENT_INBOX_CALL ((uintptr_t)2)
+#define RI_EVENT_INBOX_TAGS (RI_EVENT_INBOX_OPERATION | RI_EVENT_INBOX_CALL)
+
+/**
+ *  Number of record kinds shed counts are kept for
+ */
+#define RI_EVENT_INBOX_RECORD_KINDS (RIEventRecordKindOpenURL + 1)
+
+/**
+ *  Bytes charged to the memory budget for a queued record: its node and the arena record, which is
+ *  shared with other inboxes but charged to each of them
+ */
+static size_t const kRIEventInboxRecordSize = 2 * RI_EVENT_ARENA_BLOCK_SIZE;
+
+/**
+ *  Bytes charged to the memory budget for a queued operation: its node and an estimate of the block
+ */
+static size_t const kRIEventInboxOperationSize = RI_EVENT_ARENA_BLOCK_SIZE + 64;
+
+/**
+ *  Number of entries an inbox processes on an executor before letting other lanes run
+ */
+static NSUInteger const kRIEventInboxLaneSliceCount = 64;
+
+/**
+ *  Number of priorities, each with a queue of its own
+ */
+#define RI_EVENT_INBOX_PRIORITIES (RIEventInboxPriorityBulk + 1)
+
+/**
+ *  Number of entries of higher priorities processed while entries of a lower priority wait, before
+ *  an entry of the lower priority is processed
+ */
+static NSUInteger const kRIEventInboxStarvationLimit = 8;
+
+typedef struct RIEventInboxNode {
+    struct RIEventInboxNode *next;
+    uintptr_t entry;
+    size_t size;
+#if RI_TRACKER_METRICS
+    uint64_t enqueueTime;
+#endif
+} RIEventInboxNode;
+
+/**
+ *  Intrusive multi-producer single-consumer queue: producers swap themselves in at the head, the
+ *  inbox's drain takes nodes from the tail. Nodes are arena blocks.
+ */
+typedef struct RIEventInboxQueue {
+    RIEventInboxNode *head;
+    RIEventInboxNode *tail;
+    RIEventInboxNode stub;
+} RIEventInboxQueue;
+
+static void RIEventInboxQueueInit(RIEventInboxQueue *queue)
+{
+    queue->head = &queue->stub;
+    queue->tail = &queue->stub;
+}
+
+static void RIEventInboxQueuePush(RIEventInboxQueue *queue, RIEventInboxNode *node)
+{
+    node->next = NULL;
+    RIEventInboxNode *previous = __atomic_exchange_n(&queue->head, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&previous->next, node, __ATOMIC_RELEASE);
+}
+
+/**
+ *  Take the oldest node, called by the consumer only. Returns NULL if the queue is empty or the
+ *  producer adding the next node did not link it yet.
+ */
+static RIEventInboxNode *RIEventInboxQueuePop(RIEventInboxQueue *queue)
+{
+    RIEventInboxNode *tail = queue->tail;
+    RIEventInboxNode *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    
+    if (&queue->stub == tail) {
+        if (!next) return NULL;
+        queue->tail = next;
+        tail = next;
+        next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    }
+    
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+    
+    if (tail != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE)) return NULL;
+    
+    // Put the stub behind the last node, so the last node can be taken
+    RIEventInboxQueuePush(queue, &queue->stub);
+    next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+    
+    return NULL;
+}
+
+/**
+ *  Whether the entry of a node may be shed: records and tracking calls made as operations
+ */
+static BOOL RIEventInboxNodeIsSheddable(const RIEventInboxNode *node)
+{
+    return !(node->entry & RI_EVENT_INBOX_OPERATION) || (node->entry & RI_EVENT_INBOX_CALL);
+}
+
+/**
+ *  Unlink the oldest node holding a record or tracking call, called by the consumer only. Nodes
+ *  producers may still link to are left in place.
+ */
+static RIEventInboxNode *RIEventInboxQueueTakeOldestSheddable(RIEventInboxQueue *queue)
+{
+    RIEventInboxNode *previous = NULL;
+    RIEventInboxNode *node;
+    RIEventInboxNode *next;
+    
+    for (node = queue->tail; (next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)); node = next) {
+        if (&queue->stub != node && RIEventInboxNodeIsSheddable(node)) {
+            if (previous) {
+                __atomic_store_n(&previous->next, next, __ATOMIC_RELEASE);
+            } else {
+                queue->tail = next;
+            }
+            return node;
+        }
+        previous = node;
+    }
+    
+    return NULL;
+}
+
+static BOOL RIEventInboxQueueIsEmpty(RIEventInboxQueue *queue)
+{
+    return &queue->stub == queue->tail && &queue->stub == __atomic_load_n(&queue->head, __ATOMIC_SEQ_CST);
+}
+
+/**
+ *  A queue per priority. The consumer side is guarded by a mutex, so shedding records can take them
+ *  out of the queues from any thread while the drain is blocked in the tracker.
+ */
+@interface RIEventInbox () <RIEventExecutorLane>
+{
+    RIEventInboxQueue _queues[RI_EVENT_INBOX_PRIORITIES];
+    NSUInteger _waitCounts[RI_EVENT_INBOX_PRIORITIES];
+    int _scheduled;
+    int _cooldownDrainScheduled;
+    pthread_mutex_t _consumerMutex;
+    uint64_t _shedCounts[RI_EVENT_INBOX_RECORD_KINDS];
+    uint64_t _shedCallCount;
+    uint64_t _spilledCount;
+#if RI_TRACKER_METRICS
+    RITrackerMetrics _metrics;
+#endif
+}
+
+@property (readwrite) id<RITracker> tracker;
+@property (readwrite) RITrackerHealth *health;
+@property RIEventSpill *spill;
+
+@end
+
+@implementation RIEventInbox
+
+- (instancetype)initWithTracker:(id<RITracker>)tracker
+{
+    if ((self = [super init])) {
+        self.tracker = tracker;
+        self.health = [[RITrackerHealth alloc] initWithTrackerName:NSStringFromClass([tracker class])];
+        self.blockTimeout = 0.1;
+        for (NSUInteger idx = 0; idx < RI_EVENT_INBOX_PRIORITIES; idx++) {
+            RIEventInboxQueueInit(&_queues[idx]);
+        }
+        pthread_mutex_init(&_consumerMutex, NULL);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    RIEventInboxNode *node;
+    while ((node = [self takeNode])) {
+        RIEventBudgetRelease(node->size);
+        [self disposeEntry:node->entry];
+        RIEventArenaFree(node);
+#if RI_TRACKER_METRICS
+        RITrackerMetricsRecordDropped(&_metrics);
+#endif
+    }
+    pthread_mutex_destroy(&_consumerMutex);
+}
+
+- (void)setSpillPath:(NSString *)spillPath
+{
+    _spillPath = spillPath;
+    self.spill = spillPath ? [[RIEventSpill alloc] initWithPath:spillPath] : nil;
+    
+    if (spillPath && !self.spill) _spillPath = nil;
+}
+
+- (void)addRecord:(RIEventArenaRecord *)record
+{
+    [self addRecord:record priority:RIEventInboxPriorityNormal];
+}
+
+- (void)addRecord:(RIEventArenaRecord *)record priority:(RIEventInboxPriority)priority
+{
+    if (![self.health admitCall]) {
+        [self rejectRecord:record];
+        return;
+    }
+    if (!RIEventBudgetTryAcquire(kRIEventInboxRecordSize) && ![self makeRoomForRecord:record]) {
+        // A record shed or spilled does not probe the tracker
+        [self.health cancelCall];
+        return;
+    }
+    
+    [self pushEntry:(uintptr_t)record size:kRIEventInboxRecordSize priority:priority];
+}
+
+- (void)addOperationWithBlock:(void (^)(void))block
+{
+    [self addOperationWithBlock:block priority:RIEventInboxPriorityNormal];
+}
+
+- (void)addOperationWithBlock:(void (^)(void))block priority:(RIEventInboxPriority)priority
+{
+    RIEventBudgetAcquire(kRIEventInboxOperationSize);
+    [self pushEntry:(uintptr_t)CFBridgingRetain([block copy]) | RI_EVENT_INBOX_OPERATION
+               size:kRIEventInboxOperationSize
+           priority:priority];
+}
+
+- (void)addCallWithBlock:(void (^)(BOOL shed))block
+                   count:(NSUInteger)count
+                priority:(RIEventInboxPriority)priority
+{
+    // Calls cannot be spilled to wait for the circuit to close
+    if (![self.health admitCall]) {
+#if RI_TRACKER_METRICS
+        RITrackerMetricsRecordRejected(&_metrics);
+#endif
+        block(YES);
+        return;
+    }
+    
+    // Charged like the records of the calls, the data captured by the block is not accounted for
+    size_t size = kRIEventInboxOperationSize + count * kRIEventInboxRecordSize;
+    
+    if (!RIEventBudgetTryAcquire(size) && ![self makeRoomForSize:size]) {
+#if RI_TRACKER_METRICS
+        RITrackerMetricsRecordRejected(&_metrics);
+#endif
+        [self.health cancelCall];
+        [self shedCallWithBlock:block count:count];
+        return;
+    }
+    
+    [self pushEntry:(uintptr_t)CFBridgingRetain([block copy]) | RI_EVENT_INBOX_TAGS
+               size:size
+           priority:priority];
+}
+
+#if RI_TRACKER_METRICS
+
+- (RITrackerMetricsSnapshot *)metricsSnapshot
+{
+    return [[RITrackerMetricsSnapshot alloc] initWithMetrics:&_metrics
+                                                 trackerName:NSStringFromClass([self.tracker class])];
+}
+
+#endif
+
+#pragma mark - Overflow
+
+- (uint64_t)shedCountForRecordKind:(RIEventRecordKind)kind
+{
+    if (RI_EVENT_INBOX_RECORD_KINDS <= kind) return 0;
+    return __atomic_load_n(&_shedCounts[kind], __ATOMIC_RELAXED);
+}
+
+- (uint64_t)shedCallCount
+{
+    return __atomic_load_n(&_shedCallCount, __ATOMIC_RELAXED);
+}
+
+- (uint64_t)spilledCount
+{
+    return __atomic_load_n(&_spilledCount, __ATOMIC_RELAXED);
+}
+
+/**
+ *  Apply the overflow policy to a record the memory budget has no room for
+ *
+ *  @return True if room was made for the record, false if the record was shed or spilled
+ */
+- (BOOL)makeRoomForRecord:(RIEventArenaRecord *)record
+{
+    if (RIEventInboxOverflowPolicySpill == self.overflowPolicy && [self spillRecord:record]) {
+        [self scheduleDrain];
+        return NO;
+    }
+    
+    if ([self makeRoomForSize:kRIEventInboxRecordSize]) return YES;
+    
+#if RI_TRACKER_METRICS
+    RITrackerMetricsRecordRejected(&_metrics);
+#endif
+    [self shedRecord:record];
+    return NO;
+}
+
+/**
+ *  Acquire bytes of the memory budget by shedding queued entries or blocking, as the overflow policy
+ *  allows
+ *
+ *  @return True if the bytes were acquired
+ */
+- (BOOL)makeRoomForSize:(size_t)size
+{
+    switch (self.overflowPolicy) {
+        case RIEventInboxOverflowPolicyDropOldest:
+            while ([self shedOldestEntry]) {
+                if (RIEventBudgetTryAcquire(size)) return YES;
+            }
+            break;
+        case RIEventInboxOverflowPolicyBlock:
+            if (RIEventBudgetWaitToAcquire(size, self.blockTimeout)) return YES;
+            break;
+        case RIEventInboxOverflowPolicySpill:
+        case RIEventInboxOverflowPolicyDropNewest:
+            break;
+    }
+    return NO;
+}
+
+/**
+ *  Spill or drop a record the tracker's open circuit rejected. Spilled records wait for the cooldown
+ *  of the circuit, then probe the tracker.
+ */
+- (void)rejectRecord:(RIEventArenaRecord *)record
+{
+    if (RIEventInboxOverflowPolicySpill == self.overflowPolicy && [self spillRecord:record]) {
+        [self scheduleDrainAfterCooldown];
+        return;
+    }
+    
+#if RI_TRACKER_METRICS
+    RITrackerMetricsRecordRejected(&_metrics);
+#endif
+    RIEventArenaRecordConsume(record);
+}
+
+- (void)shedRecord:(RIEventArenaRecord *)record
+{
+    RIEventRecordKind kind = record->record.kind;
+    
+    if (kind < RI_EVENT_INBOX_RECORD_KINDS) {
+        __atomic_add_fetch(&_shedCounts[kind], 1, __ATOMIC_RELAXED);
+    }
+    
+    RIDebugLog(@"Shedding tracking call of kind %u for tracker %@", (unsigned)kind, self.tracker);
+    RIEventArenaRecordConsume(record);
+}
+
+/**
+ *  Tell a tracking call made as an operation it was shed, calls cannot be spilled
+ */
+- (void)shedCallWithBlock:(void (^)(BOOL shed))block count:(NSUInteger)count
+{
+    __atomic_add_fetch(&_shedCallCount, count, __ATOMIC_RELAXED);
+    
+    RIDebugLog(@"Shedding %lu tracking calls for tracker %@", (unsigned long)count, self.tracker);
+    block(YES);
+}
+
+/**
+ *  Write a record to the spill file and consume it, spilled records are not journaled any more
+ */
+- (BOOL)spillRecord:(RIEventArenaRecord *)record
+{
+    if (![self.spill appendRecord:&record->record]) return NO;
+    
+    __atomic_add_fetch(&_spilledCount, 1, __ATOMIC_RELAXED);
+    RIEventArenaRecordConsume(record);
+    return YES;
+}
+
+/**
+ *  Shed the oldest record or tracking call queued, releasing its bytes
+ *
+ *  @return The number of bytes released, zero if nothing sheddable is queued
+ */
+- (size_t)shedOldestEntry
+{
+    RIEventInboxNode *node = [self takeOldestSheddableNode];
+    
+    if (!node) return 0;
+    
+    uintptr_t entry = node->entry;
+    size_t size = node->size;
+    RIEventArenaFree(node);
+    RIEventBudgetRelease(size);
+#if RI_TRACKER_METRICS
+    RITrackerMetricsRecordDropped(&_metrics);
+#endif
+    [self shedEntry:entry size:size];
+    return size;
+}
+
+/**
+ *  Shed an entry no node could be allocated for. Other operations than tracking calls are not meant
+ *  to be shed, but cannot be queued either.
+ */
+- (void)shedEntryForLackOfMemory:(uintptr_t)entry size:(size_t)size
+{
+#if RI_TRACKER_METRICS
+    RITrackerMetricsRecordRejected(&_metrics);
+#endif
+    if (RI_EVENT_INBOX_OPERATION == (entry & RI_EVENT_INBOX_TAGS)) {
+        RILog(RILogLevelError, @"Dropping operation for tracker %@ for lack of memory", self.tracker);
+        CFRelease((const void *)(entry & ~RI_EVENT_INBOX_TAGS));
+    } else {
+        // Records and tracking calls were admitted by the circuit
+        [self.health cancelCall];
+        [self shedEntry:entry size:size];
+    }
+}
+
+- (void)shedEntry:(uintptr_t)entry size:(size_t)size
+{
+    if (entry & RI_EVENT_INBOX_OPERATION) {
+        void (^block)(BOOL) = CFBridgingRelease((const void *)(entry & ~RI_EVENT_INBOX_TAGS));
+        [self shedCallWithBlock:block count:(size - kRIEventInboxOperationSize) / kRIEventInboxRecordSize];
+    } else {
+        [self shedRecord:(RIEventArenaRecord *)entry];
+    }
+}
+
+- (size_t)compactReleasingSize:(size_t)size
+{
+    size_t released = 0;
+    
+    switch (self.overflowPolicy) {
+        case RIEventInboxOverflowPolicyDropOldest:
+            while (released < size) {
+                size_t shed = [self shedOldestEntry];
+                if (!shed) break;
+                released += shed;
+            }
+            break;
+        case RIEventInboxOverflowPolicySpill:
+            while (released < size) {
+                RIEventInboxNode *node = [self takeOldestSheddableNode];
+                if (!node) break;
+            
+                uintptr_t entry = node->entry;
+                size_t entrySize = node->size;
+                RIEventArenaFree(node);
+                RIEventBudgetRelease(entrySize);
+                released += entrySize;
+            
+#if RI_TRACKER_METRICS
+                __atomic_sub_fetch(&_metrics.depth, 1, __ATOMIC_RELAXED);
+#endif
+                if ((entry & RI_EVENT_INBOX_OPERATION) || ![self spillRecord:(RIEventArenaRecord *)entry]) {
+#if RI_TRACKER_METRICS
+                    RITrackerMetricsRecordRejected(&_metrics);
+#endif
+                    [self shedEntry:entry size:entrySize];
+                }
+            }
+            break;
+        case RIEventInboxOverflowPolicyDropNewest:
+        case RIEventInboxOverflowPolicyBlock:
+            break;
+    }
+    
+    return released;
+}
+
+#pragma mark - Queue
+
+- (void)pushEntry:(uintptr_t)entry size:(size_t)size priority:(RIEventInboxPriority)priority
+{
+    RIEventInboxNode *node = RIEventArenaAllocate();
+    
+    if (!node) {
+        RIEventBudgetRelease(size);
+        [self shedEntryForLackOfMemory:entry size:size];
+        return;
+    }
+    
+    node->entry = entry;
+    node->size = size;
+#if RI_TRACKER_METRICS
+    node->enqueueTime = RITrackerMetricsNow();
+    RITrackerMetricsRecordEnqueue(&_metrics);
+#endif
+    RIEventInboxQueuePush(&_queues[MIN(priority, RIEventInboxPriorityBulk)], node);
+    [self scheduleDrain];
+}
+
+- (void)scheduleDrain
+{
+    // Only the add turning the inbox non-empty puts a drain operation on the tracker's queue
+    if (!__atomic_exchange_n(&_scheduled, 1, __ATOMIC_SEQ_CST)) {
+        RIEventExecutor *executor = self.executor;
+        
+        if (executor) {
+            [executor submitLane:self];
+        } else {
+            [self.tracker.queue addOperationWithBlock:^{
+                [self drainWithExecutor:nil];
+            }];
+        }
+    }
+}
+
+/**
+ *  Take the next node to process: the oldest of the highest priority, unless a lower priority waited
+ *  for too many entries of higher priorities
+ */
+- (RIEventInboxNode *)takeNode
+{
+    RIEventInboxNode *node = NULL;
+    NSUInteger priority;
+    
+    pthread_mutex_lock(&_consumerMutex);
+    
+    for (priority = RI_EVENT_INBOX_PRIORITIES - 1; 0 < priority; priority--) {
+        if (kRIEventInboxStarvationLimit <= _waitCounts[priority]) {
+            _waitCounts[priority] = 0;
+            if ((node = RIEventInboxQueuePop(&_queues[priority]))) break;
+        }
+    }
+    
+    if (!node) {
+        for (priority = 0; priority < RI_EVENT_INBOX_PRIORITIES; priority++) {
+            if ((node = RIEventInboxQueuePop(&_queues[priority]))) break;
+        }
+    }
+    
+    // Lower priorities with entries waiting age, those without start over
+    for (NSUInteger lower = priority + 1; node && lower < RI_EVENT_INBOX_PRIORITIES; lower++) {
+        _waitCounts[lower] = RIEventInboxQueueIsEmpty(&_queues[lower]) ? 0 : _waitCounts[lower] + 1;
+    }
+    
+    pthread_mutex_unlock(&_consumerMutex);
+    return node;
+}
+
+/**
+ *  Unlink the oldest node holding a record or tracking call of the lowest priority, from any thread
+ */
+- (RIEventInboxNode *)takeOldestSheddableNode
+{
+    RIEventInboxNode *node = NULL;
+    
+    pthread_mutex_lock(&_consumerMutex);
+    
+    for (NSUInteger priority = RI_EVENT_INBOX_PRIORITIES; !node && 0 < priority; priority--) {
+        node = RIEventInboxQueueTakeOldestSheddable(&_queues[priority - 1]);
+    }
+    
+    pthread_mutex_unlock(&_consumerMutex);
+    return node;
+}
+
+- (BOOL)isEmpty
+{
+    for (NSUInteger priority = 0; priority < RI_EVENT_INBOX_PRIORITIES; priority++) {
+        if (!RIEventInboxQueueIsEmpty(&_queues[priority])) return NO;
+    }
+    return YES;
+}
+
+#pragma mark - Drain
+
+- (void)runOnExecutor:(RIEventExecutor *)executor
+{
+    [self drainWithExecutor:executor];
+}
+
+/**
+ *  Process the entries and spilled records of the inbox. On an executor, the inbox submits itself
+ *  again after a slice of entries, so lanes of other trackers run in between.
+ */
+- (void)drainWithExecutor:(RIEventExecutor *)executor
+{
+    NSUInteger remaining = executor ? kRIEventInboxLaneSliceCount : NSUIntegerMax;
+    id<RITracker> tracker = self.tracker;
+    RITrackerHealth *health = self.health;
+    RIEventSpill *spill = self.spill;
+    
+    while (YES) {
+#if RI_TRACKER_METRICS
+        // The time an entry finished is the time the next one started, sparing a clock read per entry
+        uint64_t startTime = RITrackerMetricsNow();
+#endif
+        RIEventInboxNode *node;
+        while ((node = [self takeNode])) {
+            uintptr_t entry = node->entry;
+#if RI_TRACKER_METRICS
+            uint64_t enqueueTime = node->enqueueTime;
+#endif
+            RIEventBudgetRelease(node->size);
+            RIEventArenaFree(node);
+            
+            [health beginCall];
+            @autoreleasepool {
+                if (entry & RI_EVENT_INBOX_CALL) {
+                    void (^block)(BOOL) = CFBridgingRelease((const void *)(entry & ~RI_EVENT_INBOX_TAGS));
+                    block(NO);
+                } else if (entry & RI_EVENT_INBOX_OPERATION) {
+                    void (^block)(void) = CFBridgingRelease((const void *)(entry & ~RI_EVENT_INBOX_TAGS));
+                    block();
+                } else {
+                    RIEventArenaRecord *record = (RIEventArenaRecord *)entry;
+                    RIEventRecordDeliver(&record->record, tracker);
+                    RIEventArenaRecordConsume(record);
+                }
+            }
+            [health endCall];
+#if RI_TRACKER_METRICS
+            uint64_t finishTime = RITrackerMetricsNow();
+            RITrackerMetricsRecordProcessed(&_metrics, enqueueTime, startTime, finishTime);
+            startTime = finishTime;
+#endif
+            if (0 == --remaining) {
+                [executor submitLane:self];
+                return;
+            }
+        }
+        
+        // Spilled records are delivered one at a time once the records in memory are processed
+        RIEventRecord record;
+        if ([self admitSpilledRecord]) {
+            if ([spill popRecord:&record]) {
+                [health beginCall];
+                @autoreleasepool {
+                    RIEventRecordDeliver(&record, tracker);
+                    RIEventRecordDispose(&record);
+                }
+                [health endCall];
+                if (0 == --remaining) {
+                    [executor submitLane:self];
+                    return;
+                }
+                continue;
+            }
+            // No record could be read, so none probes the tracker
+            [health cancelCall];
+        }
+        
+        // Check again after unscheduling to not miss an entry added meanwhile
+        __atomic_store_n(&_scheduled, 0, __ATOMIC_SEQ_CST);
+        if (([self isEmpty] && ![self hasDeliverableSpill]) ||
+            __atomic_exchange_n(&_scheduled, 1, __ATOMIC_SEQ_CST)) {
+            return;
+        }
+    }
+}
+
+/**
+ *  Whether a spilled record may be delivered: while the circuit is closed, or as a probe once the
+ *  cooldown of the open circuit passed. Otherwise a drain is scheduled after the cooldown, so spilled
+ *  records do not wait for other tracking calls to probe the tracker.
+ */
+- (BOOL)admitSpilledRecord
+{
+    if (0 == self.spill.count) return NO;
+    if (RITrackerHealthStateClosed == self.health.state || [self.health admitCall]) return YES;
+    
+    [self scheduleDrainAfterCooldown];
+    return NO;
+}
+
+- (void)scheduleDrainAfterCooldown
+{
+    if (__atomic_exchange_n(&_cooldownDrainScheduled, 1, __ATOMIC_SEQ_CST)) return;
+    
+    __weak RIEventInbox *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.health.cooldown * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                       RIEventInbox *inbox = weakSelf;
+                       if (!inbox) return;
+                       __atomic_store_n(&inbox->_cooldownDrainScheduled, 0, __ATOMIC_SEQ_CST);
+                       [inbox scheduleDrain];
+                   });
+}
+
+- (BOOL)hasDeliverableSpill
+{
+    return 0 < self.spill.count && RITrackerHealthStateClosed == self.health.state;
+}
+
+- (void)disposeEntry:(uintptr_t)entry
+{
+    if (entry & RI_EVENT_INBOX_CALL) {
+        void (^block)(BOOL) = CFBridgingRelease((const void *)(entry & ~RI_EVENT_INBOX_TAGS));
+        block(YES);
+    } else if (entry & RI_EVENT_INBOX_OPERATION) {
+        CFRelease((const void *)(entry & ~RI_EVENT_INBOX_TAGS));
+    } else {
+        RIEventArenaRecordConsume((RIEventArenaRecord *)entry);
+    }
+}
+
+@end
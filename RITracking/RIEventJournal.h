@@ -0,0 +1,99 @@
+//
+//  RIEventJournal.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "RIEventRecord.h"
+
+@class RIEventJournalAcknowledgement;
+
+/**
+ *  Convenience controller to journal event records in a crash-safe memory-mapped log before they
+ *  are handed to the trackers, so records not acknowledged by all trackers are replayed on the next
+ *  start of the app
+ */
+@interface RIEventJournal : NSObject
+
+/**
+ *  Create and initialize a `RIEventJournal` object
+ *
+ *  @param directory Path of the directory to keep the journal's segment files in. It is created if
+ *  missing.
+ *  @param segmentSize Size in bytes of a segment file.
+ *
+ *  @return The object created, or nil in case of error
+ */
+- (instancetype)initWithDirectory:(NSString *)directory segmentSize:(NSUInteger)segmentSize;
+
+/**
+ *  Append a record to the journal and set its journal identifier
+ *
+ *  @param record The record to append.
+ *
+ *  @return True in case of success, false in case of error
+ */
+- (BOOL)appendRecord:(RIEventRecord *)record;
+
+/**
+ *  Acknowledge a record to be processed, so it is not replayed again
+ *
+ *  @param identifier The journal identifier of the record.
+ */
+- (void)acknowledgeIdentifier:(uint64_t)identifier;
+
+/**
+ *  Create an acknowledgement to count down the trackers processing a record, which acknowledges the
+ *  record once all trackers are done
+ *
+ *  @param record A journaled record.
+ *  @param count The number of trackers processing the record.
+ *
+ *  @return The acknowledgement, or nil if the record is not journaled
+ */
+- (RIEventJournalAcknowledgement *)acknowledgementForRecord:(const RIEventRecord *)record
+                                                      count:(NSUInteger)count;
+
+/**
+ *  Replay the records left unacknowledged by a previous process on a background queue
+ *
+ *  @param handler A handler called with each record in order of journaling. It takes ownership of
+ *  the record and has to acknowledge it once processed.
+ */
+- (void)recoverWithHandler:(void (^)(RIEventRecord *))handler;
+
+/**
+ *  Encode a record the way it is journaled
+ *
+ *  @param record The record.
+ *
+ *  @return The encoded record, or nil in case of error
+ */
++ (NSData *)payloadWithRecord:(const RIEventRecord *)record;
+
+/**
+ *  Decode a record encoded by payloadWithRecord:
+ *
+ *  @param record The record decoded, owned by the caller.
+ *  @param payload The encoded record.
+ *
+ *  @return True in case of success, false in case of error
+ */
++ (BOOL)getRecord:(RIEventRecord *)record withPayload:(NSData *)payload;
+
+@end
+
+/**
+ *  Countdown of the trackers processing a journaled record
+ */
+@interface RIEventJournalAcknowledgement : NSObject
+
+/**
+ *  Count down a tracker done processing the record, acknowledging the record if it was the last
+ */
+- (void)trackerDidProcess;
+
+@end
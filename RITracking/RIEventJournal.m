@@ -0,0 +1,209 @@
+//
+//  RIEventJournal.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIEventJournal.h"
+#import "RIJournal.h"
+#import "RITracking.h"
+
+static NSString * const kRIEventJournalKind = @"k";
+
+@interface RIEventJournalAcknowledgement ()
+{
+    int64_t _count;
+}
+
+@property RIEventJournal *journal;
+@property uint64_t identifier;
+
+- (instancetype)initWithJournal:(RIEventJournal *)journal
+                     identifier:(uint64_t)identifier
+                          count:(NSUInteger)count;
+
+@end
+
+@interface RIEventJournal ()
+{
+    RIJournal *_journal;
+}
+
+@end
+
+static void RIEventJournalRecoverEntry(uint64_t identifier,
+                                       const void *payload,
+                                       size_t length,
+                                       void *context)
+{
+    void (^handler)(RIEventRecord *) = (__bridge void (^)(RIEventRecord *))context;
+    
+    @autoreleasepool {
+        RIEventRecord record;
+        NSData *data = [NSData dataWithBytesNoCopy:(void *)payload length:length freeWhenDone:NO];
+        
+        if (![RIEventJournal getRecord:&record withPayload:data]) return;
+        
+        record.journalIdentifier = identifier;
+        handler(&record);
+    }
+}
+
+@implementation RIEventJournal
+
+- (instancetype)initWithDirectory:(NSString *)directory segmentSize:(NSUInteger)segmentSize
+{
+    if ((self = [super init])) {
+        NSError *error;
+        [[NSFileManager defaultManager] createDirectoryAtPath:directory
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:&error];
+        
+        _journal = RIJournalOpen(directory.fileSystemRepresentation, segmentSize);
+        
+        if (!_journal) {
+            RIRaiseError(@"Unexpected error when opening event journal in directory '%@': %@",
+                         directory, error);
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    RIJournalClose(_journal);
+}
+
+- (BOOL)appendRecord:(RIEventRecord *)record
+{
+    NSData *payload = [RIEventJournal payloadWithRecord:record];
+    
+    if (!payload) return NO;
+    
+    record->journalIdentifier = RIJournalAppend(_journal, payload.bytes, payload.length);
+    return 0 != record->journalIdentifier;
+}
+
+- (void)acknowledgeIdentifier:(uint64_t)identifier
+{
+    RIJournalAcknowledge(_journal, identifier);
+}
+
+- (RIEventJournalAcknowledgement *)acknowledgementForRecord:(const RIEventRecord *)record
+                                                      count:(NSUInteger)count
+{
+    if (0 == record->journalIdentifier) return nil;
+    
+    if (0 == count) {
+        [self acknowledgeIdentifier:record->journalIdentifier];
+        return nil;
+    }
+    
+    return [[RIEventJournalAcknowledgement alloc] initWithJournal:self
+                                                       identifier:record->journalIdentifier
+                                                            count:count];
+}
+
+- (void)recoverWithHandler:(void (^)(RIEventRecord *))handler
+{
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
+        RIJournalRecover(_journal, RIEventJournalRecoverEntry, (__bridge void *)handler);
+    });
+}
+
+#pragma mark - Encoding
+
++ (NSData *)payloadWithRecord:(const RIEventRecord *)record
+{
+    NSMutableDictionary *properties = [NSMutableDictionary dictionary];
+    properties[kRIEventJournalKind] = @(record->kind);
+    
+    // Vocabulary identifiers are only valid within the process, so names are journaled as strings
+    // at the argument positions of the tracking call
+    id arguments[5] = {nil};
+    if (RIEventRecordKindEvent == record->kind) {
+        arguments[0] = RIEventRecordNameAtIndex(record, 0);
+        arguments[1] = RIEventRecordValueNumber(record);
+        arguments[2] = RIEventRecordNameAtIndex(record, 1);
+        arguments[3] = RIEventRecordNameAtIndex(record, 2);
+        arguments[4] = (__bridge id)record->arguments[0];
+    } else if (RIEventRecordKindScreen == record->kind) {
+        arguments[0] = RIEventRecordNameAtIndex(record, 0);
+    } else {
+        arguments[0] = (__bridge id)record->arguments[0];
+    }
+    
+    for (NSUInteger idx = 0; idx < 5; idx++) {
+        id argument = arguments[idx];
+        if (!argument) continue;
+        // Property lists cannot hold URLs
+        if ([argument isKindOfClass:NSURL.class]) argument = [argument absoluteString];
+        properties[[@(idx) stringValue]] = argument;
+    }
+    
+    return [NSPropertyListSerialization dataWithPropertyList:properties
+                                                      format:NSPropertyListBinaryFormat_v1_0
+                                                     options:0
+                                                       error:NULL];
+}
+
++ (BOOL)getRecord:(RIEventRecord *)record withPayload:(NSData *)payload
+{
+    NSDictionary *properties = [NSPropertyListSerialization propertyListWithData:payload
+                                                                         options:0
+                                                                          format:NULL
+                                                                           error:NULL];
+    
+    if (![properties isKindOfClass:NSDictionary.class]) return NO;
+    
+    id (^argument)(NSUInteger) = ^id(NSUInteger idx) {
+        return properties[[@(idx) stringValue]];
+    };
+    
+    switch ([properties[kRIEventJournalKind] unsignedIntegerValue]) {
+        case RIEventRecordKindEvent:
+            *record = RIEventRecordMakeEvent(argument(0), argument(1), argument(2), argument(3),
+                                             argument(4));
+            return YES;
+        case RIEventRecordKindScreen:
+            *record = RIEventRecordMakeWithName(RIEventRecordKindScreen, argument(0));
+            return YES;
+        case RIEventRecordKindException:
+            *record = RIEventRecordMakeWithName(RIEventRecordKindException, argument(0));
+            return YES;
+        case RIEventRecordKindOpenURL:
+            *record = RIEventRecordMakeOpenURL([NSURL URLWithString:argument(0)]);
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+@end
+
+@implementation RIEventJournalAcknowledgement
+
+- (instancetype)initWithJournal:(RIEventJournal *)journal
+                     identifier:(uint64_t)identifier
+                          count:(NSUInteger)count
+{
+    if ((self = [super init])) {
+        self.journal = journal;
+        self.identifier = identifier;
+        _count = (int64_t)count;
+    }
+    return self;
+}
+
+- (void)trackerDidProcess
+{
+    if (0 == __atomic_sub_fetch(&_count, 1, __ATOMIC_ACQ_REL)) {
+        [self.journal acknowledgeIdentifier:self.identifier];
+    }
+}
+
+@end
@@ -0,0 +1,49 @@
+//
+//  RIEventPipeline.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "RIEventRecord.h"
+
+/**
+ *  Convenience controller to pass event records from any thread through a bounded lock-free ring
+ *  buffer to a single drain thread, as an alternative to per-tracker operation queues
+ */
+@interface RIEventPipeline : NSObject
+
+/**
+ *  The number of records dropped because the ring buffer was full
+ */
+@property (readonly) uint64_t droppedCount;
+
+/**
+ *  Create and initialize a `RIEventPipeline` object and start its drain thread
+ *
+ *  @param capacity The number of records the ring buffer holds.
+ *  @param handler A handler called on the drain thread for each record, in order of enqueueing.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+                         handler:(void (^)(const RIEventRecord *))handler;
+
+/**
+ *  Enqueue a record to be passed to the handler. The pipeline takes ownership of the record, which
+ *  is disposed once handled or if it cannot be enqueued.
+ *
+ *  @param record The record to enqueue.
+ *
+ *  @return True in case of success, false if the ring buffer was full and the record was dropped
+ */
+- (BOOL)enqueueRecord:(RIEventRecord *)record;
+
+/**
+ *  Stop the drain thread after handling the records enqueued so far
+ */
+- (void)stop;
+
+@end
@@ -0,0 +1,123 @@
+//
+//  RIEventPipeline.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIEventPipeline.h"
+#import "RIEventRing.h"
+#import "RITracking.h"
+
+typedef void(^RIEventPipelineHandler)(const RIEventRecord *);
+
+@interface RIEventPipeline ()
+{
+    RIEventRing *_ring;
+    uint64_t _droppedCount;
+    int _sleeping;
+    int _stopped;
+}
+
+@property (copy) RIEventPipelineHandler handler;
+@property dispatch_semaphore_t wakeup;
+
+@end
+
+@implementation RIEventPipeline
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+                         handler:(void (^)(const RIEventRecord *))handler
+{
+    if ((self = [super init])) {
+        _ring = RIEventRingCreate(capacity, sizeof(RIEventRecord));
+        
+        if (!_ring) {
+            RIRaiseError(@"Unexpected error when creating event ring buffer of capacity %lu",
+                         (unsigned long)capacity);
+            return nil;
+        }
+        
+        self.handler = handler;
+        self.wakeup = dispatch_semaphore_create(0);
+        
+        NSThread *thread = [[NSThread alloc] initWithTarget:self selector:@selector(drain) object:nil];
+        thread.name = @"de.rocket-internet.RITracking.pipeline";
+        [thread start];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    RIEventRecord record;
+    while (RIEventRingTryPop(_ring, &record)) {
+        RIEventRecordDispose(&record);
+    }
+    RIEventRingDestroy(_ring);
+}
+
+- (uint64_t)droppedCount
+{
+    return __atomic_load_n(&_droppedCount, __ATOMIC_RELAXED);
+}
+
+- (BOOL)enqueueRecord:(RIEventRecord *)record
+{
+    if (!RIEventRingTryPush(_ring, record)) {
+        __atomic_add_fetch(&_droppedCount, 1, __ATOMIC_RELAXED);
+        RIEventRecordDispose(record);
+        return NO;
+    }
+    
+    // Only pay for a wakeup if the drain thread went to sleep on an empty ring buffer
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_exchange_n(&_sleeping, 0, __ATOMIC_SEQ_CST)) {
+        dispatch_semaphore_signal(self.wakeup);
+    }
+    
+    return YES;
+}
+
+- (void)stop
+{
+    __atomic_store_n(&_stopped, 1, __ATOMIC_SEQ_CST);
+    dispatch_semaphore_signal(self.wakeup);
+}
+
+#pragma mark - Drain thread
+
+- (void)drain
+{
+    RIEventRecord record;
+    
+    while (YES) {
+        @autoreleasepool {
+            if (RIEventRingTryPop(_ring, &record)) {
+                self.handler(&record);
+                RIEventRecordDispose(&record);
+                continue;
+            }
+        }
+        
+        if (__atomic_load_n(&_stopped, __ATOMIC_SEQ_CST)) break;
+        
+        // Announce going to sleep, then check again to not miss a record enqueued meanwhile
+        __atomic_store_n(&_sleeping, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        
+        if (RIEventRingTryPop(_ring, &record)) {
+            __atomic_store_n(&_sleeping, 0, __ATOMIC_SEQ_CST);
+            @autoreleasepool {
+                self.handler(&record);
+            }
+            RIEventRecordDispose(&record);
+            continue;
+        }
+        
+        dispatch_semaphore_wait(self.wakeup, DISPATCH_TIME_FOREVER);
+    }
+}
+
+@end
@@ -0,0 +1,183 @@
+//
+//  RIEventRecord.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "RIVocabulary.h"
+
+/**
+ *  Kinds of tracking calls carried by an event record
+ */
+typedef NS_ENUM(uint8_t, RIEventRecordKind) {
+    RIEventRecordKindLaunch,
+    RIEventRecordKindEvent,
+    RIEventRecordKindScreen,
+    RIEventRecordKindException,
+    RIEventRecordKindOpenURL
+};
+
+/**
+ *  Number of interned names an event record can carry
+ */
+#define RI_EVENT_RECORD_NAMES 3
+
+/**
+ *  Number of object arguments an event record can carry
+ */
+#define RI_EVENT_RECORD_ARGUMENTS 2
+
+/**
+ *  Index of the argument carrying the names the vocabulary had no room for
+ */
+#define RI_EVENT_RECORD_NAMES_ARGUMENT 1
+
+/**
+ *  Types of the scalar value of an event record
+ */
+typedef NS_ENUM(uint8_t, RIEventRecordValueType) {
+    RIEventRecordValueTypeNone,
+    RIEventRecordValueTypeInteger,
+    RIEventRecordValueTypeReal
+};
+
+/**
+ *  Scalar value of an event, held inline instead of as a number object
+ */
+typedef struct RIEventRecordValue {
+    RIEventRecordValueType type;
+    union {
+        int64_t integer;
+        double real;
+    };
+} RIEventRecordValue;
+
+/**
+ *  Fixed-size record of a tracking call and its arguments, to be passed around by value.
+ *
+ *  Event, action, category and screen names are carried as vocabulary identifiers and only resolved
+ *  to strings when delivered to a tracker. An event record holds the event, action and category
+ *  names, its value inline and its data as first argument, a screen record its name. Exception,
+ *  deeplink and launch records hold their name, URL or launch options as first argument. Names the
+ *  vocabulary has no room for are carried as an array of strings in the names argument instead,
+ *  with NSNull in place of the names interned.
+ *
+ *  The arguments are retained by the record. A record has to be disposed exactly once, using
+ *  RIEventRecordDispose, to release them. The journal identifier is zero unless the record was
+ *  appended to an event journal.
+ */
+typedef struct RIEventRecord {
+    RIEventRecordKind kind;
+    RIVocabularyIdentifier names[RI_EVENT_RECORD_NAMES];
+    RIEventRecordValue value;
+    const void *arguments[RI_EVENT_RECORD_ARGUMENTS];
+    uint64_t journalIdentifier;
+} RIEventRecord;
+
+/**
+ *  Protocol of trackers taking event records directly, instead of the arguments of
+ *  trackEvent:value:action:category:data: resolved from the record
+ */
+@protocol RIEventRecordTracking <NSObject>
+
+/**
+ *  Track an event record, called on the tracker's queue
+ *
+ *  @param record The record of kind RIEventRecordKindEvent, only valid for the duration of the call.
+ */
+- (void)trackEventRecord:(const RIEventRecord *)record;
+
+@end
+
+/**
+ *  Make a record of an app launch
+ *
+ *  @param options The launching options.
+ *
+ *  @return The record
+ */
+RIEventRecord RIEventRecordMakeLaunch(NSDictionary *options);
+
+/**
+ *  Make a record of an event
+ *
+ *  @param event Name of the event
+ *  @param value (optional) The value of the action
+ *  @param action (optional) An identifier for the user action
+ *  @param category (optional) An identifier for the category of the app the user is in
+ *  @param data (optional) Additional data about the event
+ *
+ *  @return The record
+ */
+RIEventRecord RIEventRecordMakeEvent(NSString *event,
+                                     NSNumber *value,
+                                     NSString *action,
+                                     NSString *category,
+                                     NSDictionary *data);
+
+/**
+ *  Make a record of a screen view or an exception
+ *
+ *  @param kind Either RIEventRecordKindScreen or RIEventRecordKindException.
+ *  @param name The screen's or exception's name.
+ *
+ *  @return The record
+ */
+RIEventRecord RIEventRecordMakeWithName(RIEventRecordKind kind, NSString *name);
+
+/**
+ *  Make a record of a deeplink URL
+ *
+ *  @param url The URL opened.
+ *
+ *  @return The record
+ */
+RIEventRecord RIEventRecordMakeOpenURL(NSURL *url);
+
+/**
+ *  The name of a screen, exception or event record
+ *
+ *  @param record The record.
+ *
+ *  @return The name
+ */
+NSString *RIEventRecordName(const RIEventRecord *record);
+
+/**
+ *  A name of a record, whether interned or carried as string
+ *
+ *  @param record The record.
+ *  @param index The index of the name, below RI_EVENT_RECORD_NAMES.
+ *
+ *  @return The name, nil if there is none
+ */
+NSString *RIEventRecordNameAtIndex(const RIEventRecord *record, NSUInteger index);
+
+/**
+ *  The value of an event record as a number object
+ *
+ *  @param record The record.
+ *
+ *  @return The value, nil if the event has none
+ */
+NSNumber *RIEventRecordValueNumber(const RIEventRecord *record);
+
+/**
+ *  Deliver a record to a tracker by calling the tracking method matching the record's kind. The
+ *  tracker has to conform to the corresponding tracking protocol. Event records are passed as they
+ *  are to trackers implementing RIEventRecordTracking.
+ *
+ *  @param record The record to deliver.
+ *  @param tracker The tracker to call.
+ */
+void RIEventRecordDeliver(const RIEventRecord *record, id tracker);
+
+/**
+ *  Release the arguments of a record
+ *
+ *  @param record The record to dispose.
+ */
+void RIEventRecordDispose(RIEventRecord *record);
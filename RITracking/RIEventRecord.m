@@ -0,0 +1,147 @@
+//
+//  RIEventRecord.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIEventRecord.h"
+#import "RITracking.h"
+
+/**
+ *  Intern the names of a record, carrying those the vocabulary has no room for as strings
+ */
+static void RIEventRecordSetNames(RIEventRecord *record, NSString * const *names, NSUInteger count)
+{
+    BOOL carried = NO;
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        record->names[idx] = RIVocabularyIntern(names[idx]);
+        if (names[idx] && !record->names[idx]) carried = YES;
+    }
+    
+    if (!carried) return;
+    
+    NSMutableArray *carriedNames = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        BOOL interned = !names[idx] || record->names[idx];
+        [carriedNames addObject:(interned ? [NSNull null] : [names[idx] copy])];
+    }
+    record->arguments[RI_EVENT_RECORD_NAMES_ARGUMENT] = CFBridgingRetain([carriedNames copy]);
+}
+
+RIEventRecord RIEventRecordMakeLaunch(NSDictionary *options)
+{
+    RIEventRecord record = {RIEventRecordKindLaunch};
+    record.arguments[0] = CFBridgingRetain(options);
+    return record;
+}
+
+RIEventRecord RIEventRecordMakeEvent(NSString *event,
+                                     NSNumber *value,
+                                     NSString *action,
+                                     NSString *category,
+                                     NSDictionary *data)
+{
+    RIEventRecord record = {RIEventRecordKindEvent};
+    NSString *names[RI_EVENT_RECORD_NAMES] = {event, action, category};
+    RIEventRecordSetNames(&record, names, RI_EVENT_RECORD_NAMES);
+    if (value) {
+        // Only floating point numbers are kept as such, any other number as integer
+        char type = value.objCType[0];
+        if ('f' == type || 'd' == type) {
+            record.value.type = RIEventRecordValueTypeReal;
+            record.value.real = value.doubleValue;
+        } else {
+            record.value.type = RIEventRecordValueTypeInteger;
+            record.value.integer = value.longLongValue;
+        }
+    }
+    record.arguments[0] = CFBridgingRetain(data);
+    return record;
+}
+
+RIEventRecord RIEventRecordMakeWithName(RIEventRecordKind kind, NSString *name)
+{
+    RIEventRecord record = {kind};
+    // Exception names are mostly unique, so only screen names are interned
+    if (RIEventRecordKindScreen == kind) {
+        RIEventRecordSetNames(&record, &name, 1);
+    } else {
+        record.arguments[0] = CFBridgingRetain(name);
+    }
+    return record;
+}
+
+RIEventRecord RIEventRecordMakeOpenURL(NSURL *url)
+{
+    RIEventRecord record = {RIEventRecordKindOpenURL};
+    record.arguments[0] = CFBridgingRetain(url);
+    return record;
+}
+
+NSString *RIEventRecordName(const RIEventRecord *record)
+{
+    if (RIEventRecordKindException == record->kind) return (__bridge NSString *)record->arguments[0];
+    return RIEventRecordNameAtIndex(record, 0);
+}
+
+NSString *RIEventRecordNameAtIndex(const RIEventRecord *record, NSUInteger index)
+{
+    if (record->names[index]) return RIVocabularyName(record->names[index]);
+    
+    NSArray *carriedNames = (__bridge NSArray *)record->arguments[RI_EVENT_RECORD_NAMES_ARGUMENT];
+    id name = index < carriedNames.count ? carriedNames[index] : nil;
+    return [NSNull null] == name ? nil : name;
+}
+
+NSNumber *RIEventRecordValueNumber(const RIEventRecord *record)
+{
+    switch (record->value.type) {
+        case RIEventRecordValueTypeNone: return nil;
+        case RIEventRecordValueTypeInteger: return @(record->value.integer);
+        case RIEventRecordValueTypeReal: return @(record->value.real);
+    }
+    return nil;
+}
+
+void RIEventRecordDeliver(const RIEventRecord *record, id tracker)
+{
+    switch (record->kind) {
+        case RIEventRecordKindLaunch:
+            [(id<RITracker>)tracker applicationDidLaunchWithOptions:
+             (__bridge NSDictionary *)record->arguments[0]];
+            break;
+        case RIEventRecordKindEvent:
+            if ([tracker respondsToSelector:@selector(trackEventRecord:)]) {
+                [(id<RIEventRecordTracking>)tracker trackEventRecord:record];
+                break;
+            }
+            [(id<RIEventTracking>)tracker trackEvent:RIEventRecordNameAtIndex(record, 0)
+                                               value:RIEventRecordValueNumber(record)
+                                              action:RIEventRecordNameAtIndex(record, 1)
+                                            category:RIEventRecordNameAtIndex(record, 2)
+                                                data:(__bridge NSDictionary *)record->arguments[0]];
+            break;
+        case RIEventRecordKindScreen:
+            [(id<RIScreenTracking>)tracker trackScreenWithName:RIEventRecordNameAtIndex(record, 0)];
+            break;
+        case RIEventRecordKindException:
+            [(id<RIExceptionTracking>)tracker trackExceptionWithName:
+             (__bridge NSString *)record->arguments[0]];
+            break;
+        case RIEventRecordKindOpenURL:
+            [(id<RIOpenURLTracking>)tracker trackOpenURL:(__bridge NSURL *)record->arguments[0]];
+            break;
+    }
+}
+
+void RIEventRecordDispose(RIEventRecord *record)
+{
+    for (NSUInteger idx = 0; idx < RI_EVENT_RECORD_ARGUMENTS; idx++) {
+        if (record->arguments[idx]) {
+            CFRelease(record->arguments[idx]);
+            record->arguments[idx] = NULL;
+        }
+    }
+}
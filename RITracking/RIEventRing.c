@@ -0,0 +1,110 @@
+//
+//  RIEventRing.c
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#include "RIEventRing.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Keep producer and consumer positions on separate cache lines to avoid false sharing
+#define RI_EVENT_RING_CACHE_LINE 64
+
+struct RIEventRing {
+    size_t mask;
+    size_t recordSize;
+    size_t *sequences;
+    unsigned char *records;
+    char padding0[RI_EVENT_RING_CACHE_LINE];
+    size_t enqueuePosition;
+    char padding1[RI_EVENT_RING_CACHE_LINE];
+    size_t dequeuePosition;
+    char padding2[RI_EVENT_RING_CACHE_LINE];
+};
+
+RIEventRing *RIEventRingCreate(size_t capacity, size_t recordSize)
+{
+    size_t slots = 2;
+    while (slots < capacity) slots <<= 1;
+    
+    RIEventRing *ring = calloc(1, sizeof(RIEventRing));
+    if (!ring) return NULL;
+    
+    ring->mask = slots - 1;
+    ring->recordSize = recordSize;
+    ring->sequences = malloc(slots * sizeof(size_t));
+    ring->records = malloc(slots * recordSize);
+    
+    if (!ring->sequences || !ring->records) {
+        RIEventRingDestroy(ring);
+        return NULL;
+    }
+    
+    for (size_t idx = 0; idx < slots; idx++) {
+        ring->sequences[idx] = idx;
+    }
+    
+    return ring;
+}
+
+void RIEventRingDestroy(RIEventRing *ring)
+{
+    if (!ring) return;
+    free(ring->sequences);
+    free(ring->records);
+    free(ring);
+}
+
+bool RIEventRingTryPush(RIEventRing *ring, const void *record)
+{
+    size_t position = __atomic_load_n(&ring->enqueuePosition, __ATOMIC_RELAXED);
+    
+    for (;;) {
+        size_t *sequence = &ring->sequences[position & ring->mask];
+        intptr_t diff = (intptr_t)__atomic_load_n(sequence, __ATOMIC_ACQUIRE) - (intptr_t)position;
+        
+        if (0 == diff) {
+            // Slot is free for this lap, try to claim it
+            if (__atomic_compare_exchange_n(&ring->enqueuePosition, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                memcpy(ring->records + (position & ring->mask) * ring->recordSize,
+                       record,
+                       ring->recordSize);
+                __atomic_store_n(sequence, position + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            // Lost the race, position got reloaded by the failed exchange
+        } else if (diff < 0) {
+            // Slot still holds a record of the previous lap
+            return false;
+        } else {
+            position = __atomic_load_n(&ring->enqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+bool RIEventRingTryPop(RIEventRing *ring, void *record)
+{
+    size_t position = ring->dequeuePosition;
+    size_t *sequence = &ring->sequences[position & ring->mask];
+    intptr_t diff = (intptr_t)__atomic_load_n(sequence, __ATOMIC_ACQUIRE) - (intptr_t)(position + 1);
+    
+    // Slot not yet filled for this lap
+    if (diff < 0) return false;
+    
+    memcpy(record, ring->records + (position & ring->mask) * ring->recordSize, ring->recordSize);
+    __atomic_store_n(sequence, position + ring->mask + 1, __ATOMIC_RELEASE);
+    ring->dequeuePosition = position + 1;
+    
+    return true;
+}
+
+size_t RIEventRingCapacity(const RIEventRing *ring)
+{
+    return ring->mask + 1;
+}
@@ -0,0 +1,70 @@
+//
+//  RIEventRing.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#ifndef RITracking_RIEventRing_h
+#define RITracking_RIEventRing_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ *  Bounded lock-free ring buffer of fixed-size records, safe for any number of producer threads
+ *  and a single consumer thread.
+ *
+ *  Each slot carries a sequence number telling producers and the consumer whether it is free or
+ *  filled for the current lap, so neither side needs a lock.
+ */
+typedef struct RIEventRing RIEventRing;
+
+/**
+ *  Create a ring buffer
+ *
+ *  @param capacity The number of slots, rounded up to the next power of two.
+ *  @param recordSize The size in bytes of a single record.
+ *
+ *  @return The ring buffer created, or NULL if out of memory
+ */
+RIEventRing *RIEventRingCreate(size_t capacity, size_t recordSize);
+
+/**
+ *  Destroy a ring buffer. Records still contained are discarded without notice.
+ *
+ *  @param ring The ring buffer to destroy.
+ */
+void RIEventRingDestroy(RIEventRing *ring);
+
+/**
+ *  Copy a record into the ring buffer. May be called from any thread.
+ *
+ *  @param ring The ring buffer.
+ *  @param record The record to copy, of the ring buffer's record size.
+ *
+ *  @return True in case of success, false if the ring buffer is full
+ */
+bool RIEventRingTryPush(RIEventRing *ring, const void *record);
+
+/**
+ *  Copy the oldest record out of the ring buffer. Must be called from the single consumer thread.
+ *
+ *  @param ring The ring buffer.
+ *  @param record Storage of the ring buffer's record size to copy the record to.
+ *
+ *  @return True in case of success, false if the ring buffer is empty
+ */
+bool RIEventRingTryPop(RIEventRing *ring, void *record);
+
+/**
+ *  The number of slots of the ring buffer
+ *
+ *  @param ring The ring buffer.
+ *
+ *  @return The capacity of the ring buffer
+ */
+size_t RIEventRingCapacity(const RIEventRing *ring);
+
+#endif
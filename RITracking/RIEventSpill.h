@@ -0,0 +1,52 @@
+//
+//  RIEventSpill.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "RIEventRecord.h"
+
+/**
+ *  First-in first-out file of event records, holding the records a tracker's inbox has no memory
+ *  budget for until the tracker catches up. Records are encoded the same as in the event journal.
+ *
+ *  The file only lives as long as the process, a spill left from a previous process is discarded.
+ */
+@interface RIEventSpill : NSObject
+
+/**
+ *  The number of records in the spill
+ */
+@property (readonly) NSUInteger count;
+
+/**
+ *  Create and initialize a `RIEventSpill` object
+ *
+ *  @param path Path of the spill file. Its directory is created if missing.
+ *
+ *  @return The object created, or nil in case of error
+ */
+- (instancetype)initWithPath:(NSString *)path;
+
+/**
+ *  Append a record. May be called from any thread.
+ *
+ *  @param record The record, still owned by the caller.
+ *
+ *  @return True in case of success, false in case of error
+ */
+- (BOOL)appendRecord:(const RIEventRecord *)record;
+
+/**
+ *  Take the oldest record. May be called from any thread.
+ *
+ *  @param record The record taken, owned by the caller afterwards.
+ *
+ *  @return True if a record was taken, false if the spill is empty
+ */
+- (BOOL)popRecord:(RIEventRecord *)record;
+
+@end
@@ -0,0 +1,115 @@
+//
+//  RIEventSpill.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIEventSpill.h"
+#import "RIEventJournal.h"
+#import <pthread.h>
+#import <unistd.h>
+
+@interface RIEventSpill ()
+{
+    FILE *_file;
+    off_t _readOffset;
+    off_t _writeOffset;
+    pthread_mutex_t _mutex;
+}
+
+@property (readwrite) NSUInteger count;
+
+@end
+
+@implementation RIEventSpill
+
+- (instancetype)initWithPath:(NSString *)path
+{
+    if ((self = [super init])) {
+        [[NSFileManager defaultManager] createDirectoryAtPath:[path stringByDeletingLastPathComponent]
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:NULL];
+        
+        // Truncates a spill left from a previous process
+        _file = fopen(path.fileSystemRepresentation, "w+b");
+        
+        if (!_file) {
+            RIRaiseError(@"Unexpected error when opening spill file at path '%@'", path);
+            return nil;
+        }
+        
+        pthread_mutex_init(&_mutex, NULL);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_file) {
+        fclose(_file);
+        pthread_mutex_destroy(&_mutex);
+    }
+}
+
+- (BOOL)appendRecord:(const RIEventRecord *)record
+{
+    NSData *payload = [RIEventJournal payloadWithRecord:record];
+    uint32_t length = (uint32_t)payload.length;
+    
+    if (!payload) return NO;
+    
+    pthread_mutex_lock(&_mutex);
+    
+    BOOL appended = 0 == fseeko(_file, _writeOffset, SEEK_SET) &&
+                    1 == fwrite(&length, sizeof(length), 1, _file) &&
+                    1 == fwrite(payload.bytes, length, 1, _file);
+    
+    if (appended) {
+        _writeOffset += (off_t)(sizeof(length) + length);
+        self.count++;
+    }
+    
+    pthread_mutex_unlock(&_mutex);
+    return appended;
+}
+
+- (BOOL)popRecord:(RIEventRecord *)record
+{
+    NSMutableData *payload = nil;
+    
+    pthread_mutex_lock(&_mutex);
+    
+    while (!payload && _readOffset < _writeOffset) {
+        uint32_t length = 0;
+        
+        // Records behind an unreadable length cannot be found, they are discarded
+        if (0 != fseeko(_file, _readOffset, SEEK_SET) || 1 != fread(&length, sizeof(length), 1, _file)) {
+            RILog(RILogLevelWarning, @"Discarding %lu unreadable spilled records", (unsigned long)self.count);
+            _readOffset = _writeOffset;
+            self.count = 0;
+            break;
+        }
+        
+        payload = [NSMutableData dataWithLength:length];
+        if (1 != fread(payload.mutableBytes, length, 1, _file)) payload = nil;
+        
+        _readOffset += (off_t)(sizeof(length) + length);
+        self.count--;
+    }
+    
+    // Start over once all records were taken, so the file does not grow while spilling goes on
+    if (_readOffset >= _writeOffset && 0 < _writeOffset) {
+        _readOffset = 0;
+        _writeOffset = 0;
+        ftruncate(fileno(_file), 0);
+    }
+    
+    pthread_mutex_unlock(&_mutex);
+    
+    return payload && [RIEventJournal getRecord:record withPayload:payload];
+}
+
+@end
@@ -0,0 +1,97 @@
+//
+//  RIGoogleAnalyticsDispatchController.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class GAI;
+
+/**
+ *  Default shortest dispatch interval, used while hits are sent
+ */
+extern NSTimeInterval const kRIGoogleAnalyticsDefaultMinimumDispatchInterval;
+
+/**
+ *  Default longest dispatch interval, the interval is stretched up to while idle
+ */
+extern NSTimeInterval const kRIGoogleAnalyticsDefaultMaximumDispatchInterval;
+
+/**
+ *  Default number of pending hits that triggers a dispatch before the interval elapsed
+ */
+extern NSUInteger const kRIGoogleAnalyticsDefaultDispatchThreshold;
+
+/**
+ *  Controller adapting when Google Analytics dispatches the hits sent.
+ *
+ *  Hits are dispatched as soon as the number of pending hits reaches the threshold, so bursts do not
+ *  wait for the interval to elapse. While no hits are sent the interval is doubled up to the maximum,
+ *  to not wake the radio for nothing, and reset to the minimum on the next hit.
+ */
+@interface RIGoogleAnalyticsDispatchController : NSObject
+
+/**
+ *  The Google Analytics instance dispatching the hits
+ */
+@property (readonly) GAI *analytics;
+
+/**
+ *  The shortest dispatch interval in seconds, used while hits are sent
+ */
+@property (nonatomic) NSTimeInterval minimumInterval;
+
+/**
+ *  The longest dispatch interval in seconds
+ */
+@property (nonatomic) NSTimeInterval maximumInterval;
+
+/**
+ *  The number of pending hits triggering a dispatch
+ */
+@property (nonatomic) NSUInteger threshold;
+
+/**
+ *  The current dispatch interval in seconds
+ */
+@property (readonly) NSTimeInterval interval;
+
+/**
+ *  Create and initialize a `RIGoogleAnalyticsDispatchController` object with default bounds
+ *
+ *  @param analytics The Google Analytics instance dispatching the hits.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithAnalytics:(GAI *)analytics;
+
+/**
+ *  Set the interval bounds and threshold from the configuration, keeping defaults for missing keys
+ */
+- (void)loadConfiguration;
+
+/**
+ *  Set the dispatch interval of Google Analytics to the minimum and start adapting it
+ */
+- (void)start;
+
+/**
+ *  Count a hit sent to Google Analytics, dispatching the pending hits if they reach the threshold
+ */
+- (void)hitSent;
+
+/**
+ *  Dispatch the pending hits right away, e.g. after sending hits belonging together
+ */
+- (void)dispatchPendingHits;
+
+/**
+ *  Dispatch the pending hits, or stretch the interval if there are none. Called by the controller's
+ *  timer whenever the interval elapsed.
+ */
+- (void)intervalDidElapse;
+
+@end
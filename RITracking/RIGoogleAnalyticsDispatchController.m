@@ -0,0 +1,165 @@
+//
+//  RIGoogleAnalyticsDispatchController.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIGoogleAnalyticsDispatchController.h"
+#import "RIGoogleAnalyticsTracker.h"
+#import "GAI.h"
+
+NSTimeInterval const kRIGoogleAnalyticsDefaultMinimumDispatchInterval = 5;
+NSTimeInterval const kRIGoogleAnalyticsDefaultMaximumDispatchInterval = 120;
+NSUInteger const kRIGoogleAnalyticsDefaultDispatchThreshold = 20;
+
+@interface RIGoogleAnalyticsDispatchController ()
+{
+    uint32_t _pendingCount;
+    int _stretched;
+}
+
+@property (readwrite) GAI *analytics;
+@property (readwrite) NSTimeInterval interval;
+@property dispatch_source_t timer;
+
+@end
+
+@implementation RIGoogleAnalyticsDispatchController
+
+- (instancetype)initWithAnalytics:(GAI *)analytics
+{
+    if ((self = [super init])) {
+        self.analytics = analytics;
+        _minimumInterval = kRIGoogleAnalyticsDefaultMinimumDispatchInterval;
+        _maximumInterval = kRIGoogleAnalyticsDefaultMaximumDispatchInterval;
+        _threshold = kRIGoogleAnalyticsDefaultDispatchThreshold;
+        _interval = _minimumInterval;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (self.timer) dispatch_source_cancel(self.timer);
+}
+
+/**
+ *  A positive number from the configuration, nil if the key is missing or holds something else
+ */
+static NSNumber *RIGoogleAnalyticsDispatchSetting(NSString *key)
+{
+    id value = [RITrackingConfiguration valueForKey:key];
+    
+    if (![value isKindOfClass:NSNumber.class] || 0 >= [value doubleValue]) return nil;
+    return value;
+}
+
+- (void)loadConfiguration
+{
+    NSNumber *minimum = RIGoogleAnalyticsDispatchSetting(kRIGoogleAnalyticsMinimumDispatchInterval);
+    NSNumber *maximum = RIGoogleAnalyticsDispatchSetting(kRIGoogleAnalyticsMaximumDispatchInterval);
+    NSNumber *threshold = RIGoogleAnalyticsDispatchSetting(kRIGoogleAnalyticsDispatchThreshold);
+    
+    @synchronized(self) {
+        if (minimum) self.minimumInterval = minimum.doubleValue;
+        if (maximum) self.maximumInterval = maximum.doubleValue;
+        if (threshold) self.threshold = threshold.unsignedIntegerValue;
+        
+        if (self.maximumInterval < self.minimumInterval) {
+            RIRaiseError(@"Google Analytics maximum dispatch interval %.0f below minimum %.0f",
+                         self.maximumInterval, self.minimumInterval);
+            self.maximumInterval = self.minimumInterval;
+        }
+    }
+    
+    RIDebugLog(@"Google Analytics dispatches every %.0f to %.0f seconds or after %lu hits",
+               self.minimumInterval, self.maximumInterval, (unsigned long)self.threshold);
+}
+
+- (void)start
+{
+    @synchronized(self) {
+        if (!self.timer) {
+            __weak RIGoogleAnalyticsDispatchController *weakSelf = self;
+            self.timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0,
+                                                dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0));
+            dispatch_source_set_event_handler(self.timer, ^{
+                [weakSelf intervalDidElapse];
+            });
+            dispatch_resume(self.timer);
+        }
+        
+        [self setInterval:self.minimumInterval stretched:NO];
+    }
+}
+
+/**
+ *  Apply an interval to Google Analytics and the timer, called while synchronized
+ */
+- (void)setInterval:(NSTimeInterval)interval stretched:(BOOL)stretched
+{
+    self.interval = interval;
+    __atomic_store_n(&_stretched, stretched, __ATOMIC_RELAXED);
+    
+    // Google Analytics keeps dispatching on its own as a backstop, e.g. for uncaught exceptions
+    self.analytics.dispatchInterval = interval;
+    
+    if (self.timer) {
+        uint64_t nanoseconds = (uint64_t)(interval * NSEC_PER_SEC);
+        dispatch_source_set_timer(self.timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)nanoseconds),
+                                  nanoseconds, nanoseconds / 10);
+    }
+}
+
+- (void)dispatchPendingCount:(uint32_t)count
+{
+    RIDebugLog(@"Google Analytics dispatches %u pending hits", count);
+    [self.analytics dispatch];
+}
+
+- (void)hitSent
+{
+    uint32_t count = __atomic_add_fetch(&_pendingCount, 1, __ATOMIC_RELAXED);
+    
+    // Only the sender that takes the pending hits dispatches them
+    if (count >= self.threshold &&
+        __atomic_compare_exchange_n(&_pendingCount, &count, 0, NO, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        [self dispatchPendingCount:count];
+    }
+    
+    // Traffic resumed, do not let the hits wait for the stretched interval
+    if (__atomic_load_n(&_stretched, __ATOMIC_RELAXED)) {
+        @synchronized(self) {
+            if (__atomic_load_n(&_stretched, __ATOMIC_RELAXED)) {
+                [self setInterval:self.minimumInterval stretched:NO];
+            }
+        }
+    }
+}
+
+- (void)dispatchPendingHits
+{
+    uint32_t count = __atomic_exchange_n(&_pendingCount, 0, __ATOMIC_RELAXED);
+    
+    if (count) [self dispatchPendingCount:count];
+}
+
+- (void)intervalDidElapse
+{
+    uint32_t count = __atomic_exchange_n(&_pendingCount, 0, __ATOMIC_RELAXED);
+    
+    @synchronized(self) {
+        if (count) {
+            [self dispatchPendingCount:count];
+            if (self.interval != self.minimumInterval) {
+                [self setInterval:self.minimumInterval stretched:NO];
+            }
+        } else if (self.interval < self.maximumInterval) {
+            [self setInterval:MIN(self.interval * 2, self.maximumInterval) stretched:YES];
+        }
+    }
+}
+
+@end
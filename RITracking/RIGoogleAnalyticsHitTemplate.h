@@ -0,0 +1,45 @@
+//
+//  RIGoogleAnalyticsHitTemplate.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Immutable template of a Google Analytics hit, holding the parameters constant for a hit type and
+ *  the names of the fields filled in per hit.
+ *
+ *  A hit is created with a single dictionary allocation from the template's key and value arrays,
+ *  instead of running a dictionary builder for every hit.
+ */
+@interface RIGoogleAnalyticsHitTemplate : NSObject
+
+/**
+ *  The names of the fields filled in per hit, in the order values are passed
+ */
+@property (readonly) NSArray *fields;
+
+/**
+ *  Create and initialize a `RIGoogleAnalyticsHitTemplate` object
+ *
+ *  @param hit A hit of the template's type, as built by the Google Analytics dictionary builder.
+ *  @param fields The names of the fields filled in per hit. Their values in the hit are ignored.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithHit:(NSDictionary *)hit fields:(NSArray *)fields;
+
+/**
+ *  Create a hit from the template
+ *
+ *  @param values The values of the template's fields, in order. A nil value is sent as null, a
+ *  number as its string value, as the dictionary builder does.
+ *
+ *  @return The hit
+ */
+- (NSDictionary *)hitWithValues:(const id *)values;
+
+@end
@@ -0,0 +1,91 @@
+//
+//  RIGoogleAnalyticsHitTemplate.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIGoogleAnalyticsHitTemplate.h"
+#import "RILog.h"
+
+/**
+ *  Maximum number of parameters of a hit template
+ */
+#define RI_GOOGLE_ANALYTICS_HIT_PARAMETERS 16
+
+@interface RIGoogleAnalyticsHitTemplate ()
+{
+    __unsafe_unretained id _keys[RI_GOOGLE_ANALYTICS_HIT_PARAMETERS];
+    __unsafe_unretained id _constants[RI_GOOGLE_ANALYTICS_HIT_PARAMETERS];
+    NSUInteger _fieldCount;
+    NSUInteger _count;
+}
+
+@property (readwrite) NSArray *fields;
+
+/**
+ *  Keep the keys and constant values referenced by the C arrays alive
+ */
+@property NSArray *keys;
+@property NSArray *constants;
+
+@end
+
+@implementation RIGoogleAnalyticsHitTemplate
+
+- (instancetype)initWithHit:(NSDictionary *)hit fields:(NSArray *)fields
+{
+    if ((self = [super init])) {
+        NSMutableArray *keys = [fields mutableCopy];
+        NSMutableArray *constants = [NSMutableArray array];
+        
+        for (NSString *key in hit) {
+            if ([fields containsObject:key]) continue;
+            [keys addObject:key];
+            [constants addObject:hit[key]];
+        }
+        
+        if (RI_GOOGLE_ANALYTICS_HIT_PARAMETERS < keys.count) {
+            RIRaiseError(@"Unexpected number of %lu Google Analytics hit parameters",
+                         (unsigned long)keys.count);
+            return nil;
+        }
+        
+        self.fields = [fields copy];
+        self.keys = [keys copy];
+        self.constants = [constants copy];
+        _fieldCount = fields.count;
+        _count = keys.count;
+        
+        [self.keys getObjects:_keys range:NSMakeRange(0, _count)];
+        [self.constants getObjects:&_constants[_fieldCount] range:NSMakeRange(0, constants.count)];
+    }
+    return self;
+}
+
+- (NSDictionary *)hitWithValues:(const id *)values
+{
+    __unsafe_unretained id objects[RI_GOOGLE_ANALYTICS_HIT_PARAMETERS];
+    NSString *strings[RI_GOOGLE_ANALYTICS_HIT_PARAMETERS];
+    
+    for (NSUInteger idx = 0; idx < _fieldCount; idx++) {
+        id value = values[idx];
+        if (!value) {
+            objects[idx] = [NSNull null];
+        } else if ([value isKindOfClass:NSNumber.class]) {
+            strings[idx] = [value stringValue];
+            objects[idx] = strings[idx];
+        } else {
+            objects[idx] = value;
+        }
+    }
+    
+    for (NSUInteger idx = _fieldCount; idx < _count; idx++) {
+        objects[idx] = _constants[idx];
+    }
+    
+    return [NSDictionary dictionaryWithObjects:objects forKeys:_keys count:_count];
+}
+
+@end
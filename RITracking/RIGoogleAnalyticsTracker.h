@@ -11,6 +11,14 @@
 
 extern NSString * const kRIGoogleAnalyticsTrackingID;
 
+/**
+ *  Optional keys for the shortest and longest interval in seconds Google Analytics dispatches hits
+ *  in, and the number of pending hits dispatched right away
+ */
+extern NSString * const kRIGoogleAnalyticsMinimumDispatchInterval;
+extern NSString * const kRIGoogleAnalyticsMaximumDispatchInterval;
+extern NSString * const kRIGoogleAnalyticsDispatchThreshold;
+
 /**
  *  Convenience controller to proxy-pass tracking information to Google Analytics
  */
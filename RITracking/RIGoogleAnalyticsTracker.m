@@ -15,6 +15,11 @@
 // libz.dylib
 
 #import "RIGoogleAnalyticsTracker.h"
+#import "RITrackerRegistry.h"
+#import "RIEventRecord.h"
+#import "RIGoogleAnalyticsHitTemplate.h"
+#import "RIGoogleAnalyticsDispatchController.h"
+#import "RITrackingCart.h"
 #import "GAI.h"
 #import "GAITracker.h"
 #import "GAIDictionaryBuilder.h"
@@ -22,11 +27,97 @@
 #import "GAILogger.h"
 
 NSString * const kRIGoogleAnalyticsTrackingID = @"RIGoogleAnalyticsTrackingID";
+NSString * const kRIGoogleAnalyticsMinimumDispatchInterval = @"RIGoogleAnalyticsMinimumDispatchInterval";
+NSString * const kRIGoogleAnalyticsMaximumDispatchInterval = @"RIGoogleAnalyticsMaximumDispatchInterval";
+NSString * const kRIGoogleAnalyticsDispatchThreshold = @"RIGoogleAnalyticsDispatchThreshold";
+
+@interface RIGoogleAnalyticsTracker () <RIEventRecordTracking>
+
+/**
+ *  The Google Analytics tracker hits are sent to, resolved once on the queue and reused
+ */
+@property (nonatomic) id<GAITracker> analyticsTracker;
+
+/**
+ *  The controller deciding when the hits sent are dispatched
+ */
+@property (nonatomic) RIGoogleAnalyticsDispatchController *dispatchController;
+
+/**
+ *  The cart collecting the products until checkout, restored from the previous launch
+ */
+@property (nonatomic) RITrackingCart *cart;
+
+/**
+ *  Send a hit to the Google Analytics tracker and count it for dispatching
+ */
+- (void)sendHit:(NSDictionary *)hit tracker:(id<GAITracker>)tracker;
+
+@end
+
+/**
+ *  Immutable templates of the hits sent, built once
+ */
+static RIGoogleAnalyticsHitTemplate *RIGoogleAnalyticsScreenTemplate;
+static RIGoogleAnalyticsHitTemplate *RIGoogleAnalyticsEventTemplate;
+static RIGoogleAnalyticsHitTemplate *RIGoogleAnalyticsExceptionTemplate;
+static RIGoogleAnalyticsHitTemplate *RIGoogleAnalyticsTransactionTemplate;
+static RIGoogleAnalyticsHitTemplate *RIGoogleAnalyticsItemTemplate;
 
 @implementation RIGoogleAnalyticsTracker
 
 @synthesize queue;
 
++ (void)load
+{
+    [RITrackerRegistry registerTrackerNamed:@"RIGoogleAnalytics"
+                  requiredConfigurationKeys:@[kRIGoogleAnalyticsTrackingID]
+                                    factory:^id<RITracker>{
+                                        return [[RIGoogleAnalyticsTracker alloc] init];
+                                    }];
+}
+
++ (void)initialize
+{
+    if (self != RIGoogleAnalyticsTracker.class) return;
+    
+    RIGoogleAnalyticsScreenTemplate =
+    [[RIGoogleAnalyticsHitTemplate alloc] initWithHit:[[GAIDictionaryBuilder createAppView] build]
+                                               fields:@[kGAIScreenName]];
+    RIGoogleAnalyticsEventTemplate =
+    [[RIGoogleAnalyticsHitTemplate alloc] initWithHit:[[GAIDictionaryBuilder createEventWithCategory:nil
+                                                                                              action:nil
+                                                                                               label:nil
+                                                                                               value:nil] build]
+                                               fields:@[kGAIEventCategory, kGAIEventAction, kGAIEventLabel,
+                                                        kGAIEventValue]];
+    RIGoogleAnalyticsExceptionTemplate =
+    [[RIGoogleAnalyticsHitTemplate alloc] initWithHit:[[GAIDictionaryBuilder createExceptionWithDescription:nil
+                                                                                                 withFatal:NO] build]
+                                               fields:@[kGAIExDescription]];
+    RIGoogleAnalyticsTransactionTemplate =
+    [[RIGoogleAnalyticsHitTemplate alloc] initWithHit:[[GAIDictionaryBuilder createTransactionWithId:nil
+                                                                                         affiliation:nil
+                                                                                             revenue:nil
+                                                                                                 tax:nil
+                                                                                            shipping:nil
+                                                                                        currencyCode:nil] build]
+                                               fields:@[kGAITransactionId, kGAITransactionRevenue,
+                                                        kGAITransactionTax, kGAITransactionShipping,
+                                                        kGAICurrencyCode]];
+    RIGoogleAnalyticsItemTemplate =
+    [[RIGoogleAnalyticsHitTemplate alloc] initWithHit:[[GAIDictionaryBuilder createItemWithTransactionId:nil
+                                                                                                    name:nil
+                                                                                                     sku:nil
+                                                                                                category:nil
+                                                                                                   price:nil
+                                                                                                quantity:nil
+                                                                                            currencyCode:nil] build]
+                                               fields:@[kGAITransactionId, kGAIItemName, kGAIItemSku,
+                                                        kGAIItemCategory, kGAIItemPrice, kGAIItemQuantity,
+                                                        kGAICurrencyCode]];
+}
+
 - (id)init
 {
     RIDebugLog(@"Initializing Google Analytics tracker");
@@ -54,13 +145,84 @@ NSString * const kRIGoogleAnalyticsTrackingID = @"RIGoogleAnalyticsTrackingID";
     // Automatically send uncaught exceptions to Google Analytics.
     [GAI sharedInstance].trackUncaughtExceptions = YES;
     
-    // Dispatch tracking information every 5 seconds (default: 120)
-    [GAI sharedInstance].dispatchInterval = 5;
+    // Dispatch tracking information every 5 seconds (default: 120) while hits are sent, less often
+    // while idle and right away on bursts
+    self.dispatchController = [[RIGoogleAnalyticsDispatchController alloc]
+                               initWithAnalytics:[GAI sharedInstance]];
+    [self.dispatchController loadConfiguration];
+    [self.dispatchController start];
     
     // Create tracker instance.
-    [[GAI sharedInstance] trackerWithTrackingId:trackingId];
+    self.analyticsTracker = [[GAI sharedInstance] trackerWithTrackingId:trackingId];
     
-    NSLog(@"Initialized Google Analytics %d", [GAI sharedInstance].trackUncaughtExceptions);
+    RIDebugLog(@"Initialized Google Analytics %d", [GAI sharedInstance].trackUncaughtExceptions);
+}
+
+- (void)configurationDidChangeKeys:(NSSet *)keys
+{
+    if ([keys containsObject:kRIGoogleAnalyticsMinimumDispatchInterval] ||
+        [keys containsObject:kRIGoogleAnalyticsMaximumDispatchInterval] ||
+        [keys containsObject:kRIGoogleAnalyticsDispatchThreshold]) {
+        [self.dispatchController loadConfiguration];
+    }
+    
+    if (![keys containsObject:kRIGoogleAnalyticsTrackingID]) return;
+    
+    NSString *trackingId = [RITrackingConfiguration valueForKey:kRIGoogleAnalyticsTrackingID];
+    
+    RIDebugLog(@"Google Analytics tracker switches to tracking ID '%@'", trackingId);
+    
+    if (!trackingId) {
+        RIRaiseError(@"Missing Google Analytics Tracking ID in tracking properties");
+        return;
+    }
+    
+    self.analyticsTracker = [[GAI sharedInstance] trackerWithTrackingId:trackingId];
+    [GAI sharedInstance].defaultTracker = self.analyticsTracker;
+}
+
+/**
+ *  The tracker created on launch, falling back to the default tracker if none was created
+ */
+- (id<GAITracker>)analyticsTracker
+{
+    if (!_analyticsTracker) {
+        _analyticsTracker = [[GAI sharedInstance] defaultTracker];
+    }
+    return _analyticsTracker;
+}
+
+/**
+ *  The controller created on launch, falling back to one dispatching on the threshold only
+ */
+- (RIGoogleAnalyticsDispatchController *)dispatchController
+{
+    if (!_dispatchController) {
+        _dispatchController = [[RIGoogleAnalyticsDispatchController alloc]
+                               initWithAnalytics:[GAI sharedInstance]];
+    }
+    return _dispatchController;
+}
+
+/**
+ *  The cart persisted in the application support directory if none was set
+ */
+- (RITrackingCart *)cart
+{
+    if (!_cart) {
+        NSString *directory = [NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory,
+                                                                   NSUserDomainMask,
+                                                                   YES) firstObject];
+        _cart = [[RITrackingCart alloc]
+                 initWithPath:[directory stringByAppendingPathComponent:@"RIGoogleAnalyticsCart.plist"]];
+    }
+    return _cart;
+}
+
+- (void)sendHit:(NSDictionary *)hit tracker:(id<GAITracker>)tracker
+{
+    [tracker send:hit];
+    [self.dispatchController hitSent];
 }
 
 #pragma mark - RIExceptionTracking protocol
@@ -69,17 +231,16 @@ NSString * const kRIGoogleAnalyticsTrackingID = @"RIGoogleAnalyticsTrackingID";
 {
     RIDebugLog(@"Google Analytics tracker tracks exception with name '%@'", name);
     
-    id tracker = [[GAI sharedInstance] defaultTracker];
+    id<GAITracker> tracker = self.analyticsTracker;
     
     if (!tracker) {
         RIRaiseError(@"Missing default Google Analytics tracker");
+        RITrackerReportFailure();
         return;
     }
     
-    NSDictionary *dict = [[GAIDictionaryBuilder createExceptionWithDescription:name
-                                                                     withFatal:NO] build];
-    
-    [tracker send:dict];
+    id values[] = {name};
+    [self sendHit:[RIGoogleAnalyticsExceptionTemplate hitWithValues:values] tracker:tracker];
 }
 
 #pragma mark - RIScreenTracking
@@ -88,15 +249,17 @@ NSString * const kRIGoogleAnalyticsTrackingID = @"RIGoogleAnalyticsTrackingID";
 {
     RIDebugLog(@"Google Analytics - Tracking screen with name: %@", name);
     
-    id tracker = [[GAI sharedInstance] defaultTracker];
+    id<GAITracker> tracker = self.analyticsTracker;
     
     if (!tracker) {
         RIRaiseError(@"Missing default Google Analytics tracker");
+        RITrackerReportFailure();
         return;
     }
     
-    [tracker set:kGAIScreenName value:name];
-    [tracker send:[[GAIDictionaryBuilder createAppView] build]];
+    // The screen name is sent with the hit instead of being set on the shared tracker
+    id values[] = {name};
+    [self sendHit:[RIGoogleAnalyticsScreenTemplate hitWithValues:values] tracker:tracker];
 }
 
 #pragma mark - RIEventTracking
@@ -109,19 +272,56 @@ NSString * const kRIGoogleAnalyticsTrackingID = @"RIGoogleAnalyticsTrackingID";
 {
     RIDebugLog(@"Google Analytics - Tracking event: %@", event);
     
-    id tracker = [[GAI sharedInstance] defaultTracker];
+    id<GAITracker> tracker = self.analyticsTracker;
     
     if (!tracker) {
         RIRaiseError(@"Missing default Google Analytics tracker");
+        RITrackerReportFailure();
         return;
     }
     
-    NSDictionary *dict = [[GAIDictionaryBuilder createEventWithCategory:category
-                                                                 action:action
-                                                                  label:event
-                                                                  value:value] build];
+    id values[] = {category, action, event, value};
+    [self sendHit:[RIGoogleAnalyticsEventTemplate hitWithValues:values] tracker:tracker];
+}
+
+- (void)trackEventRecord:(const RIEventRecord *)record
+{
+    RIDebugLog(@"Google Analytics - Tracking event record: %@", RIEventRecordName(record));
+    
+    id<GAITracker> tracker = self.analyticsTracker;
     
-    [tracker send:dict];
+    if (!tracker) {
+        RIRaiseError(@"Missing default Google Analytics tracker");
+        RITrackerReportFailure();
+        return;
+    }
+    
+    // Names are resolved from the vocabulary without copying, the value is only boxed here
+    id values[] = {
+        RIEventRecordNameAtIndex(record, 2),
+        RIEventRecordNameAtIndex(record, 1),
+        RIEventRecordNameAtIndex(record, 0),
+        RIEventRecordValueNumber(record)
+    };
+    [self sendHit:[RIGoogleAnalyticsEventTemplate hitWithValues:values] tracker:tracker];
+}
+
+- (void)trackEvents:(NSArray *)events
+{
+    RIDebugLog(@"Google Analytics - Tracking batch of %lu events", (unsigned long)events.count);
+    
+    id<GAITracker> tracker = self.analyticsTracker;
+    
+    if (!tracker) {
+        RIRaiseError(@"Missing default Google Analytics tracker");
+        RITrackerReportFailure();
+        return;
+    }
+    
+    for (RITrackingEvent *event in events) {
+        id values[] = {event.category, event.action, event.event, event.value};
+        [self sendHit:[RIGoogleAnalyticsEventTemplate hitWithValues:values] tracker:tracker];
+    }
 }
 
 #pragma mark - RIEcommerceEventTracking
@@ -131,32 +331,52 @@ NSString * const kRIGoogleAnalyticsTrackingID = @"RIGoogleAnalyticsTrackingID";
 {
     RIDebugLog(@"Google Analytics - Tracking checkout with transaction id: %@", idTransaction);
     
-    id tracker = [[GAI sharedInstance] defaultTracker];
+    id<GAITracker> tracker = self.analyticsTracker;
     
     if (!tracker) {
         RIRaiseError(@"Missing default Google Analytics tracker");
+        RITrackerReportFailure();
         return;
     }
     
-    NSDictionary *dict = [[GAIDictionaryBuilder createTransactionWithId:idTransaction
-                                                            affiliation:nil
-                                                                revenue:nil
-                                                                    tax:total.tax
-                                                               shipping:total.shipping
-                                                           currencyCode:total.currency] build];
+    RITrackingCart *cart = self.cart;
+    NSNumber *revenue = total.net ?: cart.value;
+    NSArray *products = [cart checkout];
+    
+    id values[] = {idTransaction, revenue, total.tax, total.shipping, total.currency};
+    [self sendHit:[RIGoogleAnalyticsTransactionTemplate hitWithValues:values] tracker:tracker];
     
-    [tracker send:dict];
+    for (RITrackingProduct *product in products) {
+        id itemValues[] = {
+            idTransaction,
+            product.name,
+            product.identifier,
+            product.category,
+            product.price,
+            product.quantity,
+            product.currency ?: total.currency
+        };
+        [self sendHit:[RIGoogleAnalyticsItemTemplate hitWithValues:itemValues] tracker:tracker];
+    }
+    
+    // The transaction and its items are dispatched together
+    [self.dispatchController dispatchPendingHits];
 }
 
 -(void)trackProductAddToCart:(RITrackingProduct *)product
 {
-
+    RIDebugLog(@"Google Analytics - Tracking product added to cart: %@", product.identifier);
+    
+    [self.cart addProduct:product];
 }
 
 -(void)trackRemoveFromCartForProductWithID:(NSString *)idTransaction
                                   quantity:(NSNumber *)quantity
 {
+    RIDebugLog(@"Google Analytics - Tracking %@ of product removed from cart: %@", quantity,
+               idTransaction);
     
+    [self.cart removeProductWithIdentifier:idTransaction quantity:quantity];
 }
 
 @end
@@ -0,0 +1,515 @@
+//
+//  RIJournal.c
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#include "RIJournal.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RI_JOURNAL_MAGIC 0x4c4a4952u // "RIJL"
+#define RI_JOURNAL_VERSION 1u
+#define RI_JOURNAL_ENTRY_DATA 1u
+#define RI_JOURNAL_ENTRY_ACK 2u
+#define RI_JOURNAL_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+typedef struct RIJournalSegmentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t reserved;
+} RIJournalSegmentHeader;
+
+/**
+ *  Header of an entry. The size is stored last, so a zero size marks the end of a segment and an
+ *  entry is only visible once complete. The CRC covers all fields following it and the payload.
+ */
+typedef struct RIJournalEntryHeader {
+    uint32_t size;
+    uint32_t crc;
+    uint64_t identifier;
+    uint32_t type;
+    uint32_t reserved;
+} RIJournalEntryHeader;
+
+typedef struct RIJournalSegment {
+    uint32_t number;
+    size_t unacknowledged;
+    bool recovered;
+} RIJournalSegment;
+
+struct RIJournal {
+    pthread_mutex_t mutex;
+    char *directory;
+    size_t segmentSize;
+    RIJournalSegment *segments;
+    size_t segmentCount;
+    size_t segmentCapacity;
+    unsigned char *mapping;
+    size_t offset;
+    int fd;
+    RIJournal *next;
+};
+
+void (*RIJournalEntryWillPublishHook)(void);
+
+/**
+ *  Journals open in the process, linked by their next field
+ */
+static RIJournal *RIJournalOpenJournals;
+static pthread_mutex_t RIJournalOpenJournalsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+#pragma mark - CRC
+
+static uint32_t RIJournalCRCTable[256];
+static pthread_once_t RIJournalCRCTableOnce = PTHREAD_ONCE_INIT;
+
+static void RIJournalCRCTableInit(void)
+{
+    for (uint32_t idx = 0; idx < 256; idx++) {
+        uint32_t crc = idx;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+        }
+        RIJournalCRCTable[idx] = crc;
+    }
+}
+
+static uint32_t RIJournalCRC(const unsigned char *bytes, size_t length)
+{
+    uint32_t crc = 0xffffffffu;
+    for (size_t idx = 0; idx < length; idx++) {
+        crc = RIJournalCRCTable[(crc ^ bytes[idx]) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffu;
+}
+
+#pragma mark - Segments
+
+static void RIJournalSegmentPath(const RIJournal *journal, uint32_t number, char *path)
+{
+    snprintf(path, PATH_MAX, "%s/%08x.seg", journal->directory, number);
+}
+
+static bool RIJournalAddSegment(RIJournal *journal, uint32_t number, bool recovered)
+{
+    if (journal->segmentCount == journal->segmentCapacity) {
+        size_t capacity = journal->segmentCapacity ? journal->segmentCapacity * 2 : 8;
+        RIJournalSegment *segments = realloc(journal->segments, capacity * sizeof(RIJournalSegment));
+        if (!segments) return false;
+        journal->segments = segments;
+        journal->segmentCapacity = capacity;
+    }
+    journal->segments[journal->segmentCount++] = (RIJournalSegment){number, 0, recovered};
+    return true;
+}
+
+static RIJournalSegment *RIJournalFindSegment(RIJournal *journal, uint32_t number)
+{
+    for (size_t idx = 0; idx < journal->segmentCount; idx++) {
+        if (journal->segments[idx].number == number) return &journal->segments[idx];
+    }
+    return NULL;
+}
+
+static RIJournalSegment *RIJournalCurrentSegment(RIJournal *journal)
+{
+    return &journal->segments[journal->segmentCount - 1];
+}
+
+static void RIJournalUnmapCurrentSegment(RIJournal *journal)
+{
+    if (journal->mapping) munmap(journal->mapping, journal->segmentSize);
+    if (0 <= journal->fd) close(journal->fd);
+    journal->mapping = NULL;
+    journal->fd = -1;
+}
+
+static bool RIJournalCreateSegment(RIJournal *journal, uint32_t number)
+{
+    char path[PATH_MAX];
+    RIJournalSegmentPath(journal, number, path);
+    
+    // Another journal open on the directory may have taken the number, so take the next one then
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+    while (fd < 0 && EEXIST == errno && number < UINT32_MAX) {
+        RIJournalSegmentPath(journal, ++number, path);
+        fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    if (fd < 0) return false;
+    
+    if (0 != ftruncate(fd, (off_t)journal->segmentSize)) {
+        close(fd);
+        unlink(path);
+        return false;
+    }
+    
+    void *mapping = mmap(NULL, journal->segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == mapping || !RIJournalAddSegment(journal, number, true)) {
+        if (MAP_FAILED != mapping) munmap(mapping, journal->segmentSize);
+        close(fd);
+        unlink(path);
+        return false;
+    }
+    
+    RIJournalSegmentHeader *header = mapping;
+    header->magic = RI_JOURNAL_MAGIC;
+    header->version = RI_JOURNAL_VERSION;
+    
+    journal->mapping = mapping;
+    journal->fd = fd;
+    journal->offset = sizeof(RIJournalSegmentHeader);
+    return true;
+}
+
+/**
+ *  Delete the oldest segments as long as all their entries are acknowledged. Acknowledgements are
+ *  stored in later segments, so segments are only ever deleted from the oldest on.
+ */
+static void RIJournalPurgeSegments(RIJournal *journal)
+{
+    size_t purged = 0;
+    char path[PATH_MAX];
+    
+    while (purged + 1 < journal->segmentCount) {
+        RIJournalSegment *segment = &journal->segments[purged];
+        if (!segment->recovered || 0 < segment->unacknowledged) break;
+        RIJournalSegmentPath(journal, segment->number, path);
+        unlink(path);
+        purged++;
+    }
+    
+    if (0 < purged) {
+        journal->segmentCount -= purged;
+        memmove(journal->segments,
+                journal->segments + purged,
+                journal->segmentCount * sizeof(RIJournalSegment));
+    }
+}
+
+/**
+ *  Whether a segment belongs to another journal open on the directory. Call with the lock of the
+ *  open journals held.
+ */
+static bool RIJournalSegmentIsOpen(const RIJournal *journal, uint32_t number)
+{
+    for (RIJournal *other = RIJournalOpenJournals; other; other = other->next) {
+        if (0 != strcmp(other->directory, journal->directory)) continue;
+        pthread_mutex_lock(&other->mutex);
+        bool owned = NULL != RIJournalFindSegment(other, number);
+        pthread_mutex_unlock(&other->mutex);
+        if (owned) return true;
+    }
+    return false;
+}
+
+static int RIJournalCompareSegments(const void *lhs, const void *rhs)
+{
+    uint32_t a = ((const RIJournalSegment *)lhs)->number, b = ((const RIJournalSegment *)rhs)->number;
+    return a < b ? -1 : a > b;
+}
+
+#pragma mark - Entries
+
+static uint64_t RIJournalWriteEntry(RIJournal *journal,
+                                    uint32_t type,
+                                    uint64_t identifier,
+                                    const void *payload,
+                                    size_t length)
+{
+    size_t size = RI_JOURNAL_ALIGN(sizeof(RIJournalEntryHeader) + length);
+    
+    if (size > journal->segmentSize - sizeof(RIJournalSegmentHeader)) return 0;
+    
+    if (journal->offset + size > journal->segmentSize) {
+        uint32_t number = RIJournalCurrentSegment(journal)->number + 1;
+        RIJournalUnmapCurrentSegment(journal);
+        if (!RIJournalCreateSegment(journal, number)) {
+            // Without a segment, every entry retries to rotate instead of writing to the old offset
+            journal->offset = journal->segmentSize;
+            return 0;
+        }
+        RIJournalPurgeSegments(journal);
+    }
+    
+    if (!journal->mapping) return 0;
+    
+    RIJournalSegment *segment = RIJournalCurrentSegment(journal);
+    RIJournalEntryHeader *header = (RIJournalEntryHeader *)(journal->mapping + journal->offset);
+    
+    if (RI_JOURNAL_ENTRY_DATA == type) {
+        identifier = ((uint64_t)segment->number << 32) | journal->offset;
+        segment->unacknowledged++;
+    }
+    
+    header->identifier = identifier;
+    header->type = type;
+    header->reserved = 0;
+    memcpy(header + 1, payload, length);
+    header->crc = RIJournalCRC((const unsigned char *)&header->identifier,
+                               sizeof(RIJournalEntryHeader) - 8 + length);
+    if (RIJournalEntryWillPublishHook) RIJournalEntryWillPublishHook();
+    __atomic_store_n(&header->size, (uint32_t)(sizeof(RIJournalEntryHeader) + length),
+                     __ATOMIC_RELEASE);
+    
+    journal->offset += size;
+    return identifier;
+}
+
+typedef struct RIJournalScan {
+    const RIJournalEntryHeader **entries;
+    size_t entryCount;
+    size_t entryCapacity;
+    uint64_t *acknowledgements;
+    size_t acknowledgementCount;
+    size_t acknowledgementCapacity;
+} RIJournalScan;
+
+static bool RIJournalScanGrow(void **items, size_t *capacity, size_t count, size_t itemSize)
+{
+    if (count < *capacity) return true;
+    size_t newCapacity = *capacity ? *capacity * 2 : 64;
+    void *newItems = realloc(*items, newCapacity * itemSize);
+    if (!newItems) return false;
+    *items = newItems;
+    *capacity = newCapacity;
+    return true;
+}
+
+/**
+ *  Collect the valid entries of a mapped segment, up to its end or the first torn entry
+ */
+static void RIJournalScanSegment(RIJournalScan *scan, const unsigned char *mapping, size_t size)
+{
+    const RIJournalSegmentHeader *segmentHeader = (const RIJournalSegmentHeader *)mapping;
+    if (size < sizeof(RIJournalSegmentHeader) ||
+        RI_JOURNAL_MAGIC != segmentHeader->magic ||
+        RI_JOURNAL_VERSION != segmentHeader->version) return;
+    
+    size_t offset = sizeof(RIJournalSegmentHeader);
+    
+    while (offset + sizeof(RIJournalEntryHeader) <= size) {
+        const RIJournalEntryHeader *header = (const RIJournalEntryHeader *)(mapping + offset);
+        size_t entrySize = header->size;
+        
+        if (entrySize < sizeof(RIJournalEntryHeader) || offset + entrySize > size) break;
+        
+        uint32_t crc = RIJournalCRC((const unsigned char *)&header->identifier, entrySize - 8);
+        if (crc != header->crc) break;
+        
+        if (RI_JOURNAL_ENTRY_DATA == header->type) {
+            if (!RIJournalScanGrow((void **)&scan->entries, &scan->entryCapacity,
+                                   scan->entryCount, sizeof(*scan->entries))) break;
+            scan->entries[scan->entryCount++] = header;
+        } else if (RI_JOURNAL_ENTRY_ACK == header->type) {
+            if (!RIJournalScanGrow((void **)&scan->acknowledgements, &scan->acknowledgementCapacity,
+                                   scan->acknowledgementCount, sizeof(uint64_t))) break;
+            scan->acknowledgements[scan->acknowledgementCount++] = header->identifier;
+        }
+        
+        offset += RI_JOURNAL_ALIGN(entrySize);
+    }
+}
+
+static int RIJournalCompareIdentifiers(const void *lhs, const void *rhs)
+{
+    uint64_t a = *(const uint64_t *)lhs, b = *(const uint64_t *)rhs;
+    return a < b ? -1 : a > b;
+}
+
+#pragma mark - Journal
+
+RIJournal *RIJournalOpen(const char *directory, size_t segmentSize)
+{
+    pthread_once(&RIJournalCRCTableOnce, RIJournalCRCTableInit);
+    
+    RIJournal *journal = calloc(1, sizeof(RIJournal));
+    if (!journal) return NULL;
+    
+    pthread_mutex_init(&journal->mutex, NULL);
+    journal->directory = strdup(directory);
+    journal->segmentSize = RI_JOURNAL_ALIGN(segmentSize);
+    journal->fd = -1;
+    
+    DIR *dir = opendir(directory);
+    if (!dir || !journal->directory) {
+        if (dir) closedir(dir);
+        RIJournalClose(journal);
+        return NULL;
+    }
+    
+    pthread_mutex_lock(&RIJournalOpenJournalsMutex);
+    
+    // Segments left from previous processes are recovered later on. Segments of a journal still
+    // open, e.g. before a restart, hold entries still being processed and are left to it.
+    uint32_t lastNumber = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        unsigned int number;
+        char suffix[5];
+        if (2 == sscanf(entry->d_name, "%8x.%4s", &number, suffix) && 0 == strcmp(suffix, "seg")) {
+            if (number > lastNumber) lastNumber = number;
+            if (!RIJournalSegmentIsOpen(journal, number)) RIJournalAddSegment(journal, number, false);
+        }
+    }
+    closedir(dir);
+    
+    qsort(journal->segments, journal->segmentCount, sizeof(RIJournalSegment),
+          RIJournalCompareSegments);
+    
+    if (!RIJournalCreateSegment(journal, lastNumber + 1)) {
+        pthread_mutex_unlock(&RIJournalOpenJournalsMutex);
+        RIJournalClose(journal);
+        return NULL;
+    }
+    
+    journal->next = RIJournalOpenJournals;
+    RIJournalOpenJournals = journal;
+    pthread_mutex_unlock(&RIJournalOpenJournalsMutex);
+    
+    return journal;
+}
+
+void RIJournalClose(RIJournal *journal)
+{
+    if (!journal) return;
+    
+    pthread_mutex_lock(&RIJournalOpenJournalsMutex);
+    for (RIJournal **link = &RIJournalOpenJournals; *link; link = &(*link)->next) {
+        if (*link == journal) {
+            *link = journal->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&RIJournalOpenJournalsMutex);
+    
+    RIJournalUnmapCurrentSegment(journal);
+    pthread_mutex_destroy(&journal->mutex);
+    free(journal->segments);
+    free(journal->directory);
+    free(journal);
+}
+
+uint64_t RIJournalAppend(RIJournal *journal, const void *payload, size_t length)
+{
+    pthread_mutex_lock(&journal->mutex);
+    uint64_t identifier = RIJournalWriteEntry(journal, RI_JOURNAL_ENTRY_DATA, 0, payload, length);
+    pthread_mutex_unlock(&journal->mutex);
+    return identifier;
+}
+
+bool RIJournalAcknowledge(RIJournal *journal, uint64_t identifier)
+{
+    pthread_mutex_lock(&journal->mutex);
+    
+    bool written = 0 != RIJournalWriteEntry(journal, RI_JOURNAL_ENTRY_ACK, identifier, NULL, 0);
+    RIJournalSegment *segment = RIJournalFindSegment(journal, (uint32_t)(identifier >> 32));
+    
+    if (written && segment && segment->recovered && 0 < segment->unacknowledged) {
+        segment->unacknowledged--;
+        RIJournalPurgeSegments(journal);
+    }
+    
+    pthread_mutex_unlock(&journal->mutex);
+    return written;
+}
+
+size_t RIJournalRecover(RIJournal *journal, RIJournalEntryHandler handler, void *context)
+{
+    pthread_mutex_lock(&journal->mutex);
+    size_t count = 0;
+    uint32_t *numbers = malloc((journal->segmentCount + 1) * sizeof(uint32_t));
+    for (size_t idx = 0; numbers && idx < journal->segmentCount; idx++) {
+        if (!journal->segments[idx].recovered) numbers[count++] = journal->segments[idx].number;
+    }
+    pthread_mutex_unlock(&journal->mutex);
+    
+    // Segments of previous processes are not written anymore, read them without holding the lock
+    RIJournalScan scan = {0};
+    unsigned char **mappings = calloc(count + 1, sizeof(unsigned char *));
+    size_t *sizes = calloc(count + 1, sizeof(size_t));
+    size_t *entryCounts = calloc(count + 1, sizeof(size_t));
+    char path[PATH_MAX];
+    
+    for (size_t idx = 0; mappings && sizes && entryCounts && idx < count; idx++) {
+        RIJournalSegmentPath(journal, numbers[idx], path);
+        int fd = open(path, O_RDONLY);
+        struct stat status;
+        if (fd < 0) continue;
+        if (0 == fstat(fd, &status) && 0 < status.st_size) {
+            void *mapping = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (MAP_FAILED != mapping) {
+                mappings[idx] = mapping;
+                sizes[idx] = (size_t)status.st_size;
+                size_t entryCount = scan.entryCount;
+                RIJournalScanSegment(&scan, mapping, sizes[idx]);
+                entryCounts[idx] = scan.entryCount - entryCount;
+            }
+        }
+        close(fd);
+    }
+    
+    qsort(scan.acknowledgements, scan.acknowledgementCount, sizeof(uint64_t),
+          RIJournalCompareIdentifiers);
+    
+    // Drop acknowledged entries and count the ones left per segment
+    size_t recovered = 0;
+    size_t entryIndex = 0;
+    
+    pthread_mutex_lock(&journal->mutex);
+    for (size_t idx = 0; entryCounts && idx < count; idx++) {
+        size_t unacknowledged = 0;
+        for (size_t end = entryIndex + entryCounts[idx]; entryIndex < end; entryIndex++) {
+            uint64_t identifier = scan.entries[entryIndex]->identifier;
+            if (!bsearch(&identifier, scan.acknowledgements, scan.acknowledgementCount,
+                         sizeof(uint64_t), RIJournalCompareIdentifiers)) {
+                scan.entries[recovered++] = scan.entries[entryIndex];
+                unacknowledged++;
+            }
+        }
+        RIJournalSegment *segment = RIJournalFindSegment(journal, numbers[idx]);
+        if (segment) {
+            segment->unacknowledged = unacknowledged;
+            segment->recovered = true;
+        }
+    }
+    RIJournalPurgeSegments(journal);
+    pthread_mutex_unlock(&journal->mutex);
+    
+    for (size_t idx = 0; idx < recovered; idx++) {
+        const RIJournalEntryHeader *header = scan.entries[idx];
+        handler(header->identifier, header + 1, header->size - sizeof(RIJournalEntryHeader), context);
+    }
+    
+    for (size_t idx = 0; mappings && idx < count; idx++) {
+        if (mappings[idx]) munmap(mappings[idx], sizes[idx]);
+    }
+    free(scan.entries);
+    free(scan.acknowledgements);
+    free(entryCounts);
+    free(sizes);
+    free(mappings);
+    free(numbers);
+    
+    return recovered;
+}
+
+bool RIJournalSync(RIJournal *journal)
+{
+    pthread_mutex_lock(&journal->mutex);
+    bool synced = journal->mapping && 0 == msync(journal->mapping, journal->offset, MS_SYNC);
+    pthread_mutex_unlock(&journal->mutex);
+    return synced;
+}
@@ -0,0 +1,108 @@
+//
+//  RIJournal.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#ifndef RITracking_RIJournal_h
+#define RITracking_RIJournal_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ *  Append-only journal of opaque entries, kept in memory-mapped segment files of a directory.
+ *
+ *  Each entry is checked by a CRC, so a write torn by the process dying is detected and ends the
+ *  segment on recovery. Entries are identified by their segment number and offset. Once all entries
+ *  of the oldest segments are acknowledged, these segments are deleted.
+ *
+ *  A journal opens a fresh segment for appending. Segments left from a previous process are only
+ *  read when recovering, so opening stays cheap. Segments of another journal still open on the same
+ *  directory in this process stay with that journal and are neither recovered nor deleted.
+ */
+typedef struct RIJournal RIJournal;
+
+/**
+ *  Handler called for each unacknowledged entry on recovery
+ *
+ *  @param identifier The entry's identifier, to acknowledge it once processed.
+ *  @param payload The entry's payload.
+ *  @param length The length in bytes of the payload.
+ *  @param context The context passed on recovery.
+ */
+typedef void (*RIJournalEntryHandler)(uint64_t identifier,
+                                      const void *payload,
+                                      size_t length,
+                                      void *context);
+
+/**
+ *  Open a journal in a directory
+ *
+ *  @param directory Path of an existing directory holding the segment files.
+ *  @param segmentSize Size in bytes of a segment file.
+ *
+ *  @return The journal opened, or NULL in case of error
+ */
+RIJournal *RIJournalOpen(const char *directory, size_t segmentSize);
+
+/**
+ *  Close a journal, keeping its segment files
+ *
+ *  @param journal The journal to close.
+ */
+void RIJournalClose(RIJournal *journal);
+
+/**
+ *  Append an entry. May be called from any thread.
+ *
+ *  @param journal The journal.
+ *  @param payload The payload to copy into the entry.
+ *  @param length The length in bytes of the payload.
+ *
+ *  @return The entry's identifier, or zero in case of error
+ */
+uint64_t RIJournalAppend(RIJournal *journal, const void *payload, size_t length);
+
+/**
+ *  Acknowledge an entry to be processed, so it is not recovered again. May be called from any
+ *  thread, but only once per entry.
+ *
+ *  @param journal The journal.
+ *  @param identifier The entry's identifier.
+ *
+ *  @return True in case of success, false in case of error
+ */
+bool RIJournalAcknowledge(RIJournal *journal, uint64_t identifier);
+
+/**
+ *  Call a handler for each unacknowledged entry left from a previous process, in order of
+ *  appending. Must be called at most once per journal. The handler may append and acknowledge.
+ *
+ *  @param journal The journal.
+ *  @param handler The handler to call.
+ *  @param context A context passed to the handler.
+ *
+ *  @return The number of entries recovered
+ */
+size_t RIJournalRecover(RIJournal *journal, RIJournalEntryHandler handler, void *context);
+
+/**
+ *  Flush the segment appended to on storage, to survive a system crash as well
+ *
+ *  @param journal The journal.
+ *
+ *  @return True in case of success, false in case of error
+ */
+bool RIJournalSync(RIJournal *journal);
+
+/**
+ *  Hook called on appending, once an entry is written except for the size that makes it visible.
+ *  Only set by tests, to stop a process partway through writing an entry.
+ */
+extern void (*RIJournalEntryWillPublishHook)(void);
+
+#endif
@@ -0,0 +1,123 @@
+//
+//  RILog.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Log levels as plain numbers, to be compared by the preprocessor
+ */
+#define RI_LOG_LEVEL_OFF 0
+#define RI_LOG_LEVEL_ERROR 1
+#define RI_LOG_LEVEL_WARNING 2
+#define RI_LOG_LEVEL_INFO 3
+#define RI_LOG_LEVEL_DEBUG 4
+
+/**
+ *  The most verbose level compiled in. Log calls of more verbose levels are removed at compile
+ *  time, including the evaluation of their arguments. Defaults to debug for debug builds and to
+ *  warning otherwise.
+ */
+#ifndef RI_LOG_COMPILED_LEVEL
+#ifdef DEBUG
+#define RI_LOG_COMPILED_LEVEL RI_LOG_LEVEL_DEBUG
+#else
+#define RI_LOG_COMPILED_LEVEL RI_LOG_LEVEL_WARNING
+#endif
+#endif
+
+/**
+ *  Levels of log records, from the least to the most verbose
+ */
+typedef NS_ENUM(NSUInteger, RILogLevel) {
+    RILogLevelOff = RI_LOG_LEVEL_OFF,
+    RILogLevelError = RI_LOG_LEVEL_ERROR,
+    RILogLevelWarning = RI_LOG_LEVEL_WARNING,
+    RILogLevelInfo = RI_LOG_LEVEL_INFO,
+    RILogLevelDebug = RI_LOG_LEVEL_DEBUG
+};
+
+/**
+ *  The most verbose level logged at runtime, read without locking
+ */
+extern RILogLevel RILogCurrentLevel;
+
+/**
+ *  Log a message if its level is compiled in and enabled at runtime. Both levels are checked before
+ *  any argument is evaluated or the message is formatted.
+ *
+ *  Formatted records are copied into a lock-free ring buffer and written by a background writer.
+ *  Errors and warnings from the same call site are rate-limited, see RILogWrite.
+ */
+#define RILog(lvl, fmt, ...) \
+do { \
+    if ((lvl) <= RI_LOG_COMPILED_LEVEL && \
+        (lvl) <= __atomic_load_n(&RILogCurrentLevel, __ATOMIC_RELAXED)) { \
+        RILogWrite((lvl), __PRETTY_FUNCTION__, __LINE__, (fmt), ##__VA_ARGS__); \
+    } \
+} while (0)
+
+#define RIDebugLog(fmt, ...) RILog(RILogLevelDebug, (fmt), ##__VA_ARGS__)
+
+#ifdef DEBUG
+#define RIRaiseError(fmt, ...) \
+do { \
+    NSAssert(NO, (fmt), ##__VA_ARGS__); \
+    RILog(RILogLevelError, (fmt), ##__VA_ARGS__); \
+} while (0)
+#else
+#define RIRaiseError(fmt, ...) RILog(RILogLevelError, (fmt), ##__VA_ARGS__)
+#endif
+
+/**
+ *  Format a log record and hand it to the background writer. Use RILog instead, which checks the
+ *  level before calling.
+ *
+ *  Errors and warnings logged from a call site within a second after the last record written from
+ *  that call site are only counted, without formatting them. The next record written from the call
+ *  site tells the number of records suppressed.
+ *
+ *  @param level The level of the record.
+ *  @param function The name of the logging function.
+ *  @param line The line of the call site.
+ *  @param format The message format.
+ */
+void RILogWrite(RILogLevel level, const char *function, int line, NSString *format, ...)
+NS_FORMAT_FUNCTION(4, 5);
+
+/**
+ *  Set the most verbose level logged at runtime
+ *
+ *  @param level The level.
+ */
+void RILogSetLevel(RILogLevel level);
+
+/**
+ *  Set the handler the background writer passes formatted records to. Defaults to NSLog.
+ *
+ *  @param handler The handler, nil to restore the default.
+ */
+void RILogSetHandler(void (^handler)(RILogLevel level, NSString *message));
+
+/**
+ *  Wait for the background writer to write all records logged so far
+ */
+void RILogFlush(void);
+
+/**
+ *  The number of records dropped because the ring buffer was full
+ *
+ *  @return The count
+ */
+uint64_t RILogDroppedCount(void);
+
+/**
+ *  The number of errors and warnings suppressed by rate limiting
+ *
+ *  @return The count
+ */
+uint64_t RILogSuppressedCount(void);
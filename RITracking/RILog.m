@@ -0,0 +1,215 @@
+//
+//  RILog.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RILog.h"
+#import "RIEventRing.h"
+
+/**
+ *  Number of records the ring buffer holds
+ */
+#define RI_LOG_CAPACITY 256
+
+/**
+ *  Number of bytes of a formatted message kept, longer messages are truncated
+ */
+#define RI_LOG_MESSAGE_SIZE 232
+
+/**
+ *  Number of call sites tracked for rate limiting, colliding call sites share a slot
+ */
+#define RI_LOG_RATE_LIMIT_SLOTS 64
+
+/**
+ *  Time window in which repeated errors and warnings from the same call site are suppressed
+ */
+static CFTimeInterval const kRILogRateLimitInterval = 1.0;
+
+typedef struct RILogRecord {
+    RILogLevel level;
+    const char *function;
+    int line;
+    uint32_t suppressedCount;
+    char message[RI_LOG_MESSAGE_SIZE];
+} RILogRecord;
+
+typedef struct RILogRateLimit {
+    uintptr_t site;
+    uint64_t windowStart;
+    uint32_t suppressedCount;
+} RILogRateLimit;
+
+typedef void(^RILogHandler)(RILogLevel, NSString *);
+
+RILogLevel RILogCurrentLevel = RILogLevelWarning;
+
+static RIEventRing *RILogRing;
+static dispatch_queue_t RILogWriterQueue;
+static dispatch_once_t RILogOnce;
+static int RILogScheduled;
+static uint64_t RILogDropped;
+static uint64_t RILogSuppressed;
+static RILogRateLimit RILogRateLimits[RI_LOG_RATE_LIMIT_SLOTS];
+static RILogHandler RILogCurrentHandler;
+
+static void RILogSetUp(void)
+{
+    dispatch_once(&RILogOnce, ^{
+        RILogRing = RIEventRingCreate(RI_LOG_CAPACITY, sizeof(RILogRecord));
+        RILogWriterQueue = dispatch_queue_create("de.rocket-internet.RITracking.log",
+                                                 DISPATCH_QUEUE_SERIAL);
+    });
+}
+
+/**
+ *  Tell whether a record from a call site is to be written, counting it as suppressed otherwise
+ */
+static BOOL RILogAdmit(const char *function, int line, uint32_t *suppressedCount)
+{
+    uintptr_t site = (uintptr_t)function ^ ((uintptr_t)line << 16);
+    RILogRateLimit *limit = &RILogRateLimits[(site ^ (site >> 7)) % RI_LOG_RATE_LIMIT_SLOTS];
+    uint64_t now = (uint64_t)(CFAbsoluteTimeGetCurrent() * 1000);
+    uint64_t interval = (uint64_t)(kRILogRateLimitInterval * 1000);
+    
+    if (__atomic_load_n(&limit->site, __ATOMIC_RELAXED) != site) {
+        // A new call site takes over the slot, counts of the former one are lost
+        __atomic_store_n(&limit->site, site, __ATOMIC_RELAXED);
+        __atomic_store_n(&limit->windowStart, now, __ATOMIC_RELAXED);
+        __atomic_store_n(&limit->suppressedCount, 0, __ATOMIC_RELAXED);
+        *suppressedCount = 0;
+        return YES;
+    }
+    
+    uint64_t windowStart = __atomic_load_n(&limit->windowStart, __ATOMIC_RELAXED);
+    
+    if (now - windowStart < interval ||
+        !__atomic_compare_exchange_n(&limit->windowStart, &windowStart, now, NO,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&limit->suppressedCount, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&RILogSuppressed, 1, __ATOMIC_RELAXED);
+        return NO;
+    }
+    
+    *suppressedCount = __atomic_exchange_n(&limit->suppressedCount, 0, __ATOMIC_RELAXED);
+    return YES;
+}
+
+static void RILogWriteRecord(const RILogRecord *record)
+{
+    NSString *message = [[NSString alloc] initWithUTF8String:record->message] ?: @"";
+    
+    if (RILogLevelWarning >= record->level) {
+        message = [NSString stringWithFormat:@"Func: %s, Line: %d, %@", record->function, record->line,
+                   message];
+    } else {
+        message = [@"RITracking: " stringByAppendingString:message];
+    }
+    
+    if (record->suppressedCount) {
+        message = [message stringByAppendingFormat:@" (%u similar records suppressed)",
+                   record->suppressedCount];
+    }
+    
+    RILogHandler handler = RILogCurrentHandler;
+    
+    if (handler) {
+        handler(record->level, message);
+    } else {
+        NSLog(@"%@", message);
+    }
+}
+
+/**
+ *  Write all records of the ring buffer, called on the writer queue only
+ */
+static void RILogDrain(void *context)
+{
+    RILogRecord record;
+    
+    @autoreleasepool {
+        while (RIEventRingTryPop(RILogRing, &record)) {
+            RILogWriteRecord(&record);
+        }
+        
+        // Check again after unscheduling to not miss a record logged meanwhile
+        __atomic_store_n(&RILogScheduled, 0, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        
+        while (RIEventRingTryPop(RILogRing, &record)) {
+            RILogWriteRecord(&record);
+        }
+    }
+}
+
+void RILogWrite(RILogLevel level, const char *function, int line, NSString *format, ...)
+{
+    RILogRecord record;
+    record.suppressedCount = 0;
+    
+    if (RILogLevelWarning >= level && !RILogAdmit(function, line, &record.suppressedCount)) return;
+    
+    RILogSetUp();
+    
+    va_list arguments;
+    va_start(arguments, format);
+    NSString *message = [[NSString alloc] initWithFormat:format arguments:arguments];
+    va_end(arguments);
+    
+    record.level = level;
+    record.function = function;
+    record.line = line;
+    
+    NSUInteger length = 0;
+    [message getBytes:record.message
+            maxLength:RI_LOG_MESSAGE_SIZE - 1
+           usedLength:&length
+             encoding:NSUTF8StringEncoding
+              options:0
+                range:NSMakeRange(0, message.length)
+       remainingRange:NULL];
+    record.message[length] = '\0';
+    
+    if (!RIEventRingTryPush(RILogRing, &record)) {
+        __atomic_add_fetch(&RILogDropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    
+    // Only pay for scheduling the writer if it is not about to drain anyway
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!__atomic_exchange_n(&RILogScheduled, 1, __ATOMIC_SEQ_CST)) {
+        dispatch_async_f(RILogWriterQueue, NULL, RILogDrain);
+    }
+}
+
+void RILogSetLevel(RILogLevel level)
+{
+    __atomic_store_n(&RILogCurrentLevel, level, __ATOMIC_RELAXED);
+}
+
+void RILogSetHandler(void (^handler)(RILogLevel level, NSString *message))
+{
+    RILogSetUp();
+    dispatch_sync(RILogWriterQueue, ^{
+        RILogCurrentHandler = [handler copy];
+    });
+}
+
+void RILogFlush(void)
+{
+    RILogSetUp();
+    dispatch_sync_f(RILogWriterQueue, NULL, RILogDrain);
+}
+
+uint64_t RILogDroppedCount(void)
+{
+    return __atomic_load_n(&RILogDropped, __ATOMIC_RELAXED);
+}
+
+uint64_t RILogSuppressedCount(void)
+{
+    return __atomic_load_n(&RILogSuppressed, __ATOMIC_RELAXED);
+}
@@ -8,6 +8,9 @@
 
 #import <Foundation/Foundation.h>
 
+@class RIOpenURLPattern;
+@class RIOpenURLView;
+
 /**
  *  Convenience controller to wrap logic for particular deepling URL structures based on regular 
  *  expression match pattern
@@ -27,6 +30,22 @@
                                regex:(NSRegularExpression *)regex
                               macros:(NSArray *)macros;
 
+/**
+ *  Creat and initialize a `RIOpenURLHandler` object
+ *
+ *  @param handlerBlock A handler to be called on matching a deeplink URL.
+ *  @param pattern A compiled pattern to match.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithHandlerBlock:(void (^)(NSDictionary *))handlerBlock
+                             pattern:(RIOpenURLPattern *)pattern;
+
+/**
+ *  The compiled pattern, if the handler was created with one
+ */
+@property (readonly) RIOpenURLPattern *pattern;
+
 /**
  *  Handle an Open URL
  *
@@ -34,4 +53,38 @@
  */
 - (void)handleOpenURL:(NSURL *)url;
 
+/**
+ *  Match an Open URL against the regular expression of the handler
+ *
+ *  @param view The parsed URL to be matched
+ *
+ *  @return The captured strings in order of the macros, or nil if the URL does not match
+ */
+- (NSArray *)capturesForOpenURLView:(RIOpenURLView *)view;
+
+/**
+ *  Call the handler block for an Open URL already matched
+ *
+ *  @param view The parsed URL matched
+ *  @param captures The captured strings in order of the macros
+ */
+- (void)handleOpenURLView:(RIOpenURLView *)view captures:(NSArray *)captures;
+
+/**
+ *  Build the parameters passed to the handler block for an Open URL already matched
+ *
+ *  @param view The parsed URL matched
+ *  @param captures The captured strings in order of the macros
+ *
+ *  @return The captured properties merged with the query parameters
+ */
+- (NSDictionary *)parametersForOpenURLView:(RIOpenURLView *)view captures:(NSArray *)captures;
+
+/**
+ *  Call the handler block with parameters built before
+ *
+ *  @param parameters The parameters as built by `parametersForOpenURLView:captures:`
+ */
+- (void)handleParameters:(NSDictionary *)parameters;
+
 @end
@@ -7,6 +7,8 @@
 //
 
 #import "RIOpenURLHandler.h"
+#import "RIOpenURLPattern.h"
+#import "RIOpenURLView.h"
 
 typedef void(^RIOpenURLHandlerBlock)(NSDictionary *);
 
@@ -15,6 +17,7 @@ typedef void(^RIOpenURLHandlerBlock)(NSDictionary *);
 @property (copy) RIOpenURLHandlerBlock handlerBlock;
 @property NSArray *macros;
 @property NSRegularExpression *regex;
+@property (readwrite) RIOpenURLPattern *pattern;
 
 @end
 
@@ -32,27 +35,57 @@ typedef void(^RIOpenURLHandlerBlock)(NSDictionary *);
     return self;
 }
 
+- (instancetype)initWithHandlerBlock:(void (^)(NSDictionary *))handlerBlock
+                             pattern:(RIOpenURLPattern *)pattern
+{
+    if ((self = [self initWithHandlerBlock:handlerBlock regex:pattern.regex macros:pattern.macros])) {
+        self.pattern = pattern;
+    }
+    return self;
+}
+
 - (void)handleOpenURL:(NSURL *)url
 {
-    NSArray *matches = [self.regex matchesInString:url.absoluteString
-                                           options:0
-                                             range:NSMakeRange(0, url.absoluteString.length)];
-    if (0 == matches.count) return;
-    NSMutableDictionary *params = [NSMutableDictionary dictionary];
-    NSTextCheckingResult *match = matches[0];
+    RIOpenURLView *view = [[RIOpenURLView alloc] initWithURL:url];
+    NSArray *captures = [self capturesForOpenURLView:view];
+    if (!captures) return;
+    [self handleOpenURLView:view captures:captures];
+}
+
+- (NSArray *)capturesForOpenURLView:(RIOpenURLView *)view
+{
+    NSString *string = view.string;
+    NSTextCheckingResult *match = [self.regex firstMatchInString:string
+                                                         options:0
+                                                           range:NSMakeRange(0, string.length)];
+    if (!match) return nil;
+    NSMutableArray *captures = [NSMutableArray arrayWithCapacity:match.numberOfRanges-1];
     // Loop through groups captured in match. Skip first, this is the whole tested string.
     for (NSUInteger idx = 0; idx < match.numberOfRanges-1; idx++) {
         NSRange range = [match rangeAtIndex:idx+1];
-        params[self.macros[idx]] = [url.absoluteString substringWithRange:range];
+        [captures addObject:(NSNotFound == range.location ? @"" : [string substringWithRange:range])];
     }
-    
-    for (NSString *param in [url.query componentsSeparatedByString:@"&"]) {
-        NSArray *pair = [param componentsSeparatedByString:@"="];
-        if ([pair count] < 2) continue;
-        [params setObject:[pair objectAtIndex:1] forKey:[pair objectAtIndex:0]];
+    return captures;
+}
+
+- (void)handleOpenURLView:(RIOpenURLView *)view captures:(NSArray *)captures
+{
+    [self handleParameters:[self parametersForOpenURLView:view captures:captures]];
+}
+
+- (NSDictionary *)parametersForOpenURLView:(RIOpenURLView *)view captures:(NSArray *)captures
+{
+    NSMutableDictionary *params = [NSMutableDictionary dictionary];
+    for (NSUInteger idx = 0; idx < captures.count && idx < self.macros.count; idx++) {
+        params[self.macros[idx]] = captures[idx];
     }
-    
-    self.handlerBlock(params);
+    [params addEntriesFromDictionary:view.queryParameters];
+    return [params copy];
+}
+
+- (void)handleParameters:(NSDictionary *)parameters
+{
+    self.handlerBlock(parameters);
 }
 
 @end
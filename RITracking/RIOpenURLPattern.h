@@ -0,0 +1,49 @@
+//
+//  RIOpenURLPattern.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Compiled deeplink URL pattern, that is a regex extended with capture directives of the format
+ *  `{<name>}`, each of which captures any characters as property '<name>'
+ */
+@interface RIOpenURLPattern : NSObject
+
+/**
+ *  The pattern as registered
+ */
+@property (readonly) NSString *pattern;
+
+/**
+ *  Names of the capture directives, in order of their capture groups
+ */
+@property (readonly) NSArray *macros;
+
+/**
+ *  The regular expression with capture directives replaced by capture groups
+ */
+@property (readonly) NSRegularExpression *regex;
+
+/**
+ *  The literal scheme, authority and path segments every URL matched by the regular expression
+ *  starts with. Empty unless the pattern is anchored with `^`, as an unanchored regular expression
+ *  may match anywhere in the URL. Captures and segments with regular expression syntax end them.
+ */
+@property (readonly) NSArray *components;
+
+/**
+ *  Compile a pattern in a single pass over its characters
+ *
+ *  @param pattern A pattern of regex extended with capture directive syntax.
+ *  @param error Set to the error in case the resulting regular expression is invalid.
+ *
+ *  @return The compiled pattern, or nil in case of error
+ */
++ (instancetype)patternWithString:(NSString *)pattern error:(NSError **)error;
+
+@end
@@ -0,0 +1,160 @@
+//
+//  RIOpenURLPattern.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIOpenURLPattern.h"
+
+static NSString * const kRIOpenURLPatternCaptureGroup = @"(.*)";
+static NSString * const kRIOpenURLPatternSchemeSeparator = @"://";
+
+/**
+ *  Unescape a literal pattern component, returning nil if it contains regular expression syntax
+ */
+static NSString *RIOpenURLPatternLiteral(NSString *component)
+{
+    static NSCharacterSet *metaCharacters;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        metaCharacters = [NSCharacterSet characterSetWithCharactersInString:@".^$*+?()[]{}|"];
+    });
+    
+    NSMutableString *literal = [NSMutableString stringWithCapacity:component.length];
+    NSUInteger length = component.length;
+    
+    for (NSUInteger idx = 0; idx < length; idx++) {
+        unichar character = [component characterAtIndex:idx];
+        
+        if ('\\' == character) {
+            if (++idx == length) return nil;
+            character = [component characterAtIndex:idx];
+            // Escaped letters and digits are character classes or back references
+            if ([[NSCharacterSet alphanumericCharacterSet] characterIsMember:character]) return nil;
+        } else if ([metaCharacters characterIsMember:character]) {
+            return nil;
+        }
+        
+        [literal appendFormat:@"%C", character];
+    }
+    
+    return literal;
+}
+
+/**
+ *  Find the literal components every URL matched by an anchored regular expression starts with.
+ *  A segment only counts if an unquantified '/' follows it, as it may be part of a longer segment
+ *  otherwise, and must not contain characters ending URL components.
+ */
+static NSArray *RIOpenURLPatternComponents(NSString *regexPattern)
+{
+    NSMutableArray *components = [NSMutableArray array];
+    
+    // An alternative of the whole expression may match anywhere
+    if (![regexPattern hasPrefix:@"^"] || [regexPattern rangeOfString:@"|"].location != NSNotFound) {
+        return components;
+    }
+    
+    NSString *pattern = [regexPattern substringFromIndex:1];
+    NSRange separator = [pattern rangeOfString:kRIOpenURLPatternSchemeSeparator];
+    if (NSNotFound == separator.location || 0 == separator.location) return components;
+    
+    NSString *path = [pattern substringFromIndex:NSMaxRange(separator)];
+    NSMutableArray *parts = [NSMutableArray arrayWithObject:[pattern substringToIndex:separator.location]];
+    [parts addObjectsFromArray:[path componentsSeparatedByString:@"/"]];
+    
+    static NSCharacterSet *quantifiers;
+    static NSCharacterSet *delimiters;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        quantifiers = [NSCharacterSet characterSetWithCharactersInString:@"?*+{"];
+        delimiters = [NSCharacterSet characterSetWithCharactersInString:@":/?#"];
+    });
+    
+    // The separator follows the scheme, a '/' any other segment
+    for (NSUInteger idx = 0; idx + 1 < parts.count; idx++) {
+        NSString *part = parts[idx];
+        NSString *next = parts[idx+1];
+        
+        // Empty path segments are skipped when splitting URLs as well
+        if (idx > 1 && 0 == part.length) continue;
+        
+        NSString *literal = RIOpenURLPatternLiteral(part);
+        if (!literal || [literal rangeOfCharacterFromSet:delimiters].location != NSNotFound) break;
+        if (next.length > 0 && [quantifiers characterIsMember:[next characterAtIndex:0]]) break;
+        
+        [components addObject:literal];
+    }
+    
+    return components;
+}
+
+@interface RIOpenURLPattern ()
+
+@property (readwrite) NSString *pattern;
+@property (readwrite) NSArray *macros;
+@property (readwrite) NSRegularExpression *regex;
+@property (readwrite) NSArray *components;
+
+@end
+
+@implementation RIOpenURLPattern
+
++ (instancetype)patternWithString:(NSString *)pattern error:(NSError **)error
+{
+    NSUInteger length = pattern.length;
+    unichar *characters = malloc(MAX(length, 1) * sizeof(unichar));
+    [pattern getCharacters:characters range:NSMakeRange(0, length)];
+    
+    NSMutableString *regexPattern = [NSMutableString stringWithCapacity:length];
+    NSMutableArray *macros = [NSMutableArray array];
+    NSUInteger literalStart = 0;
+    NSUInteger idx = 0;
+    
+    while (idx < length) {
+        if ('{' != characters[idx]) {
+            idx++;
+            continue;
+        }
+        
+        NSUInteger end = idx + 1;
+        while (end < length && '}' != characters[end]) end++;
+        
+        // Without any closing brace left, the rest of the pattern is literal
+        if (end == length) break;
+        
+        // Empty braces are no capture directive
+        if (end == idx + 1) {
+            idx = end + 1;
+            continue;
+        }
+        
+        [regexPattern appendString:[pattern substringWithRange:NSMakeRange(literalStart,
+                                                                           idx - literalStart)]];
+        [regexPattern appendString:kRIOpenURLPatternCaptureGroup];
+        [macros addObject:[pattern substringWithRange:NSMakeRange(idx + 1, end - idx - 1)]];
+        
+        idx = end + 1;
+        literalStart = idx;
+    }
+    
+    [regexPattern appendString:[pattern substringFromIndex:literalStart]];
+    free(characters);
+    
+    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:regexPattern
+                                                                           options:0
+                                                                             error:error];
+    
+    if (!regex) return nil;
+    
+    RIOpenURLPattern *compiledPattern = [[RIOpenURLPattern alloc] init];
+    compiledPattern.pattern = pattern;
+    compiledPattern.macros = [macros copy];
+    compiledPattern.regex = regex;
+    compiledPattern.components = RIOpenURLPatternComponents(regexPattern);
+    return compiledPattern;
+}
+
+@end
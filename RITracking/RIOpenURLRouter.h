@@ -0,0 +1,76 @@
+//
+//  RIOpenURLRouter.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class RIOpenURLHandler;
+@class RIOpenURLView;
+
+/**
+ *  Routing engine matching a deeplink URL against all registered handlers in one pass.
+ *
+ *  Handlers are compiled into a trie by the literal scheme, authority and path segments their
+ *  pattern starts with, if it is anchored with `^`. Only the handlers along the path of a URL's
+ *  components are tried, unanchored handlers for every URL. Each of them matches and captures by
+ *  its regular expression, exactly as if matched on its own. Matching handlers are called in order
+ *  of registration.
+ *
+ *  The matched handlers and their parameters are kept in a bounded least recently used cache keyed
+ *  by the absolute URL string, which is cleared whenever the route table changes.
+ */
+@interface RIOpenURLRouter : NSObject
+
+/**
+ *  The number of URLs the match cache holds. Zero disables the cache. Defaults to 64.
+ */
+@property (nonatomic) NSUInteger cacheCapacity;
+
+/**
+ *  The number of URLs handled from the match cache
+ */
+@property (readonly) NSUInteger cacheHitCount;
+
+/**
+ *  The number of URLs matched against the route table
+ */
+@property (readonly) NSUInteger cacheMissCount;
+
+/**
+ *  The number of URLs evicted from the full match cache
+ */
+@property (readonly) NSUInteger cacheEvictionCount;
+
+/**
+ *  Add a handler to the route table
+ *
+ *  @param handler The handler to add.
+ */
+- (void)addHandler:(RIOpenURLHandler *)handler;
+
+/**
+ *  Add handlers to the route table at once
+ *
+ *  @param handlers An array of `RIOpenURLHandler` objects.
+ */
+- (void)addHandlers:(NSArray *)handlers;
+
+/**
+ *  Call all handlers matching an Open URL
+ *
+ *  @param url The URL to be handled
+ */
+- (void)handleOpenURL:(NSURL *)url;
+
+/**
+ *  Call all handlers matching an Open URL already parsed
+ *
+ *  @param view The parsed URL to be handled
+ */
+- (void)handleOpenURLView:(RIOpenURLView *)view;
+
+@end
@@ -0,0 +1,264 @@
+//
+//  RIOpenURLRouter.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIOpenURLRouter.h"
+#import "RIOpenURLHandler.h"
+#import "RIOpenURLPattern.h"
+#import "RIOpenURLView.h"
+
+/**
+ *  Node of the route trie, one level per URL component
+ */
+@interface RIOpenURLRouterNode : NSObject
+
+@property (readonly) NSMutableDictionary *literals;
+@property (readonly) NSMutableArray *routes;
+
+@end
+
+@implementation RIOpenURLRouterNode
+
+- (instancetype)init
+{
+    if ((self = [super init])) {
+        _literals = [NSMutableDictionary dictionary];
+        _routes = [NSMutableArray array];
+    }
+    return self;
+}
+
+@end
+
+/**
+ *  A handler together with its position in the route table
+ */
+@interface RIOpenURLRoute : NSObject
+
+@property RIOpenURLHandler *handler;
+@property NSUInteger index;
+
+@end
+
+@implementation RIOpenURLRoute
+
+@end
+
+/**
+ *  A route matched by a URL together with the strings captured
+ */
+@interface RIOpenURLRouteMatch : NSObject
+
+@property RIOpenURLRoute *route;
+@property NSArray *captures;
+@property NSDictionary *parameters;
+
+@end
+
+@implementation RIOpenURLRouteMatch
+
+@end
+
+/**
+ *  Entry of the match cache, linked in order of use
+ */
+@interface RIOpenURLCacheEntry : NSObject
+
+@property NSString *key;
+@property NSArray *matches;
+@property RIOpenURLCacheEntry *next;
+@property (weak) RIOpenURLCacheEntry *previous;
+
+@end
+
+@implementation RIOpenURLCacheEntry
+
+@end
+
+@interface RIOpenURLRouter ()
+
+@property RIOpenURLRouterNode *root;
+@property NSUInteger count;
+@property NSMutableDictionary *cache;
+@property RIOpenURLCacheEntry *mostRecentlyUsed;
+@property (weak) RIOpenURLCacheEntry *leastRecentlyUsed;
+@property (readwrite) NSUInteger cacheHitCount;
+@property (readwrite) NSUInteger cacheMissCount;
+@property (readwrite) NSUInteger cacheEvictionCount;
+
+@end
+
+@implementation RIOpenURLRouter
+
+- (instancetype)init
+{
+    if ((self = [super init])) {
+        self.root = [[RIOpenURLRouterNode alloc] init];
+        self.cache = [NSMutableDictionary dictionary];
+        _cacheCapacity = 64;
+    }
+    return self;
+}
+
+- (void)setCacheCapacity:(NSUInteger)cacheCapacity
+{
+    @synchronized(self) {
+        _cacheCapacity = cacheCapacity;
+        while (self.cache.count > cacheCapacity) [self evictLeastRecentlyUsed];
+    }
+}
+
+- (void)addHandler:(RIOpenURLHandler *)handler
+{
+    [self addHandlers:@[handler]];
+}
+
+- (void)addHandlers:(NSArray *)handlers
+{
+    @synchronized(self) {
+        for (RIOpenURLHandler *handler in handlers) {
+            RIOpenURLRoute *route = [[RIOpenURLRoute alloc] init];
+            route.handler = handler;
+            route.index = self.count++;
+            
+            // Handlers without literal components, such as unanchored ones, are tried for any URL
+            RIOpenURLRouterNode *node = self.root;
+            for (NSString *component in handler.pattern.components) {
+                RIOpenURLRouterNode *child = node.literals[component];
+                if (!child) node.literals[component] = child = [[RIOpenURLRouterNode alloc] init];
+                node = child;
+            }
+            [node.routes addObject:route];
+        }
+        
+        // Cached matches may miss the routes just added
+        [self.cache removeAllObjects];
+        self.mostRecentlyUsed = nil;
+        self.leastRecentlyUsed = nil;
+    }
+}
+
+- (void)handleOpenURL:(NSURL *)url
+{
+    [self handleOpenURLView:[[RIOpenURLView alloc] initWithURL:url]];
+}
+
+- (void)handleOpenURLView:(RIOpenURLView *)view
+{
+    NSArray *matches;
+    
+    @synchronized(self) {
+        RIOpenURLCacheEntry *entry = self.cache[view.string];
+        if (entry) {
+            self.cacheHitCount++;
+            [self unlinkEntry:entry];
+            [self linkEntry:entry];
+            matches = entry.matches;
+        } else {
+            self.cacheMissCount++;
+            matches = [self matchesForOpenURLView:view];
+            [self cacheMatches:matches forKey:view.string];
+        }
+    }
+    
+    // Handlers are called outside the lock as they may register further handlers
+    for (RIOpenURLRouteMatch *match in matches) {
+        [match.route.handler handleParameters:match.parameters];
+    }
+}
+
+- (NSArray *)matchesForOpenURLView:(RIOpenURLView *)view
+{
+    NSMutableArray *matches = [NSMutableArray array];
+    
+    // The trie only narrows down the candidates, their regular expressions decide and capture
+    for (RIOpenURLRoute *route in [self candidateRoutesForComponents:view.components]) {
+        NSArray *captures = [route.handler capturesForOpenURLView:view];
+        if (!captures) continue;
+        RIOpenURLRouteMatch *match = [[RIOpenURLRouteMatch alloc] init];
+        match.route = route;
+        match.captures = captures;
+        [matches addObject:match];
+    }
+    
+    [matches sortUsingComparator:^NSComparisonResult(RIOpenURLRouteMatch *a, RIOpenURLRouteMatch *b) {
+        if (a.route.index == b.route.index) return NSOrderedSame;
+        return a.route.index < b.route.index ? NSOrderedAscending : NSOrderedDescending;
+    }];
+    
+    for (RIOpenURLRouteMatch *match in matches) {
+        match.parameters = [match.route.handler parametersForOpenURLView:view captures:match.captures];
+    }
+    
+    return matches;
+}
+
+#pragma mark - Match cache
+
+- (void)cacheMatches:(NSArray *)matches forKey:(NSString *)key
+{
+    if (0 == self.cacheCapacity) return;
+    
+    if (self.cache.count == self.cacheCapacity) [self evictLeastRecentlyUsed];
+    
+    RIOpenURLCacheEntry *entry = [[RIOpenURLCacheEntry alloc] init];
+    entry.key = key;
+    entry.matches = matches;
+    self.cache[key] = entry;
+    [self linkEntry:entry];
+}
+
+- (void)evictLeastRecentlyUsed
+{
+    RIOpenURLCacheEntry *entry = self.leastRecentlyUsed;
+    if (!entry) return;
+    [self unlinkEntry:entry];
+    [self.cache removeObjectForKey:entry.key];
+    self.cacheEvictionCount++;
+}
+
+- (void)linkEntry:(RIOpenURLCacheEntry *)entry
+{
+    entry.next = self.mostRecentlyUsed;
+    entry.previous = nil;
+    self.mostRecentlyUsed.previous = entry;
+    self.mostRecentlyUsed = entry;
+    if (!self.leastRecentlyUsed) self.leastRecentlyUsed = entry;
+}
+
+- (void)unlinkEntry:(RIOpenURLCacheEntry *)entry
+{
+    RIOpenURLCacheEntry *previous = entry.previous;
+    RIOpenURLCacheEntry *next = entry.next;
+    
+    if (previous) previous.next = next; else self.mostRecentlyUsed = next;
+    if (next) next.previous = previous; else self.leastRecentlyUsed = previous;
+    
+    entry.next = nil;
+    entry.previous = nil;
+}
+
+#pragma mark - Route trie
+
+/**
+ *  Collect the routes of all nodes along the path of the URL's leading components
+ */
+- (NSArray *)candidateRoutesForComponents:(NSArray *)components
+{
+    RIOpenURLRouterNode *node = self.root;
+    NSMutableArray *routes = [NSMutableArray arrayWithArray:node.routes];
+    
+    for (NSString *component in components) {
+        node = node.literals[component];
+        if (!node) break;
+        [routes addObjectsFromArray:node.routes];
+    }
+    
+    return routes;
+}
+
+@end
@@ -0,0 +1,49 @@
+//
+//  RIOpenURLView.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Immutable view of a deeplink URL parsed once and shared by all handlers matching it.
+ *
+ *  The URL string is split into component ranges on creation. Component strings and the decoded
+ *  query parameters are only created when first accessed.
+ */
+@interface RIOpenURLView : NSObject
+
+/**
+ *  Creat and initialize a `RIOpenURLView` object
+ *
+ *  @param url The URL to be viewed.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithURL:(NSURL *)url;
+
+/**
+ *  The URL viewed
+ */
+@property (readonly) NSURL *url;
+
+/**
+ *  The absolute string of the URL
+ */
+@property (readonly) NSString *string;
+
+/**
+ *  The scheme, authority and non-empty path segments of the URL, nil if the URL string has no
+ *  `scheme://` prefix
+ */
+@property (readonly) NSArray *components;
+
+/**
+ *  The key-value pairs of the query string with percent escapes removed
+ */
+@property (readonly) NSDictionary *queryParameters;
+
+@end
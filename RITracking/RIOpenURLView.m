@@ -0,0 +1,124 @@
+//
+//  RIOpenURLView.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIOpenURLView.h"
+
+@interface RIOpenURLView ()
+
+@property (readwrite) NSURL *url;
+@property (readwrite) NSString *string;
+
+@end
+
+@implementation RIOpenURLView
+{
+    NSRange *_componentRanges;
+    NSUInteger _componentCount;
+    NSRange _queryRange;
+    NSArray *_components;
+    NSDictionary *_queryParameters;
+}
+
+- (instancetype)initWithURL:(NSURL *)url
+{
+    if ((self = [super init])) {
+        self.url = url;
+        self.string = url.absoluteString ?: @"";
+        _queryRange = NSMakeRange(NSNotFound, 0);
+        [self scan];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_componentRanges);
+}
+
+/**
+ *  Find the ranges of scheme, authority, path segments and query in a single pass
+ */
+- (void)scan
+{
+    NSString *string = self.string;
+    NSUInteger length = string.length;
+    unichar *characters = malloc(MAX(length, 1) * sizeof(unichar));
+    [string getCharacters:characters range:NSMakeRange(0, length)];
+    
+    NSUInteger idx = 0;
+    while (idx < length && ':' != characters[idx] && '/' != characters[idx] &&
+           '?' != characters[idx] && '#' != characters[idx]) idx++;
+    
+    if (idx > 0 && idx + 2 < length && ':' == characters[idx] &&
+        '/' == characters[idx+1] && '/' == characters[idx+2]) {
+        // Scheme, authority and at most one range per remaining character
+        _componentRanges = malloc((length - idx + 2) * sizeof(NSRange));
+        _componentRanges[_componentCount++] = NSMakeRange(0, idx);
+        
+        NSUInteger start = idx + 3;
+        BOOL authority = YES;
+        for (idx = start; idx <= length; idx++) {
+            unichar character = idx < length ? characters[idx] : '#';
+            if ('/' != character && '?' != character && '#' != character) continue;
+            
+            if (authority || idx > start) {
+                _componentRanges[_componentCount++] = NSMakeRange(start, idx - start);
+            }
+            authority = NO;
+            start = idx + 1;
+            
+            if ('/' != character) break;
+        }
+    }
+    
+    // The query is located independent of the component structure
+    NSUInteger queryStart = NSNotFound;
+    for (idx = 0; idx < length && '#' != characters[idx]; idx++) {
+        if (NSNotFound == queryStart && '?' == characters[idx]) queryStart = idx + 1;
+    }
+    if (NSNotFound != queryStart) _queryRange = NSMakeRange(queryStart, idx - queryStart);
+    
+    free(characters);
+}
+
+- (NSArray *)components
+{
+    @synchronized(self) {
+        if (!_components && _componentRanges) {
+            NSMutableArray *components = [NSMutableArray arrayWithCapacity:_componentCount];
+            for (NSUInteger idx = 0; idx < _componentCount; idx++) {
+                [components addObject:[self.string substringWithRange:_componentRanges[idx]]];
+            }
+            _components = [components copy];
+        }
+        return _components;
+    }
+}
+
+- (NSDictionary *)queryParameters
+{
+    @synchronized(self) {
+        if (!_queryParameters) {
+            NSMutableDictionary *parameters = [NSMutableDictionary dictionary];
+            if (NSNotFound != _queryRange.location) {
+                NSString *query = [self.string substringWithRange:_queryRange];
+                for (NSString *param in [query componentsSeparatedByString:@"&"]) {
+                    NSArray *pair = [param componentsSeparatedByString:@"="];
+                    if ([pair count] < 2) continue;
+                    NSString *key = [pair[0] stringByRemovingPercentEncoding] ?: pair[0];
+                    NSString *value = [pair[1] stringByRemovingPercentEncoding] ?: pair[1];
+                    parameters[key] = value;
+                }
+            }
+            _queryParameters = [parameters copy];
+        }
+        return _queryParameters;
+    }
+}
+
+@end
@@ -0,0 +1,155 @@
+//
+//  RITrackerHealth.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  States of a tracker's circuit breaker
+ */
+typedef NS_ENUM(NSUInteger, RITrackerHealthState) {
+    /**
+     *  The tracker is healthy, calls are queued for it
+     */
+    RITrackerHealthStateClosed,
+    /**
+     *  The tracker failed or was slow too often, calls to it are rejected until the cooldown passed
+     */
+    RITrackerHealthStateOpen,
+    /**
+     *  The cooldown passed, a few probe calls are queued to find out if the tracker recovered
+     */
+    RITrackerHealthStateHalfOpen
+};
+
+/**
+ *  Report the tracking call the calling tracker is processing as failed. To be called by trackers
+ *  from a tracking method, e.g. next to raising an error, so the call counts against the tracker's
+ *  health. Does nothing outside of a tracking call.
+ */
+void RITrackerReportFailure(void);
+
+/**
+ *  Health monitor and circuit breaker of a tracker.
+ *
+ *  The tracker's queue reports the duration and outcome of each call processed. Calls failed or
+ *  slower than the slow call duration are counted over a window of calls, if their share reaches
+ *  the failure rate the circuit opens. A call taking longer than the wedge timeout opens the circuit
+ *  as well, while the call is still in progress.
+ *
+ *  While the circuit is open, calls are rejected as they are made. After the cooldown the circuit is
+ *  half-open and admits a number of probe calls: if all of them succeed the circuit closes, if one
+ *  fails it opens again. Probes not finished within the wedge timeout, e.g. shed after they were
+ *  queued, open the circuit again as well, so the tracker is probed anew after the next cooldown.
+ */
+@interface RITrackerHealth : NSObject
+
+/**
+ *  The name of the tracker monitored
+ */
+@property (readonly) NSString *trackerName;
+
+/**
+ *  The state of the circuit
+ */
+@property (readonly) RITrackerHealthState state;
+
+/**
+ *  The share of failed or slow calls in a window opening the circuit, defaults to 0.5
+ */
+@property double failureRate;
+
+/**
+ *  The duration in seconds from which a call counts as slow, defaults to 1
+ */
+@property NSTimeInterval slowCallDuration;
+
+/**
+ *  The duration in seconds of a call in progress from which the tracker counts as wedged, defaults
+ *  to 10
+ */
+@property NSTimeInterval wedgeTimeout;
+
+/**
+ *  The number of calls the failure rate is measured over, defaults to 20
+ */
+@property NSUInteger windowSize;
+
+/**
+ *  The time in seconds the circuit stays open before probing the tracker, defaults to 30
+ */
+@property NSTimeInterval cooldown;
+
+/**
+ *  The number of probe calls admitted while half-open, defaults to 3
+ */
+@property NSUInteger probeCount;
+
+/**
+ *  Called on any thread whenever the state of the circuit changes
+ */
+@property (copy) void (^stateChangeHandler)(RITrackerHealth *health, RITrackerHealthState state);
+
+/**
+ *  The number of calls processed
+ */
+@property (readonly) uint64_t callCount;
+
+/**
+ *  The number of calls reported as failed
+ */
+@property (readonly) uint64_t failureCount;
+
+/**
+ *  The number of calls slower than the slow call duration
+ */
+@property (readonly) uint64_t slowCallCount;
+
+/**
+ *  The number of calls rejected because the circuit was open
+ */
+@property (readonly) uint64_t rejectedCount;
+
+/**
+ *  The number of times the circuit opened
+ */
+@property (readonly) uint64_t tripCount;
+
+/**
+ *  Create and initialize a `RITrackerHealth` object
+ *
+ *  @param trackerName The name of the tracker monitored.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithTrackerName:(NSString *)trackerName;
+
+/**
+ *  Decide whether a call may be queued for the tracker. May be called from any thread.
+ *
+ *  @return True if the call is admitted, false if the circuit rejects it
+ */
+- (BOOL)admitCall;
+
+/**
+ *  Give back the admission of a call shed or spilled instead of being queued, so a probe slot it
+ *  took is free for the next call. May be called from any thread.
+ */
+- (void)cancelCall;
+
+/**
+ *  Mark the start of a call processed, on the tracker's queue
+ */
+- (void)beginCall;
+
+/**
+ *  Mark the end of the call begun last, on the tracker's queue, recording its duration and whether
+ *  the tracker reported it as failed
+ */
+- (void)endCall;
+
+@end
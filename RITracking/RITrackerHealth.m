@@ -0,0 +1,296 @@
+//
+//  RITrackerHealth.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RITrackerHealth.h"
+
+/**
+ *  Number of calls admitted between checks of a wedged tracker, sparing a clock read per call
+ */
+#define RI_TRACKER_HEALTH_WEDGE_CHECK_INTERVAL 32
+
+/**
+ *  Whether the tracking call in progress on the calling thread was reported as failed
+ */
+static __thread BOOL RITrackerHealthCallFailed;
+
+void RITrackerReportFailure(void)
+{
+    RITrackerHealthCallFailed = YES;
+}
+
+@interface RITrackerHealth ()
+{
+    NSUInteger _state;
+    CFAbsoluteTime _openedAt;
+    CFAbsoluteTime _halfOpenedAt;
+    CFAbsoluteTime _busySince;
+    uint64_t _admittedCount;
+    uint64_t _probesAdmitted;
+    NSUInteger _probesSucceeded;
+    
+    // Written by the tracker's queue only
+    NSUInteger _windowCallCount;
+    NSUInteger _windowFailureCount;
+    
+    uint64_t _callCount;
+    uint64_t _failureCount;
+    uint64_t _slowCallCount;
+    uint64_t _rejectedCount;
+    uint64_t _tripCount;
+}
+
+@property (readwrite) NSString *trackerName;
+
+@end
+
+@implementation RITrackerHealth
+
+- (instancetype)initWithTrackerName:(NSString *)trackerName
+{
+    if ((self = [super init])) {
+        self.trackerName = trackerName;
+        self.failureRate = 0.5;
+        self.slowCallDuration = 1;
+        self.wedgeTimeout = 10;
+        self.windowSize = 20;
+        self.cooldown = 30;
+        self.probeCount = 3;
+    }
+    return self;
+}
+
+- (RITrackerHealthState)state
+{
+    return __atomic_load_n(&_state, __ATOMIC_ACQUIRE);
+}
+
+- (uint64_t)callCount
+{
+    return __atomic_load_n(&_callCount, __ATOMIC_RELAXED);
+}
+
+- (uint64_t)failureCount
+{
+    return __atomic_load_n(&_failureCount, __ATOMIC_RELAXED);
+}
+
+- (uint64_t)slowCallCount
+{
+    return __atomic_load_n(&_slowCallCount, __ATOMIC_RELAXED);
+}
+
+- (uint64_t)rejectedCount
+{
+    return __atomic_load_n(&_rejectedCount, __ATOMIC_RELAXED);
+}
+
+- (uint64_t)tripCount
+{
+    return __atomic_load_n(&_tripCount, __ATOMIC_RELAXED);
+}
+
+#pragma mark - Admission
+
+- (BOOL)admitCall
+{
+    switch ([self state]) {
+        case RITrackerHealthStateClosed:
+            if (0 == __atomic_add_fetch(&_admittedCount, 1, __ATOMIC_RELAXED) %
+                RI_TRACKER_HEALTH_WEDGE_CHECK_INTERVAL && [self isWedged]) {
+                [self tripFromState:RITrackerHealthStateClosed];
+                break;
+            }
+            return YES;
+        case RITrackerHealthStateOpen:
+            if (![self probeAfterCooldown]) break;
+            // Fall through to admit the first probes
+        case RITrackerHealthStateHalfOpen:
+            // Probes queued behind a wedged call would never finish
+            if ([self isWedged]) {
+                [self tripFromState:RITrackerHealthStateHalfOpen];
+                break;
+            }
+            if (__atomic_add_fetch(&_probesAdmitted, 1, __ATOMIC_RELAXED) <= self.probeCount) return YES;
+            // Probes shed after they were queued never finish
+            if ([self probesLost]) [self tripFromState:RITrackerHealthStateHalfOpen];
+            break;
+    }
+    
+    __atomic_add_fetch(&_rejectedCount, 1, __ATOMIC_RELAXED);
+    return NO;
+}
+
+- (void)cancelCall
+{
+    if (RITrackerHealthStateHalfOpen != [self state]) return;
+    
+    uint64_t admitted = __atomic_load_n(&_probesAdmitted, __ATOMIC_RELAXED);
+    uint64_t held;
+    
+    do {
+        // Calls counted beyond the probe count were rejected and hold no probe slot
+        held = MIN(admitted, (uint64_t)self.probeCount);
+        if (0 == held) return;
+    } while (!__atomic_compare_exchange_n(&_probesAdmitted, &admitted, held - 1, YES,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/**
+ *  Whether the probes admitted did not finish within the wedge timeout since the circuit turned
+ *  half-open
+ */
+- (BOOL)probesLost
+{
+    CFAbsoluteTime halfOpenedAt;
+    __atomic_load(&_halfOpenedAt, &halfOpenedAt, __ATOMIC_ACQUIRE);
+    return self.wedgeTimeout < CFAbsoluteTimeGetCurrent() - halfOpenedAt;
+}
+
+/**
+ *  Whether the call in progress takes longer than the wedge timeout
+ */
+- (BOOL)isWedged
+{
+    CFAbsoluteTime busySince;
+    __atomic_load(&_busySince, &busySince, __ATOMIC_RELAXED);
+    return 0 < busySince && self.wedgeTimeout < CFAbsoluteTimeGetCurrent() - busySince;
+}
+
+/**
+ *  Turn the open circuit half-open once the cooldown passed
+ *
+ *  @return True if the circuit is half-open
+ */
+- (BOOL)probeAfterCooldown
+{
+    CFAbsoluteTime openedAt;
+    __atomic_load(&_openedAt, &openedAt, __ATOMIC_ACQUIRE);
+    
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    
+    if (now - openedAt < self.cooldown) return NO;
+    
+    NSUInteger expected = RITrackerHealthStateOpen;
+    // Stored before the state changes, callers seeing the circuit half-open read the time it did
+    __atomic_store(&_halfOpenedAt, &now, __ATOMIC_RELEASE);
+    
+    if (__atomic_compare_exchange_n(&_state, &expected, RITrackerHealthStateHalfOpen, NO,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        [self didChangeToState:RITrackerHealthStateHalfOpen];
+        return YES;
+    }
+    
+    // Another caller probed first, or the state changed meanwhile
+    return RITrackerHealthStateHalfOpen == expected;
+}
+
+#pragma mark - Calls
+
+- (void)beginCall
+{
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    __atomic_store(&_busySince, &now, __ATOMIC_RELAXED);
+    RITrackerHealthCallFailed = NO;
+}
+
+- (void)endCall
+{
+    CFAbsoluteTime busySince;
+    __atomic_load(&_busySince, &busySince, __ATOMIC_RELAXED);
+    CFAbsoluteTime idle = 0;
+    __atomic_store(&_busySince, &idle, __ATOMIC_RELAXED);
+    
+    BOOL failed = RITrackerHealthCallFailed;
+    BOOL slow = self.slowCallDuration <= CFAbsoluteTimeGetCurrent() - busySince;
+    RITrackerHealthCallFailed = NO;
+    
+    __atomic_add_fetch(&_callCount, 1, __ATOMIC_RELAXED);
+    if (failed) __atomic_add_fetch(&_failureCount, 1, __ATOMIC_RELAXED);
+    if (slow) __atomic_add_fetch(&_slowCallCount, 1, __ATOMIC_RELAXED);
+    
+    switch ([self state]) {
+        case RITrackerHealthStateClosed:
+            [self recordCallFailed:failed || slow];
+            break;
+        case RITrackerHealthStateHalfOpen:
+            if (failed || slow) {
+                [self tripFromState:RITrackerHealthStateHalfOpen];
+            } else if (__atomic_add_fetch(&_probesSucceeded, 1, __ATOMIC_RELAXED) >= self.probeCount) {
+                [self close];
+            }
+            break;
+        case RITrackerHealthStateOpen:
+            // Calls admitted before the circuit opened do not count
+            break;
+    }
+}
+
+/**
+ *  Count a call in the window, opening the circuit if the window ends with too many failures
+ */
+- (void)recordCallFailed:(BOOL)failed
+{
+    NSUInteger windowSize = MAX(1, self.windowSize);
+    
+    _windowCallCount++;
+    if (failed) _windowFailureCount++;
+    
+    if (_windowCallCount < windowSize) return;
+    
+    BOOL trip = _windowFailureCount >= self.failureRate * windowSize;
+    _windowCallCount = 0;
+    _windowFailureCount = 0;
+    
+    if (trip) [self tripFromState:RITrackerHealthStateClosed];
+}
+
+#pragma mark - State changes
+
+- (void)tripFromState:(RITrackerHealthState)state
+{
+    NSUInteger expected = state;
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    __atomic_store(&_openedAt, &now, __ATOMIC_RELEASE);
+    
+    if (!__atomic_compare_exchange_n(&_state, &expected, RITrackerHealthStateOpen, NO,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    
+    // Reset by the caller opening the circuit only, probes are not admitted before the cooldown
+    __atomic_store_n(&_probesAdmitted, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_probesSucceeded, 0, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&_tripCount, 1, __ATOMIC_RELAXED);
+    RILog(RILogLevelWarning, @"Opening circuit of tracker %@ for %.0f seconds",
+          self.trackerName, self.cooldown);
+    [self didChangeToState:RITrackerHealthStateOpen];
+}
+
+- (void)close
+{
+    NSUInteger expected = RITrackerHealthStateHalfOpen;
+    
+    if (!__atomic_compare_exchange_n(&_state, &expected, RITrackerHealthStateClosed, NO,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    
+    _windowCallCount = 0;
+    _windowFailureCount = 0;
+    RILog(RILogLevelWarning, @"Closing circuit of recovered tracker %@", self.trackerName);
+    [self didChangeToState:RITrackerHealthStateClosed];
+}
+
+- (void)didChangeToState:(RITrackerHealthState)state
+{
+    void (^handler)(RITrackerHealth *, RITrackerHealthState) = self.stateChangeHandler;
+    
+    if (handler) handler(self, state);
+}
+
+@end
@@ -0,0 +1,242 @@
+//
+//  RITrackerMetrics.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Switch for the per-tracker instrumentation. Defined to 0 the instrumentation and its snapshot
+ *  API are removed at compile time. Defaults to 1.
+ */
+#ifndef RI_TRACKER_METRICS
+#define RI_TRACKER_METRICS 1
+#endif
+
+#if RI_TRACKER_METRICS
+
+#ifdef __APPLE__
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+/**
+ *  Number of linear sub-buckets per power of two of a latency histogram, bounding the relative error
+ *  of a recorded value to 1/16
+ */
+#define RI_LATENCY_HISTOGRAM_SUB_BUCKETS 16
+
+/**
+ *  Number of buckets of a latency histogram, covering values below 2^40 clock ticks
+ */
+#define RI_LATENCY_HISTOGRAM_BUCKETS ((40 - 4 + 1) * RI_LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+/**
+ *  HDR-style histogram of latencies in clock ticks: buckets are linear below 16 ticks, above each
+ *  power of two is split into 16 buckets. It is written by a single thread and may be read from any.
+ */
+typedef struct RILatencyHistogram {
+    uint64_t counts[RI_LATENCY_HISTOGRAM_BUCKETS];
+    uint64_t count;
+    uint64_t total;
+    uint64_t maximum;
+} RILatencyHistogram;
+
+/**
+ *  Live instrumentation of a tracker's inbox. Depth is changed by any thread adding to the inbox,
+ *  everything else is written by the tracker's queue only.
+ */
+typedef struct RITrackerMetrics {
+    int64_t depth;
+    int64_t peakDepth;
+    uint64_t processedCount;
+    uint64_t droppedCount;
+    RILatencyHistogram waitLatency;
+    RILatencyHistogram serviceLatency;
+} RITrackerMetrics;
+
+/**
+ *  The current time in clock ticks, as recorded by the instrumentation
+ */
+static inline uint64_t RITrackerMetricsNow(void)
+{
+#ifdef __APPLE__
+    return mach_absolute_time();
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+#endif
+}
+
+static inline void RILatencyHistogramRecord(RILatencyHistogram *histogram, uint64_t value)
+{
+    uint32_t index;
+    
+    if (value < RI_LATENCY_HISTOGRAM_SUB_BUCKETS) {
+        index = (uint32_t)value;
+    } else {
+        uint32_t exponent = 63 - (uint32_t)__builtin_clzll(value);
+        if (39 < exponent) {
+            value = (1ull << 40) - 1;
+            exponent = 39;
+        }
+        uint32_t shift = exponent - 4;
+        index = (shift + 1) * RI_LATENCY_HISTOGRAM_SUB_BUCKETS +
+                (uint32_t)((value >> shift) & (RI_LATENCY_HISTOGRAM_SUB_BUCKETS - 1));
+    }
+    
+    // A single writer, relaxed stores only keep readers from seeing torn values
+    __atomic_store_n(&histogram->counts[index], histogram->counts[index] + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->count, histogram->count + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->total, histogram->total + value, __ATOMIC_RELAXED);
+    if (value > histogram->maximum) {
+        __atomic_store_n(&histogram->maximum, value, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ *  Count an entry added to the inbox, from any thread
+ */
+static inline void RITrackerMetricsRecordEnqueue(RITrackerMetrics *metrics)
+{
+    int64_t depth = __atomic_add_fetch(&metrics->depth, 1, __ATOMIC_RELAXED);
+    int64_t peakDepth = __atomic_load_n(&metrics->peakDepth, __ATOMIC_RELAXED);
+    
+    while (depth > peakDepth &&
+           !__atomic_compare_exchange_n(&metrics->peakDepth, &peakDepth, depth, YES,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/**
+ *  Count an entry processed by the tracker, from the tracker's queue only
+ *
+ *  @param enqueueTime The time the entry was added.
+ *  @param startTime The time the tracker started processing the entry.
+ *  @param finishTime The time the tracker finished processing the entry.
+ */
+static inline void RITrackerMetricsRecordProcessed(RITrackerMetrics *metrics,
+                                                   uint64_t enqueueTime,
+                                                   uint64_t startTime,
+                                                   uint64_t finishTime)
+{
+    __atomic_sub_fetch(&metrics->depth, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&metrics->processedCount, metrics->processedCount + 1, __ATOMIC_RELAXED);
+    RILatencyHistogramRecord(&metrics->waitLatency, startTime > enqueueTime ? startTime - enqueueTime : 0);
+    RILatencyHistogramRecord(&metrics->serviceLatency, finishTime - startTime);
+}
+
+/**
+ *  Count an entry dropped without being processed, from any thread
+ */
+static inline void RITrackerMetricsRecordDropped(RITrackerMetrics *metrics)
+{
+    __atomic_sub_fetch(&metrics->depth, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&metrics->droppedCount, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ *  Count an entry dropped before it was added to the inbox, from any thread
+ */
+static inline void RITrackerMetricsRecordRejected(RITrackerMetrics *metrics)
+{
+    __atomic_add_fetch(&metrics->droppedCount, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ *  Immutable snapshot of a latency histogram, values in nanoseconds
+ */
+@interface RILatencyHistogramSnapshot : NSObject
+
+/**
+ *  The number of latencies recorded
+ */
+@property (readonly) uint64_t count;
+
+/**
+ *  The mean latency
+ */
+@property (readonly) double mean;
+
+/**
+ *  The highest latency recorded
+ */
+@property (readonly) uint64_t maximum;
+
+/**
+ *  Create and initialize a `RILatencyHistogramSnapshot` object
+ *
+ *  @param histogram The live histogram to copy.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithHistogram:(const RILatencyHistogram *)histogram;
+
+/**
+ *  The latency below which a percentage of the recorded latencies lie, within 1/16 of the value
+ *
+ *  @param percentile The percentage, between 0 and 100.
+ *
+ *  @return The latency, 0 if none was recorded
+ */
+- (uint64_t)valueAtPercentile:(double)percentile;
+
+@end
+
+/**
+ *  Immutable snapshot of the instrumentation of a tracker
+ */
+@interface RITrackerMetricsSnapshot : NSObject
+
+/**
+ *  The class name of the tracker
+ */
+@property (readonly) NSString *trackerName;
+
+/**
+ *  The number of tracking calls and operations waiting in the tracker's inbox
+ */
+@property (readonly) NSUInteger queueDepth;
+
+/**
+ *  The highest number of tracking calls and operations that waited in the tracker's inbox
+ */
+@property (readonly) NSUInteger peakQueueDepth;
+
+/**
+ *  The number of tracking calls and operations processed by the tracker
+ */
+@property (readonly) uint64_t processedCount;
+
+/**
+ *  The number of tracking calls and operations dropped before the tracker processed them
+ */
+@property (readonly) uint64_t droppedCount;
+
+/**
+ *  Latencies from adding to the inbox until the tracker started processing
+ */
+@property (readonly) RILatencyHistogramSnapshot *waitLatency;
+
+/**
+ *  Latencies from the tracker starting until finishing processing
+ */
+@property (readonly) RILatencyHistogramSnapshot *serviceLatency;
+
+/**
+ *  Create and initialize a `RITrackerMetricsSnapshot` object
+ *
+ *  @param metrics The live instrumentation to copy.
+ *  @param trackerName The class name of the tracker.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithMetrics:(const RITrackerMetrics *)metrics trackerName:(NSString *)trackerName;
+
+@end
+
+#endif
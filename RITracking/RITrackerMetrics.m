@@ -0,0 +1,138 @@
+//
+//  RITrackerMetrics.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RITrackerMetrics.h"
+
+#if RI_TRACKER_METRICS
+
+/**
+ *  Nanoseconds per clock tick
+ */
+static double RITrackerMetricsNanosecondsPerTick(void)
+{
+#ifdef __APPLE__
+    static double nanosecondsPerTick;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        mach_timebase_info_data_t timebase;
+        mach_timebase_info(&timebase);
+        nanosecondsPerTick = (double)timebase.numer / timebase.denom;
+    });
+    return nanosecondsPerTick;
+#else
+    return 1;
+#endif
+}
+
+/**
+ *  The value in the middle of a histogram bucket, in clock ticks
+ */
+static uint64_t RILatencyHistogramBucketValue(uint32_t index)
+{
+    if (index < RI_LATENCY_HISTOGRAM_SUB_BUCKETS) return index;
+    
+    uint32_t shift = index / RI_LATENCY_HISTOGRAM_SUB_BUCKETS - 1;
+    uint64_t lowest = (uint64_t)(RI_LATENCY_HISTOGRAM_SUB_BUCKETS + index % RI_LATENCY_HISTOGRAM_SUB_BUCKETS) << shift;
+    return lowest + ((1ull << shift) >> 1);
+}
+
+@interface RILatencyHistogramSnapshot ()
+{
+    uint64_t _counts[RI_LATENCY_HISTOGRAM_BUCKETS];
+}
+
+@property (readwrite) uint64_t count;
+@property (readwrite) double mean;
+@property (readwrite) uint64_t maximum;
+
+@end
+
+@implementation RILatencyHistogramSnapshot
+
+- (instancetype)initWithHistogram:(const RILatencyHistogram *)histogram
+{
+    if ((self = [super init])) {
+        double nanosecondsPerTick = RITrackerMetricsNanosecondsPerTick();
+        uint64_t count = 0;
+        
+        // Counted from the buckets, so percentiles stay consistent while the writer goes on
+        for (uint32_t idx = 0; idx < RI_LATENCY_HISTOGRAM_BUCKETS; idx++) {
+            _counts[idx] = __atomic_load_n(&histogram->counts[idx], __ATOMIC_RELAXED);
+            count += _counts[idx];
+        }
+        
+        uint64_t total = __atomic_load_n(&histogram->total, __ATOMIC_RELAXED);
+        uint64_t recorded = __atomic_load_n(&histogram->count, __ATOMIC_RELAXED);
+        
+        self.count = count;
+        self.mean = recorded ? total * nanosecondsPerTick / recorded : 0;
+        self.maximum = (uint64_t)(__atomic_load_n(&histogram->maximum, __ATOMIC_RELAXED) * nanosecondsPerTick);
+    }
+    return self;
+}
+
+- (uint64_t)valueAtPercentile:(double)percentile
+{
+    if (0 == self.count) return 0;
+    
+    uint64_t rank = (uint64_t)ceil(MIN(MAX(percentile, 0), 100) / 100 * self.count);
+    uint64_t seen = 0;
+    
+    for (uint32_t idx = 0; idx < RI_LATENCY_HISTOGRAM_BUCKETS; idx++) {
+        seen += _counts[idx];
+        if (seen >= MAX(rank, 1)) {
+            return (uint64_t)(RILatencyHistogramBucketValue(idx) * RITrackerMetricsNanosecondsPerTick());
+        }
+    }
+    
+    return self.maximum;
+}
+
+@end
+
+@interface RITrackerMetricsSnapshot ()
+
+@property (readwrite) NSString *trackerName;
+@property (readwrite) NSUInteger queueDepth;
+@property (readwrite) NSUInteger peakQueueDepth;
+@property (readwrite) uint64_t processedCount;
+@property (readwrite) uint64_t droppedCount;
+@property (readwrite) RILatencyHistogramSnapshot *waitLatency;
+@property (readwrite) RILatencyHistogramSnapshot *serviceLatency;
+
+@end
+
+@implementation RITrackerMetricsSnapshot
+
+- (instancetype)initWithMetrics:(const RITrackerMetrics *)metrics trackerName:(NSString *)trackerName
+{
+    if ((self = [super init])) {
+        self.trackerName = trackerName;
+        self.queueDepth = (NSUInteger)MAX(0, __atomic_load_n(&metrics->depth, __ATOMIC_RELAXED));
+        self.peakQueueDepth = (NSUInteger)__atomic_load_n(&metrics->peakDepth, __ATOMIC_RELAXED);
+        self.processedCount = __atomic_load_n(&metrics->processedCount, __ATOMIC_RELAXED);
+        self.droppedCount = __atomic_load_n(&metrics->droppedCount, __ATOMIC_RELAXED);
+        self.waitLatency = [[RILatencyHistogramSnapshot alloc] initWithHistogram:&metrics->waitLatency];
+        self.serviceLatency = [[RILatencyHistogramSnapshot alloc] initWithHistogram:&metrics->serviceLatency];
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %@ depth=%lu peak=%lu processed=%llu dropped=%llu "
+            @"wait p50=%lluns p99=%lluns service p50=%lluns p99=%lluns>",
+            NSStringFromClass(self.class), self.trackerName, (unsigned long)self.queueDepth,
+            (unsigned long)self.peakQueueDepth, self.processedCount, self.droppedCount,
+            [self.waitLatency valueAtPercentile:50], [self.waitLatency valueAtPercentile:99],
+            [self.serviceLatency valueAtPercentile:50], [self.serviceLatency valueAtPercentile:99]];
+}
+
+@end
+
+#endif
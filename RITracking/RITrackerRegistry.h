@@ -0,0 +1,50 @@
+//
+//  RITrackerRegistry.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@protocol RITracker;
+
+/**
+ *  Registry of the trackers available to RITracking.
+ *
+ *  Tracker classes register a factory together with the configuration keys they need, typically from
+ *  their `+load` method. On start, only trackers whose keys are all present in the configuration are
+ *  created. A tracker registered with name '<name>' is also left out if the configuration sets the
+ *  key '<name>Enabled' to NO. Trackers left out are never allocated.
+ */
+@interface RITrackerRegistry : NSObject
+
+/**
+ *  Register a tracker
+ *
+ *  @param name The name of the tracker, prefix of its enabling configuration key.
+ *  @param keys The configuration keys the tracker needs.
+ *  @param factory A block creating the tracker.
+ */
++ (void)registerTrackerNamed:(NSString *)name
+   requiredConfigurationKeys:(NSArray *)keys
+                     factory:(id<RITracker> (^)(void))factory;
+
+/**
+ *  Create the trackers enabled by the current configuration, in order of registration
+ *
+ *  @return An array of trackers
+ */
++ (NSArray *)trackersEnabledByConfiguration;
+
+/**
+ *  Check whether the current configuration enables a registered tracker
+ *
+ *  @param name The name of the tracker.
+ *
+ *  @return True if registered, its keys are present and it is not disabled
+ */
++ (BOOL)isTrackerEnabled:(NSString *)name;
+
+@end
@@ -0,0 +1,96 @@
+//
+//  RITrackerRegistry.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RITrackerRegistry.h"
+#import "RITracking.h"
+
+/**
+ *  A registered tracker factory
+ */
+@interface RITrackerRegistration : NSObject
+
+@property NSString *name;
+@property NSArray *keys;
+@property (copy) id<RITracker> (^factory)(void);
+
+@end
+
+@implementation RITrackerRegistration
+
+@end
+
+@implementation RITrackerRegistry
+
+static NSMutableArray *registrations;
+
++ (void)registerTrackerNamed:(NSString *)name
+   requiredConfigurationKeys:(NSArray *)keys
+                     factory:(id<RITracker> (^)(void))factory
+{
+    RITrackerRegistration *registration = [[RITrackerRegistration alloc] init];
+    registration.name = name;
+    registration.keys = [keys copy];
+    registration.factory = factory;
+    
+    @synchronized(self) {
+        if (!registrations) registrations = [NSMutableArray array];
+        
+        // Registering a name again replaces the factory
+        NSUInteger idx = [registrations indexOfObjectPassingTest:^BOOL(RITrackerRegistration *obj,
+                                                                       NSUInteger idx, BOOL *stop) {
+            return [obj.name isEqualToString:name];
+        }];
+        if (NSNotFound == idx) {
+            [registrations addObject:registration];
+        } else {
+            registrations[idx] = registration;
+        }
+    }
+}
+
++ (NSArray *)trackersEnabledByConfiguration
+{
+    NSArray *candidates;
+    @synchronized(self) {
+        candidates = [registrations copy];
+    }
+    
+    NSMutableArray *trackers = [NSMutableArray arrayWithCapacity:candidates.count];
+    for (RITrackerRegistration *registration in candidates) {
+        if (![self isRegistrationEnabled:registration]) continue;
+        id<RITracker> tracker = registration.factory();
+        if (tracker) [trackers addObject:tracker];
+    }
+    return [trackers copy];
+}
+
++ (BOOL)isTrackerEnabled:(NSString *)name
+{
+    RITrackerRegistration *registration;
+    @synchronized(self) {
+        for (RITrackerRegistration *candidate in registrations) {
+            if ([candidate.name isEqualToString:name]) registration = candidate;
+        }
+    }
+    return registration && [self isRegistrationEnabled:registration];
+}
+
++ (BOOL)isRegistrationEnabled:(RITrackerRegistration *)registration
+{
+    id enabled = [RITrackingConfiguration valueForKey:[registration.name stringByAppendingString:@"Enabled"]];
+    if ([enabled isKindOfClass:[NSNumber class]] && ![enabled boolValue]) return NO;
+    
+    for (NSString *key in registration.keys) {
+        id value = [RITrackingConfiguration valueForKey:key];
+        if (!value) return NO;
+        if ([value isKindOfClass:[NSString class]] && 0 == [value length]) return NO;
+    }
+    return YES;
+}
+
+@end
@@ -6,27 +6,245 @@
 //  Copyright (c) 2014 Martin Biermann. All rights reserved.
 //
 
-#ifdef DEBUG
-#define RIRaiseError(fmt, ...) \
-NSAssert(NO, @"%@", [NSString stringWithFormat:(fmt), ##__VA_ARGS__]); \
-NSLog((@"Func: %s, Line: %d, %@"), __PRETTY_FUNCTION__, __LINE__, \
-[NSString stringWithFormat:(fmt), ##__VA_ARGS__]);
-#else
-#define RIRaiseError(fmt, ...) \
-NSLog((@"Func: %s, Line: %d, %@"), __PRETTY_FUNCTION__, __LINE__, \
-[NSString stringWithFormat:(fmt), ##__VA_ARGS__]);
-#endif
-
-#ifdef DEBUG
-#define RIDebugLog(fmt, ...) \
-if ([RITracking sharedInstance].debug) NSLog(@"RITracking: %@",[NSString stringWithFormat:(fmt), ##__VA_ARGS__]);
-#else
-#define RIDebugLog(fmt, ...) return;
-#endif
-
 #import <Foundation/Foundation.h>
+#import "RILog.h"
+#import "RITrackerMetrics.h"
+#import "RITrackerHealth.h"
 #import "RITrackingConfiguration.h"
 
+/**
+ *  Configuration key for the time window in seconds to gather tracked events before they are handed
+ *  to the trackers as one batch. Batching is disabled if the key is missing or zero.
+ */
+extern NSString * const kRITrackingEventBatchInterval;
+
+/**
+ *  Configuration key for the maximum number of events gathered in a batch before it is handed to the
+ *  trackers ahead of the batch time window.
+ */
+extern NSString * const kRITrackingEventBatchMaxCount;
+
+/**
+ *  Configuration key for the pipeline passing tracking calls to the trackers. If set to
+ *  kRITrackingPipelineModeRing, calls are pushed into a bounded lock-free ring buffer and handed to
+ *  the trackers by a single drain thread instead of each tracker's operation queue.
+ */
+extern NSString * const kRITrackingPipelineMode;
+
+/**
+ *  Pipeline mode value for the lock-free ring buffer pipeline
+ */
+extern NSString * const kRITrackingPipelineModeRing;
+
+/**
+ *  Configuration key for the number of tracking calls the ring buffer pipeline holds. Calls made
+ *  while it is full are dropped. Defaults to 4096.
+ */
+extern NSString * const kRITrackingPipelineCapacity;
+
+/**
+ *  Configuration key to run the trackers as serial lanes of a shared executor with a worker thread
+ *  per processor core, instead of on each tracker's operation queue. Calls to a tracker stay in
+ *  order. Trackers must not rely on being called on their queue then.
+ */
+extern NSString * const kRITrackingSharedExecutorEnabled;
+
+/**
+ *  Configuration key to enable journaling of tracking calls. Journaled calls not processed by all
+ *  trackers, e.g. because the app got killed, are replayed in the background on the next start.
+ */
+extern NSString * const kRITrackingJournalEnabled;
+
+/**
+ *  Configuration key for the size in bytes of a journal segment file. Defaults to 1 MiB.
+ */
+extern NSString * const kRITrackingJournalSegmentSize;
+
+/**
+ *  Configuration key for the number of deeplink URLs whose matched handlers and parameters are
+ *  cached. Zero disables the cache. Defaults to 64.
+ */
+extern NSString * const kRITrackingOpenURLCacheCapacity;
+
+/**
+ *  Configuration key for the number of event, action, category and screen names interned as
+ *  compact identifiers for the lifetime of the process. Names beyond are carried as strings.
+ *  Defaults to 4096.
+ */
+extern NSString * const kRITrackingVocabularyCapacity;
+
+/**
+ *  Configuration key for the number of bytes the tracking calls queued for all trackers may hold.
+ *  Calls a tracker's queue has no room for are handled by the tracker's overflow policy. Defaults to
+ *  no limit.
+ */
+extern NSString * const kRITrackingQueueByteBudget;
+
+/**
+ *  Configuration key for the overflow policies of the trackers, a dictionary from the tracker's
+ *  class name to one of the kRITrackingQueuePolicy constants. Defaults to
+ *  kRITrackingQueuePolicyDropNewest.
+ */
+extern NSString * const kRITrackingQueuePolicies;
+
+/**
+ *  Overflow policy shedding the tracking call the queue has no room for
+ */
+extern NSString * const kRITrackingQueuePolicyDropNewest;
+
+/**
+ *  Overflow policy shedding the oldest tracking calls queued to make room
+ */
+extern NSString * const kRITrackingQueuePolicyDropOldest;
+
+/**
+ *  Overflow policy blocking the caller until there is room, for at most the block timeout
+ */
+extern NSString * const kRITrackingQueuePolicyBlock;
+
+/**
+ *  Overflow policy spilling the tracking calls the queue has no room for to disk
+ */
+extern NSString * const kRITrackingQueuePolicySpill;
+
+/**
+ *  Configuration key for the longest time in seconds a caller is blocked by a full queue with
+ *  kRITrackingQueuePolicyBlock. Defaults to 0.1.
+ */
+extern NSString * const kRITrackingQueueBlockTimeout;
+
+/**
+ *  Configuration key for the share of failed or slow calls of a tracker opening its circuit, so
+ *  calls to the tracker are rejected for a cooldown. Defaults to 0.5.
+ */
+extern NSString * const kRITrackingCircuitFailureRate;
+
+/**
+ *  Configuration key for the number of calls the failure rate of a tracker is measured over.
+ *  Defaults to 20.
+ */
+extern NSString * const kRITrackingCircuitWindowSize;
+
+/**
+ *  Configuration key for the duration in seconds from which a call counts as slow. Defaults to 1.
+ */
+extern NSString * const kRITrackingCircuitSlowCallDuration;
+
+/**
+ *  Configuration key for the duration in seconds of a call in progress from which a tracker counts
+ *  as wedged, opening its circuit. Defaults to 10.
+ */
+extern NSString * const kRITrackingCircuitWedgeTimeout;
+
+/**
+ *  Configuration key for the time in seconds a circuit stays open before the tracker is probed.
+ *  Defaults to 30.
+ */
+extern NSString * const kRITrackingCircuitCooldown;
+
+/**
+ *  Configuration key for the priorities of the tracking calls, a dictionary from one of the
+ *  kRITrackingCallType constants to one of the kRITrackingPriority constants. Calls of a higher
+ *  priority overtake calls of a lower priority queued for a tracker, but never starve them.
+ *  Exceptions and e-commerce calls default to kRITrackingPriorityCritical, other calls to
+ *  kRITrackingPriorityNormal. Not applied by the ring buffer pipeline.
+ */
+extern NSString * const kRITrackingPriorities;
+
+/**
+ *  Configuration key for the priorities of events by name, a dictionary from the event name to one
+ *  of the kRITrackingPriority constants, overriding the priority of kRITrackingCallTypeEvent
+ */
+extern NSString * const kRITrackingEventPriorities;
+
+/**
+ *  Call type of events
+ */
+extern NSString * const kRITrackingCallTypeEvent;
+
+/**
+ *  Call type of screen views
+ */
+extern NSString * const kRITrackingCallTypeScreen;
+
+/**
+ *  Call type of exceptions
+ */
+extern NSString * const kRITrackingCallTypeException;
+
+/**
+ *  Call type of deeplink URLs opened
+ */
+extern NSString * const kRITrackingCallTypeOpenURL;
+
+/**
+ *  Call type of e-commerce calls, covering checkouts and cart changes alike to keep them in order
+ */
+extern NSString * const kRITrackingCallTypeEcommerce;
+
+/**
+ *  Priority of calls delivered ahead of anything else queued
+ */
+extern NSString * const kRITrackingPriorityCritical;
+
+/**
+ *  Priority of calls delivered ahead of bulk calls
+ */
+extern NSString * const kRITrackingPriorityNormal;
+
+/**
+ *  Priority of calls delivered once nothing more urgent is queued
+ */
+extern NSString * const kRITrackingPriorityBulk;
+
+/**
+ *  Start phase of loading the configuration
+ */
+extern NSString * const kRITrackingStartPhaseConfiguration;
+
+/**
+ *  Start phase of creating the trackers and their dispatch tables
+ */
+extern NSString * const kRITrackingStartPhaseTrackers;
+
+/**
+ *  Start phase of setting up journal, pipeline and batching, and enqueueing the launch hooks
+ */
+extern NSString * const kRITrackingStartPhasePipeline;
+
+/**
+ *  Start phase of replaying tracking calls made before initialisation completed
+ */
+extern NSString * const kRITrackingStartPhaseReplay;
+
+/**
+ *  Interface of the RITrackingEvent, that is a tracked event as handed to trackers in a batch
+ */
+@interface RITrackingEvent : NSObject
+
+/**
+ *  Name of the event
+ */
+@property NSString *event;
+/**
+ *  Value of the action
+ */
+@property NSNumber *value;
+/**
+ *  Identifier for the user action
+ */
+@property NSString *action;
+/**
+ *  Identifier for the category of the app the user is in
+ */
+@property NSString *category;
+/**
+ *  Additional data about the event
+ */
+@property NSDictionary *data;
+
+@end
+
 /**
  *  This protocol implements tracking to a given screen
  */
@@ -76,12 +294,22 @@ if ([RITracking sharedInstance].debug) NSLog(@"RITracking: %@",[NSString stringW
  *  is replaced with the actual property name to access the captured information.
  *  The handler block receives a dictionary hash containing key-value properties obtained from pattern
  *  capture directives and from the query string of the deeplink URL.
+ *  Patterns anchored with `^` are only tried on URLs starting with their literal segments.
  *
  *  @param handler A handler to be called on matching a deeplink URL.
  *  @param pattern A pattern of regex extended with capture directive syntax.
  */
 - (void)registerHandler:(void(^)(NSDictionary *))handler forOpenURLPattern:(NSString *)pattern;
 
+/**
+ *  Register a whole route table of handler blocks at once, compiling each pattern in a single pass.
+ *  Handlers matching the same deeplink URL are called in the order of the route table.
+ *
+ *  @param handlers An array of routes, each an array of a pattern of regex extended with capture
+ *                  directive syntax and the handler block to be called on matching it.
+ */
+- (void)registerHandlersForOpenURLPatterns:(NSArray *)handlers;
+
 @end
 
 /**
@@ -107,12 +335,24 @@ if ([RITracking sharedInstance].debug) NSLog(@"RITracking: %@",[NSString stringW
           category:(NSString *)category
               data:(NSDictionary *)data;
 
+@optional
+
+/**
+ *  Track a batch of events in one go.
+ *
+ *  Trackers not implementing this method receive a call of trackEvent:value:action:category:data:
+ *  for each event of the batch instead.
+ *
+ *  @param events An array of RITrackingEvent objects in the order they were tracked.
+ */
+- (void)trackEvents:(NSArray *)events;
+
 @end
 
 /**
  *  Interface of the RITrackingProduct, that is the product used for the commerce tracking
  */
-@interface RITrackingProduct : NSObject
+@interface RITrackingProduct : NSObject <NSCopying>
 
 /**
  *  Identifier of the product
@@ -194,7 +434,7 @@ if ([RITracking sharedInstance].debug) NSLog(@"RITracking: %@",[NSString stringW
  *  Track a product that was removed from the cart
  *
  *  @param idTrans The transaction ID
- *  @param quantity The quantity removed from the cart
+ *  @param quantity The quantity removed from the cart, nil to remove the product altogether
  */
 - (void)trackRemoveFromCartForProductWithID:(NSString *)idTransaction quantity:(NSNumber *)quantity;
 
@@ -217,6 +457,15 @@ if ([RITracking sharedInstance].debug) NSLog(@"RITracking: %@",[NSString stringW
  */
 - (void)applicationDidLaunchWithOptions:(NSDictionary *)options;
 
+@optional
+
+/**
+ *  Hook to recognise a configuration reload, called on the tracker's queue
+ *
+ *  @param keys The set of configuration keys whose values changed.
+ */
+- (void)configurationDidChangeKeys:(NSSet *)keys;
+
 @end
 
 /**
@@ -227,14 +476,79 @@ if ([RITracking sharedInstance].debug) NSLog(@"RITracking: %@",[NSString stringW
     RIEventTracking,
     RIScreenTracking,
     RIExceptionTracking,
-    RIOpenURLTracking
+    RIOpenURLTracking,
+    RIEcommerceEventTracking
 >
 
 /**
- *  A flag to enable debug logging.
+ *  A flag to enable debug logging, setting the runtime log level to debug or back to warning.
  */
 @property (nonatomic) BOOL debug;
 
+/**
+ *  The number of tracking calls dropped because more calls were made before initialisation
+ *  completed than could be held for replay, or because initialisation failed. The oldest calls are
+ *  dropped first.
+ */
+@property (readonly) NSUInteger preStartDroppedCount;
+
+/**
+ *  The number of deeplink URLs handled from the cache of matched handlers
+ */
+@property (readonly) NSUInteger openURLCacheHitCount;
+
+/**
+ *  The number of deeplink URLs matched against the registered handlers
+ */
+@property (readonly) NSUInteger openURLCacheMissCount;
+
+/**
+ *  The number of deeplink URLs evicted from the full cache of matched handlers
+ */
+@property (readonly) NSUInteger openURLCacheEvictionCount;
+
+/**
+ *  Called on any thread whenever the circuit of a tracker changes its state
+ */
+@property (copy) void (^trackerHealthHandler)(RITrackerHealth *health, RITrackerHealthState state);
+
+/**
+ *  The health monitors of the trackers, in the order of the trackers, telling the state of each
+ *  tracker's circuit and the counts of its calls failed, slow and rejected
+ *
+ *  @return The monitors, of class RITrackerHealth
+ */
+- (NSArray *)trackerHealthMonitors;
+
+/**
+ *  The number of tracking calls shed because the queue byte budget was full, summed over the
+ *  trackers
+ *
+ *  @return Dictionary from the type of call (event, screen, exception, openURL, launch,
+ *  operation for batched events and e-commerce calls) to the count
+ */
+- (NSDictionary *)shedEventCounts;
+
+/**
+ *  Release memory held by queued tracking calls down to half the queue byte budget, as the trackers'
+ *  overflow policies allow. To be called on a memory warning.
+ */
+- (void)compactQueuedEvents;
+
+#if RI_TRACKER_METRICS
+
+/**
+ *  Snapshots of the instrumentation of the trackers, in the order of the trackers: latencies of
+ *  tracking calls waiting in and being processed from each tracker's queue, queue depths and counts
+ *  of calls processed and dropped. Calls handed to the trackers by the ring buffer pipeline are not
+ *  instrumented.
+ *
+ *  @return The snapshots, of class RITrackerMetricsSnapshot
+ */
+- (NSArray *)trackerMetricsSnapshots;
+
+#endif
+
 /**
  *  Load the configuration needed from a plist file in the given path and launching options
  *
@@ -244,6 +558,23 @@ if ([RITracking sharedInstance].debug) NSLog(@"RITracking: %@",[NSString stringW
 - (void)startWithConfigurationFromPropertyListAtPath:(NSString *)path
                                        launchOptions:(NSDictionary *)launchOptions;
 
+/**
+ *  Load the configuration and create the trackers on a background queue, returning immediately.
+ *
+ *  Tracking calls made until initialisation completed are held and replayed in order, e-commerce
+ *  calls after the others, the same as calls made before a synchronous start.
+ *
+ *  @param path Path to the configuration file (plist file).
+ *  @param launchOptions The launching options.
+ *  @param completion (optional) A block called on the main queue once done, with whether tracking is
+ *                    ready and the duration in seconds of each start phase keyed by
+ *                    kRITrackingStartPhase constants.
+ */
+- (void)startAsynchronouslyWithConfigurationFromPropertyListAtPath:(NSString *)path
+                                                     launchOptions:(NSDictionary *)launchOptions
+                                                        completion:(void (^)(BOOL ready,
+                                                                             NSDictionary *phaseDurations))completion;
+
 /**
  *  Creates and initializes an `RITracking`object
  *
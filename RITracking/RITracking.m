@@ -7,17 +7,231 @@
 //
 
 #import "RITracking.h"
-#import "RIGoogleAnalyticsTracker.h"
-#import "RIBugSenseTracker.h"
+#import "RITrackerRegistry.h"
 #import "RIOpenURLHandler.h"
+#import "RIOpenURLPattern.h"
+#import "RIOpenURLRouter.h"
+#import "RIOpenURLView.h"
+#import "RITrackingEventBatcher.h"
+#import "RIEventPipeline.h"
+#import "RIEventBuffer.h"
+#import "RIEventJournal.h"
+#import "RIEventInbox.h"
+#import "RIEventBudget.h"
+#import "RIVocabulary.h"
+
+NSString * const kRITrackingEventBatchInterval = @"RITrackingEventBatchInterval";
+NSString * const kRITrackingEventBatchMaxCount = @"RITrackingEventBatchMaxCount";
+NSString * const kRITrackingPipelineMode = @"RITrackingPipelineMode";
+NSString * const kRITrackingPipelineModeRing = @"ring";
+NSString * const kRITrackingPipelineCapacity = @"RITrackingPipelineCapacity";
+NSString * const kRITrackingSharedExecutorEnabled = @"RITrackingSharedExecutorEnabled";
+NSString * const kRITrackingJournalEnabled = @"RITrackingJournalEnabled";
+NSString * const kRITrackingJournalSegmentSize = @"RITrackingJournalSegmentSize";
+NSString * const kRITrackingOpenURLCacheCapacity = @"RITrackingOpenURLCacheCapacity";
+NSString * const kRITrackingVocabularyCapacity = @"RITrackingVocabularyCapacity";
+NSString * const kRITrackingQueueByteBudget = @"RITrackingQueueByteBudget";
+NSString * const kRITrackingQueuePolicies = @"RITrackingQueuePolicies";
+NSString * const kRITrackingQueuePolicyDropNewest = @"drop-newest";
+NSString * const kRITrackingQueuePolicyDropOldest = @"drop-oldest";
+NSString * const kRITrackingQueuePolicyBlock = @"block";
+NSString * const kRITrackingQueuePolicySpill = @"spill";
+NSString * const kRITrackingQueueBlockTimeout = @"RITrackingQueueBlockTimeout";
+NSString * const kRITrackingCircuitFailureRate = @"RITrackingCircuitFailureRate";
+NSString * const kRITrackingCircuitWindowSize = @"RITrackingCircuitWindowSize";
+NSString * const kRITrackingCircuitSlowCallDuration = @"RITrackingCircuitSlowCallDuration";
+NSString * const kRITrackingCircuitWedgeTimeout = @"RITrackingCircuitWedgeTimeout";
+NSString * const kRITrackingCircuitCooldown = @"RITrackingCircuitCooldown";
+NSString * const kRITrackingPriorities = @"RITrackingPriorities";
+NSString * const kRITrackingEventPriorities = @"RITrackingEventPriorities";
+NSString * const kRITrackingCallTypeEvent = @"event";
+NSString * const kRITrackingCallTypeScreen = @"screen";
+NSString * const kRITrackingCallTypeException = @"exception";
+NSString * const kRITrackingCallTypeOpenURL = @"openURL";
+NSString * const kRITrackingCallTypeEcommerce = @"ecommerce";
+NSString * const kRITrackingPriorityCritical = @"critical";
+NSString * const kRITrackingPriorityNormal = @"normal";
+NSString * const kRITrackingPriorityBulk = @"bulk";
+NSString * const kRITrackingStartPhaseConfiguration = @"configuration";
+NSString * const kRITrackingStartPhaseTrackers = @"trackers";
+NSString * const kRITrackingStartPhasePipeline = @"pipeline";
+NSString * const kRITrackingStartPhaseReplay = @"replay";
+
+/**
+ *  Maximum number of tracking calls held before initialisation completed
+ */
+static NSUInteger const kRITrackingPreStartBufferCapacity = 256;
+
+/**
+ *  Default longest time in seconds a caller is blocked by a full queue
+ */
+static NSTimeInterval const kRITrackingDefaultQueueBlockTimeout = 0.1;
+
+/**
+ *  Number of record kinds priorities are kept for
+ */
+#define RI_TRACKING_RECORD_KINDS (RIEventRecordKindOpenURL + 1)
+
+/**
+ *  Marks event names without a priority of their own in the event priority table
+ */
+static uint8_t const kRITrackingNoEventPriority = UINT8_MAX;
+
+@interface RITrackingEvent ()
+
+/**
+ *  Countdown of the trackers processing the event, to acknowledge its journal entry
+ */
+@property RIEventJournalAcknowledgement *acknowledgement;
+
+/**
+ *  Vocabulary identifiers backing the event, action and category names
+ */
+@property RIVocabularyIdentifier eventIdentifier;
+@property RIVocabularyIdentifier actionIdentifier;
+@property RIVocabularyIdentifier categoryIdentifier;
+
+/**
+ *  The event, action and category names the vocabulary had no room for
+ */
+@property NSString *eventString;
+@property NSString *actionString;
+@property NSString *categoryString;
+
+@end
+
+@implementation RITrackingEvent
+
+- (NSString *)event
+{
+    return RIVocabularyName(self.eventIdentifier) ?: self.eventString;
+}
+
+- (void)setEvent:(NSString *)event
+{
+    self.eventIdentifier = RIVocabularyIntern(event);
+    self.eventString = self.eventIdentifier ? nil : [event copy];
+}
+
+- (NSString *)action
+{
+    return RIVocabularyName(self.actionIdentifier) ?: self.actionString;
+}
+
+- (void)setAction:(NSString *)action
+{
+    self.actionIdentifier = RIVocabularyIntern(action);
+    self.actionString = self.actionIdentifier ? nil : [action copy];
+}
+
+- (NSString *)category
+{
+    return RIVocabularyName(self.categoryIdentifier) ?: self.categoryString;
+}
+
+- (void)setCategory:(NSString *)category
+{
+    self.categoryIdentifier = RIVocabularyIntern(category);
+    self.categoryString = self.categoryIdentifier ? nil : [category copy];
+}
+
+@end
+
+@implementation RITrackingProduct
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    RITrackingProduct *product = [[RITrackingProduct allocWithZone:zone] init];
+    product.identifier = self.identifier;
+    product.name = self.name;
+    product.quantity = self.quantity;
+    product.price = self.price;
+    product.currency = self.currency;
+    product.category = self.category;
+    return product;
+}
+
+@end
+
+@implementation RITrackingTotal
+
+@end
 
 @interface RITracking ()
 
 @property NSArray *trackers;
-@property NSMutableArray *handlers;
+@property RIOpenURLRouter *router;
+
+/**
+ *  Dispatch tables holding the subset of trackers conforming to a tracking protocol. They are built
+ *  once on start to spare the protocol conformance check on every tracking call.
+ */
+@property NSArray *eventTrackers;
+@property NSArray *screenTrackers;
+@property NSArray *exceptionTrackers;
+@property NSArray *openURLTrackers;
+@property NSArray *ecommerceTrackers;
+
+/**
+ *  Inboxes of the trackers, in the order of the trackers and of the dispatch tables. Tracking calls
+ *  reach the trackers' queues through their inboxes.
+ */
+@property NSArray *inboxes;
+@property NSArray *eventInboxes;
+@property NSArray *screenInboxes;
+@property NSArray *exceptionInboxes;
+@property NSArray *openURLInboxes;
+@property NSArray *ecommerceInboxes;
+
+/**
+ *  Batching stage in front of the event trackers, nil if batching is not configured.
+ */
+@property RITrackingEventBatcher *eventBatcher;
+
+/**
+ *  Ring buffer pipeline replacing the tracker queues, nil if not configured.
+ */
+@property RIEventPipeline *pipeline;
+
+/**
+ *  Buffer holding tracking calls made before initialisation completed, nil once replayed.
+ */
+@property RIEventBuffer *preStartBuffer;
+
+/**
+ *  E-commerce calls made before initialisation completed, nil once replayed. Guarded by the
+ *  instance's lock.
+ */
+@property NSMutableArray *preStartEcommerceCalls;
+@property NSUInteger preStartEcommerceDroppedCount;
+
+/**
+ *  Journal of tracking calls not yet processed by all trackers, nil if not configured.
+ */
+@property RIEventJournal *journal;
+@property NSUInteger replayedPreStartDroppedCount;
+
+/**
+ *  Priorities of the tracking calls, built once on start: a byte per record kind, a byte per
+ *  vocabulary identifier of the event names configured and the priority of e-commerce calls.
+ */
+@property NSData *recordPriorities;
+@property NSData *eventPriorities;
+@property RIEventInboxPriority ecommercePriority;
 
 @end
 
+/**
+ *  Record the duration of a start phase and return the start of the next one
+ */
+static CFAbsoluteTime RITrackingRecordPhase(NSMutableDictionary *phaseDurations, NSString *phase,
+                                            CFAbsoluteTime phaseStart)
+{
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    phaseDurations[phase] = @(now - phaseStart);
+    return now;
+}
+
 @implementation RITracking
 
 static RITracking *sharedInstance;
@@ -31,171 +245,759 @@ static dispatch_once_t sharedInstanceToken;
     return sharedInstance;
 }
 
-- (instancetype)initWithTrackers:(NSArray *)trackers
+- (instancetype)init
 {
     if ((self = [super init])) {
-        self.handlers = [NSMutableArray array];
+        self.router = [[RIOpenURLRouter alloc] init];
+        self.preStartBuffer = [[RIEventBuffer alloc]
+                               initWithCapacity:kRITrackingPreStartBufferCapacity];
+        self.preStartEcommerceCalls = [NSMutableArray array];
+        
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(configurationDidChange:)
+                                                     name:kRITrackingConfigurationDidChangeNotification
+                                                   object:nil];
     }
     return self;
 }
 
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (NSUInteger)preStartDroppedCount
+{
+    RIEventBuffer *preStartBuffer = self.preStartBuffer;
+    NSUInteger droppedCount = preStartBuffer ? preStartBuffer.droppedCount : self.replayedPreStartDroppedCount;
+    @synchronized(self) {
+        return droppedCount + self.preStartEcommerceDroppedCount;
+    }
+}
+
+- (NSUInteger)openURLCacheHitCount
+{
+    return self.router.cacheHitCount;
+}
+
+- (NSUInteger)openURLCacheMissCount
+{
+    return self.router.cacheMissCount;
+}
+
+- (NSUInteger)openURLCacheEvictionCount
+{
+    return self.router.cacheEvictionCount;
+}
+
+- (NSDictionary *)shedEventCounts
+{
+    NSArray *inboxes = self.inboxes;
+    NSDictionary *kinds = @{@"launch": @(RIEventRecordKindLaunch),
+                            @"event": @(RIEventRecordKindEvent),
+                            @"screen": @(RIEventRecordKindScreen),
+                            @"exception": @(RIEventRecordKindException),
+                            @"openURL": @(RIEventRecordKindOpenURL)};
+    NSMutableDictionary *counts = [NSMutableDictionary dictionaryWithCapacity:kinds.count];
+    
+    for (NSString *name in kinds) {
+        RIEventRecordKind kind = (RIEventRecordKind)[kinds[name] unsignedIntegerValue];
+        uint64_t count = 0;
+        for (RIEventInbox *inbox in inboxes) {
+            count += [inbox shedCountForRecordKind:kind];
+        }
+        counts[name] = @(count);
+    }
+    
+    uint64_t callCount = 0;
+    for (RIEventInbox *inbox in inboxes) {
+        callCount += [inbox shedCallCount];
+    }
+    counts[@"operation"] = @(callCount);
+    
+    return [counts copy];
+}
+
+- (void)compactQueuedEvents
+{
+    size_t limit = RIEventBudgetLimit();
+    size_t usage = RIEventBudgetUsage();
+    size_t target = limit / 2;
+    
+    if (usage <= target) return;
+    
+    size_t size = usage - target;
+    
+    for (RIEventInbox *inbox in self.inboxes) {
+        size_t released = [inbox compactReleasingSize:size];
+        size -= MIN(size, released);
+        if (!size) break;
+    }
+    
+    RILog(RILogLevelWarning, @"Compacted tracking queues from %zu to %zu bytes",
+          usage, RIEventBudgetUsage());
+}
+
+- (NSArray *)trackerHealthMonitors
+{
+    return [self.inboxes valueForKey:@"health"];
+}
+
+#if RI_TRACKER_METRICS
+
+- (NSArray *)trackerMetricsSnapshots
+{
+    NSArray *inboxes = self.inboxes;
+    NSMutableArray *snapshots = [NSMutableArray arrayWithCapacity:inboxes.count];
+    
+    for (RIEventInbox *inbox in inboxes) {
+        [snapshots addObject:[inbox metricsSnapshot]];
+    }
+    
+    return [snapshots copy];
+}
+
+#endif
+
 - (void)setDebug:(BOOL)debug
 {
     _debug = debug;
-    NSLog(@"RITracking: Debug mode %@", debug ? @"ON" : @"OFF");
+    RILogSetLevel(debug ? RILogLevelDebug : RILogLevelWarning);
+    RILog(RILogLevelInfo, @"Debug mode %@", debug ? @"ON" : @"OFF");
 }
 
 - (void)startWithConfigurationFromPropertyListAtPath:(NSString *)path
                                        launchOptions:(NSDictionary *)launchOptions
+{
+    BOOL ready = NO;
+    [self startWithConfigurationFromPropertyListAtPath:path
+                                         launchOptions:launchOptions
+                                                 ready:&ready
+                                        phaseDurations:nil];
+}
+
+- (void)startAsynchronouslyWithConfigurationFromPropertyListAtPath:(NSString *)path
+                                                     launchOptions:(NSDictionary *)launchOptions
+                                                        completion:(void (^)(BOOL ready,
+                                                                             NSDictionary *phaseDurations))completion
+{
+    RIDebugLog(@"Starting asynchronous initialisation");
+    
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        BOOL ready = NO;
+        NSMutableDictionary *phaseDurations = [NSMutableDictionary dictionary];
+        [self startWithConfigurationFromPropertyListAtPath:path
+                                             launchOptions:launchOptions
+                                                     ready:&ready
+                                            phaseDurations:phaseDurations];
+        
+        if (!completion) return;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(ready, [phaseDurations copy]);
+        });
+    });
+}
+
+- (void)startWithConfigurationFromPropertyListAtPath:(NSString *)path
+                                       launchOptions:(NSDictionary *)launchOptions
+                                               ready:(BOOL *)ready
+                                      phaseDurations:(NSMutableDictionary *)phaseDurations
 {
     RIDebugLog(@"Starting initialisation with launch options '%@' and property list at path '%@'",
                launchOptions, path);
     
+    CFAbsoluteTime phaseStart = CFAbsoluteTimeGetCurrent();
+    
     BOOL loaded = [RITrackingConfiguration loadFromPropertyListAtPath:path];
     
+    phaseStart = RITrackingRecordPhase(phaseDurations, kRITrackingStartPhaseConfiguration, phaseStart);
+    
     if (!loaded) {
+        [self discardPreStartBuffer];
         RIRaiseError(@"Unexpected error occurred when loading tracking configuration from property "
                      @"list file at path '%@'", path);
         return;
     }
     
-    RIGoogleAnalyticsTracker *googleAnalyticsTracker = [[RIGoogleAnalyticsTracker alloc] init];
-    RIBugSenseTracker *bugsenseTracker = [[RIBugSenseTracker alloc] init];
+    // Trackers not enabled by the configuration are never created
+    NSArray *trackers = [RITrackerRegistry trackersEnabledByConfiguration];
+    
+    self.eventTrackers = [self trackers:trackers conformingToProtocol:@protocol(RIEventTracking)];
+    self.screenTrackers = [self trackers:trackers conformingToProtocol:@protocol(RIScreenTracking)];
+    self.exceptionTrackers = [self trackers:trackers
+                       conformingToProtocol:@protocol(RIExceptionTracking)];
+    self.openURLTrackers = [self trackers:trackers conformingToProtocol:@protocol(RIOpenURLTracking)];
+    self.ecommerceTrackers = [self trackers:trackers
+                       conformingToProtocol:@protocol(RIEcommerceEventTracking)];
+    
+    RIEventExecutor *executor = nil;
+    if ([[RITrackingConfiguration valueForKey:kRITrackingSharedExecutorEnabled] boolValue]) {
+        executor = [RIEventExecutor sharedExecutor];
+    }
+    
+    NSMapTable *inboxesByTracker = [NSMapTable strongToStrongObjectsMapTable];
+    for (id tracker in trackers) {
+        RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+        inbox.executor = executor;
+        [inboxesByTracker setObject:inbox forKey:tracker];
+    }
+    self.inboxes = [self inboxes:inboxesByTracker forTrackers:trackers];
+    self.eventInboxes = [self inboxes:inboxesByTracker forTrackers:self.eventTrackers];
+    self.screenInboxes = [self inboxes:inboxesByTracker forTrackers:self.screenTrackers];
+    self.exceptionInboxes = [self inboxes:inboxesByTracker forTrackers:self.exceptionTrackers];
+    self.openURLInboxes = [self inboxes:inboxesByTracker forTrackers:self.openURLTrackers];
+    self.ecommerceInboxes = [self inboxes:inboxesByTracker forTrackers:self.ecommerceTrackers];
+    [self configureQueueBudgetOfInboxes:self.inboxes];
+    [self configureHealthOfInboxes:self.inboxes];
+    
+    id vocabularyCapacity = [RITrackingConfiguration valueForKey:kRITrackingVocabularyCapacity];
+    
+    // Set ahead of interning the event names configured with priorities
+    if (vocabularyCapacity) {
+        RIVocabularySetCapacity((NSUInteger)MAX(0, [vocabularyCapacity integerValue]));
+    }
+    
+    [self configurePriorities];
+    
+    phaseStart = RITrackingRecordPhase(phaseDurations, kRITrackingStartPhaseTrackers, phaseStart);
     
-    self.trackers = @[googleAnalyticsTracker, bugsenseTracker];
+    id openURLCacheCapacity = [RITrackingConfiguration valueForKey:kRITrackingOpenURLCacheCapacity];
     
-    for (id tracker in self.trackers) {
-        [((id<RITracker>)tracker).queue addOperationWithBlock:^{
-            [(id<RITracker>)tracker applicationDidLaunchWithOptions:launchOptions];
+    if (openURLCacheCapacity) {
+        self.router.cacheCapacity = (NSUInteger)MAX(0, [openURLCacheCapacity integerValue]);
+    }
+    
+    // Records journaled by a previous start keep its journal open until they are processed. The new
+    // journal leaves the segments of that journal to it, so their records are not replayed again.
+    if ([[RITrackingConfiguration valueForKey:kRITrackingJournalEnabled] boolValue]) {
+        NSUInteger segmentSize =
+        [[RITrackingConfiguration valueForKey:kRITrackingJournalSegmentSize] unsignedIntegerValue];
+        self.journal = [[RIEventJournal alloc] initWithDirectory:[RITracking journalDirectory]
+                                                     segmentSize:(segmentSize ?: 1 << 20)];
+    } else {
+        self.journal = nil;
+    }
+    
+    NSString *pipelineMode = [RITrackingConfiguration valueForKey:kRITrackingPipelineMode];
+    
+    // The drain thread of a previous start retains its pipeline and trackers until stopped
+    [self.pipeline stop];
+    
+    if ([pipelineMode isEqualToString:kRITrackingPipelineModeRing]) {
+        NSUInteger capacity =
+        [[RITrackingConfiguration valueForKey:kRITrackingPipelineCapacity] unsignedIntegerValue];
+        self.pipeline = [[RIEventPipeline alloc] initWithCapacity:(capacity ?: 4096)
+                                                          handler:[self pipelineHandlerForTrackers:trackers]];
+    } else {
+        self.pipeline = nil;
+    }
+    
+    // The timer of a previous batcher holds it weakly, so events of its time window would be lost
+    [self.eventBatcher flush];
+    
+    NSTimeInterval batchInterval =
+    [[RITrackingConfiguration valueForKey:kRITrackingEventBatchInterval] doubleValue];
+    
+    if (!self.pipeline && 0 < batchInterval) {
+        NSUInteger batchMaxCount =
+        [[RITrackingConfiguration valueForKey:kRITrackingEventBatchMaxCount] unsignedIntegerValue];
+        NSArray *eventInboxes = self.eventInboxes;
+        RIEventInboxPriority eventPriority =
+        ((const uint8_t *)self.recordPriorities.bytes)[RIEventRecordKindEvent];
+        self.eventBatcher = [[RITrackingEventBatcher alloc] initWithInterval:batchInterval
+                                                                    maxCount:batchMaxCount
+                                                                     handler:^(NSArray *events) {
+            [RITracking dispatchEvents:events toInboxes:eventInboxes priority:eventPriority];
         }];
+    } else {
+        self.eventBatcher = nil;
+    }
+    
+    if (self.pipeline) {
+        // Launch hooks run on the drain thread ahead of any tracking call
+        RIEventRecord record = RIEventRecordMakeLaunch(launchOptions);
+        [self.pipeline enqueueRecord:&record];
+    } else {
+        for (RIEventInbox *inbox in self.inboxes) {
+            id<RITracker> tracker = inbox.tracker;
+            [inbox addOperationWithBlock:^{
+                [tracker applicationDidLaunchWithOptions:launchOptions];
+            } priority:RIEventInboxPriorityCritical];
+        }
     }
+    
+    self.trackers = trackers;
+    
+    phaseStart = RITrackingRecordPhase(phaseDurations, kRITrackingStartPhasePipeline, phaseStart);
+    
+    // Replay tracking calls made before initialisation completed
+    RIEventBuffer *preStartBuffer = self.preStartBuffer;
+    [preStartBuffer closeWithReplayHandler:^(RIEventRecord *record) {
+        [self trackRecord:record];
+    }];
+    self.replayedPreStartDroppedCount = preStartBuffer.droppedCount;
+    self.preStartBuffer = nil;
+    
+    // E-commerce calls made before follow the other tracking calls replayed
+    @synchronized(self) {
+        NSArray *calls = self.preStartEcommerceCalls;
+        self.preStartEcommerceCalls = nil;
+        
+        // E-commerce calls made concurrently wait for the replay, so they cannot overtake it
+        for (void (^call)(id<RIEcommerceEventTracking>) in calls) [self dispatchEcommerceCall:call];
+    }
+    
+    RITrackingRecordPhase(phaseDurations, kRITrackingStartPhaseReplay, phaseStart);
+    *ready = YES;
+    
+    // Replay tracking calls a previous process did not get processed by all trackers
+    [self.journal recoverWithHandler:^(RIEventRecord *record) {
+        [self dispatchRecord:record];
+    }];
 }
 
-#pragma mark - RIEventTracking protocol
+/**
+ *  Drop the tracking calls held for a start that failed, counting them as dropped. Later calls are
+ *  not held any more but fail for lack of trackers.
+ */
+- (void)discardPreStartBuffer
+{
+    @synchronized(self) {
+        self.preStartEcommerceDroppedCount += self.preStartEcommerceCalls.count;
+        self.preStartEcommerceCalls = nil;
+    }
+    
+    RIEventBuffer *preStartBuffer = self.preStartBuffer;
+    
+    if (!preStartBuffer) return;
+    
+    __block NSUInteger discardedCount = 0;
+    [preStartBuffer closeWithReplayHandler:^(RIEventRecord *record) {
+        RIEventRecordDispose(record);
+        discardedCount++;
+    }];
+    self.replayedPreStartDroppedCount = preStartBuffer.droppedCount + discardedCount;
+    self.preStartBuffer = nil;
+}
 
-- (void)trackEvent:(NSString *)event
-             value:(NSNumber *)value
-            action:(NSString *)action
-          category:(NSString *)category
-              data:(NSDictionary *)data
++ (NSString *)journalDirectory
 {
-    RIDebugLog(@"Tracking event: '%@' with value: %@ with action: %@ with category: %@ and data: %@"
-               , event, value, action, category, data);
+    NSString *directory = [NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory,
+                                                               NSUserDomainMask,
+                                                               YES) firstObject];
+    return [directory stringByAppendingPathComponent:@"RITrackingJournal"];
+}
+
+- (NSArray *)trackers:(NSArray *)trackers conformingToProtocol:(Protocol *)protocol
+{
+    NSMutableArray *conformingTrackers = [NSMutableArray arrayWithCapacity:trackers.count];
     
-    if (!self.trackers) {
-        RIRaiseError(@"Invalid call with non-existent trackers. Initialisation may have failed.");
-        return;
+    for (id tracker in trackers) {
+        if ([tracker conformsToProtocol:protocol]) {
+            [conformingTrackers addObject:tracker];
+        }
+    }
+    
+    return [conformingTrackers copy];
+}
+
+/**
+ *  Set the queue byte budget and the trackers' overflow policies from the configuration
+ */
+- (void)configureQueueBudgetOfInboxes:(NSArray *)inboxes
+{
+    id byteBudget = [RITrackingConfiguration valueForKey:kRITrackingQueueByteBudget];
+    RIEventBudgetSetLimit([byteBudget isKindOfClass:NSNumber.class] ?
+                          (size_t)MAX(0, [byteBudget longLongValue]) : 0);
+    
+    id policies = [RITrackingConfiguration valueForKey:kRITrackingQueuePolicies];
+    if (![policies isKindOfClass:NSDictionary.class]) policies = nil;
+    
+    id blockTimeout = [RITrackingConfiguration valueForKey:kRITrackingQueueBlockTimeout];
+    NSTimeInterval timeout = [blockTimeout isKindOfClass:NSNumber.class] ?
+    MAX(0, [blockTimeout doubleValue]) : kRITrackingDefaultQueueBlockTimeout;
+    
+    NSString *spillDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:@"RITrackingSpill"];
+    
+    for (RIEventInbox *inbox in inboxes) {
+        NSString *name = NSStringFromClass([inbox.tracker class]);
+        NSString *policy = policies[name];
+        
+        inbox.blockTimeout = timeout;
+        
+        if (!policy || [policy isEqual:kRITrackingQueuePolicyDropNewest]) {
+            inbox.overflowPolicy = RIEventInboxOverflowPolicyDropNewest;
+        } else if ([policy isEqual:kRITrackingQueuePolicyDropOldest]) {
+            inbox.overflowPolicy = RIEventInboxOverflowPolicyDropOldest;
+        } else if ([policy isEqual:kRITrackingQueuePolicyBlock]) {
+            inbox.overflowPolicy = RIEventInboxOverflowPolicyBlock;
+        } else if ([policy isEqual:kRITrackingQueuePolicySpill]) {
+            inbox.spillPath = [spillDirectory stringByAppendingPathComponent:name];
+            // Without a spill file, calls are shed
+            inbox.overflowPolicy = inbox.spillPath ?
+            RIEventInboxOverflowPolicySpill : RIEventInboxOverflowPolicyDropNewest;
+        } else {
+            RILog(RILogLevelWarning, @"Ignoring unknown queue overflow policy '%@' of tracker %@",
+                  policy, name);
+        }
     }
+}
+
+/**
+ *  Set the thresholds of the trackers' circuits from the configuration and forward their state
+ *  changes to the tracker health handler
+ */
+- (void)configureHealthOfInboxes:(NSArray *)inboxes
+{
+    id failureRate = [RITrackingConfiguration valueForKey:kRITrackingCircuitFailureRate];
+    id windowSize = [RITrackingConfiguration valueForKey:kRITrackingCircuitWindowSize];
+    id slowCallDuration = [RITrackingConfiguration valueForKey:kRITrackingCircuitSlowCallDuration];
+    id wedgeTimeout = [RITrackingConfiguration valueForKey:kRITrackingCircuitWedgeTimeout];
+    id cooldown = [RITrackingConfiguration valueForKey:kRITrackingCircuitCooldown];
+    
+    __weak RITracking *weakSelf = self;
+    void (^handler)(RITrackerHealth *, RITrackerHealthState) = ^(RITrackerHealth *health,
+                                                                RITrackerHealthState state) {
+        void (^trackerHealthHandler)(RITrackerHealth *, RITrackerHealthState) =
+        weakSelf.trackerHealthHandler;
+        
+        if (trackerHealthHandler) trackerHealthHandler(health, state);
+    };
     
-    for (id tracker in self.trackers) {
-        if ([tracker conformsToProtocol:@protocol(RIEventTracking)]) {
-            [((id<RITracker>)tracker).queue addOperationWithBlock:^{
-                [(id<RIEventTracking>)tracker trackEvent:event
-                                                   value:value
-                                                  action:action
-                                                category:category
-                                                    data:data];
-            }];
+    for (RIEventInbox *inbox in inboxes) {
+        RITrackerHealth *health = inbox.health;
+        
+        if ([failureRate isKindOfClass:NSNumber.class] && 0 < [failureRate doubleValue]) {
+            health.failureRate = [failureRate doubleValue];
+        }
+        if ([windowSize isKindOfClass:NSNumber.class] && 0 < [windowSize integerValue]) {
+            health.windowSize = [windowSize unsignedIntegerValue];
+        }
+        if ([slowCallDuration isKindOfClass:NSNumber.class] && 0 < [slowCallDuration doubleValue]) {
+            health.slowCallDuration = [slowCallDuration doubleValue];
+        }
+        if ([wedgeTimeout isKindOfClass:NSNumber.class] && 0 < [wedgeTimeout doubleValue]) {
+            health.wedgeTimeout = [wedgeTimeout doubleValue];
+        }
+        if ([cooldown isKindOfClass:NSNumber.class] && 0 <= [cooldown doubleValue]) {
+            health.cooldown = [cooldown doubleValue];
         }
+        health.stateChangeHandler = handler;
     }
 }
 
-#pragma mark - RIExceptionTracking protocol
+- (NSArray *)inboxes:(NSMapTable *)inboxesByTracker forTrackers:(NSArray *)trackers
+{
+    NSMutableArray *inboxes = [NSMutableArray arrayWithCapacity:trackers.count];
+    
+    for (id tracker in trackers) {
+        [inboxes addObject:[inboxesByTracker objectForKey:tracker]];
+    }
+    
+    return [inboxes copy];
+}
 
-- (void)trackExceptionWithName:(NSString *)name
+/**
+ *  Build the priorities of the tracking calls from the configuration
+ */
+- (void)configurePriorities
 {
-    RIDebugLog(@"Tracking exception with name '%@'", name);
+    id priorities = [RITrackingConfiguration valueForKey:kRITrackingPriorities];
+    if (![priorities isKindOfClass:NSDictionary.class]) priorities = nil;
+    
+    uint8_t recordPriorities[RI_TRACKING_RECORD_KINDS];
+    recordPriorities[RIEventRecordKindLaunch] = RIEventInboxPriorityCritical;
+    recordPriorities[RIEventRecordKindEvent] =
+    [self priorityNamed:priorities[kRITrackingCallTypeEvent]
+        defaultPriority:RIEventInboxPriorityNormal];
+    recordPriorities[RIEventRecordKindScreen] =
+    [self priorityNamed:priorities[kRITrackingCallTypeScreen]
+        defaultPriority:RIEventInboxPriorityNormal];
+    recordPriorities[RIEventRecordKindException] =
+    [self priorityNamed:priorities[kRITrackingCallTypeException]
+        defaultPriority:RIEventInboxPriorityCritical];
+    recordPriorities[RIEventRecordKindOpenURL] =
+    [self priorityNamed:priorities[kRITrackingCallTypeOpenURL]
+        defaultPriority:RIEventInboxPriorityNormal];
+    self.recordPriorities = [NSData dataWithBytes:recordPriorities length:sizeof(recordPriorities)];
+    self.ecommercePriority = [self priorityNamed:priorities[kRITrackingCallTypeEcommerce]
+                                 defaultPriority:RIEventInboxPriorityCritical];
+    
+    id eventPriorities = [RITrackingConfiguration valueForKey:kRITrackingEventPriorities];
+    if (![eventPriorities isKindOfClass:NSDictionary.class]) eventPriorities = nil;
+    
+    // Indexed by the vocabulary identifier of the event name, sparing a lookup by name per event
+    NSMutableData *eventPriorityTable = [NSMutableData data];
+    
+    for (NSString *name in eventPriorities) {
+        RIVocabularyIdentifier identifier = RIVocabularyIntern(name);
+        if (RIVocabularyIdentifierNone == identifier) continue;
+        
+        NSUInteger length = eventPriorityTable.length;
+        if (identifier >= length) {
+            eventPriorityTable.length = identifier + 1;
+            memset((uint8_t *)eventPriorityTable.mutableBytes + length, kRITrackingNoEventPriority,
+                   identifier + 1 - length);
+        }
+        ((uint8_t *)eventPriorityTable.mutableBytes)[identifier] =
+        [self priorityNamed:eventPriorities[name]
+            defaultPriority:recordPriorities[RIEventRecordKindEvent]];
+    }
+    
+    self.eventPriorities = eventPriorityTable.length ? [eventPriorityTable copy] : nil;
+}
+
+- (RIEventInboxPriority)priorityNamed:(id)name defaultPriority:(RIEventInboxPriority)defaultPriority
+{
+    if (!name) return defaultPriority;
+    if ([name isEqual:kRITrackingPriorityCritical]) return RIEventInboxPriorityCritical;
+    if ([name isEqual:kRITrackingPriorityNormal]) return RIEventInboxPriorityNormal;
+    if ([name isEqual:kRITrackingPriorityBulk]) return RIEventInboxPriorityBulk;
+    
+    RILog(RILogLevelWarning, @"Ignoring unknown tracking priority '%@'", name);
+    return defaultPriority;
+}
+
+- (NSArray *)inboxesForRecordKind:(RIEventRecordKind)kind
+{
+    switch (kind) {
+        case RIEventRecordKindLaunch: return self.inboxes;
+        case RIEventRecordKindEvent: return self.eventInboxes;
+        case RIEventRecordKindScreen: return self.screenInboxes;
+        case RIEventRecordKindException: return self.exceptionInboxes;
+        case RIEventRecordKindOpenURL: return self.openURLInboxes;
+    }
+    return nil;
+}
+
+- (void (^)(const RIEventRecord *))pipelineHandlerForTrackers:(NSArray *)trackers
+{
+    NSArray *eventTrackers = self.eventTrackers;
+    NSArray *screenTrackers = self.screenTrackers;
+    NSArray *exceptionTrackers = self.exceptionTrackers;
+    NSArray *openURLTrackers = self.openURLTrackers;
+    RIEventJournal *journal = self.journal;
+    
+    return ^(const RIEventRecord *record) {
+        NSArray *recordTrackers = nil;
+        switch (record->kind) {
+            case RIEventRecordKindLaunch: recordTrackers = trackers; break;
+            case RIEventRecordKindEvent: recordTrackers = eventTrackers; break;
+            case RIEventRecordKindScreen: recordTrackers = screenTrackers; break;
+            case RIEventRecordKindException: recordTrackers = exceptionTrackers; break;
+            case RIEventRecordKindOpenURL: recordTrackers = openURLTrackers; break;
+        }
+        for (id tracker in recordTrackers) {
+            RIEventRecordDeliver(record, tracker);
+        }
+        if (record->journalIdentifier) {
+            [journal acknowledgeIdentifier:record->journalIdentifier];
+        }
+    };
+}
+
++ (void)dispatchEvents:(NSArray *)events
+             toInboxes:(NSArray *)inboxes
+              priority:(RIEventInboxPriority)priority
+{
+    for (RIEventInbox *inbox in inboxes) {
+        id tracker = inbox.tracker;
+        [inbox addCallWithBlock:^(BOOL shed) {
+            if (shed) {
+                // Shed events are acknowledged and not replayed, like shed records
+            } else if ([tracker respondsToSelector:@selector(trackEvents:)]) {
+                [(id<RIEventTracking>)tracker trackEvents:events];
+            } else {
+                for (RITrackingEvent *event in events) {
+                    [(id<RIEventTracking>)tracker trackEvent:event.event
+                                                       value:event.value
+                                                      action:event.action
+                                                    category:event.category
+                                                        data:event.data];
+                }
+            }
+            for (RITrackingEvent *event in events) {
+                [event.acknowledgement trackerDidProcess];
+            }
+        } count:events.count priority:priority];
+    }
+}
+
+#pragma mark - Fan-out
+
+/**
+ *  Entry of all tracking calls, taking ownership of the record. Calls are buffered until
+ *  initialisation completed, then journaled if configured and dispatched to the trackers.
+ */
+- (void)trackRecord:(RIEventRecord *)record
+{
+    RIEventBuffer *preStartBuffer = self.preStartBuffer;
+    
+    if (preStartBuffer && [preStartBuffer addRecord:record]) return;
     
     if (!self.trackers) {
+        RIEventRecordDispose(record);
         RIRaiseError(@"Invalid call with non-existent trackers. Initialisation may have failed.");
         return;
     }
     
-    for (id tracker in self.trackers) {
-        if ([tracker conformsToProtocol:@protocol(RIExceptionTracking)]) {
-            [((id<RITracker>)tracker).queue addOperationWithBlock:^{
-                [(id<RIExceptionTracking>)tracker trackExceptionWithName:name];
-            }];
+    [self.journal appendRecord:record];
+    [self dispatchRecord:record];
+}
+
+/**
+ *  Dispatch a record to the trackers conforming to its kind, taking ownership of the record.
+ */
+- (void)dispatchRecord:(RIEventRecord *)record
+{
+    RIEventPipeline *pipeline = self.pipeline;
+    
+    if (pipeline) {
+        [pipeline enqueueRecord:record];
+        return;
+    }
+    
+    NSArray *inboxes = [self inboxesForRecordKind:record->kind];
+    RIEventInboxPriority priority = [self priorityForRecord:record];
+    RITrackingEventBatcher *eventBatcher = self.eventBatcher;
+    
+    if (eventBatcher) {
+        // Events of a priority of their own bypass the batches
+        if (RIEventRecordKindEvent == record->kind &&
+            priority == ((const uint8_t *)self.recordPriorities.bytes)[RIEventRecordKindEvent]) {
+            RITrackingEvent *trackingEvent = [[RITrackingEvent alloc] init];
+            trackingEvent.eventIdentifier = record->names[0];
+            trackingEvent.value = RIEventRecordValueNumber(record);
+            trackingEvent.actionIdentifier = record->names[1];
+            trackingEvent.categoryIdentifier = record->names[2];
+            trackingEvent.eventString = record->names[0] ? nil : RIEventRecordNameAtIndex(record, 0);
+            trackingEvent.actionString = record->names[1] ? nil : RIEventRecordNameAtIndex(record, 1);
+            trackingEvent.categoryString = record->names[2] ? nil : RIEventRecordNameAtIndex(record, 2);
+            trackingEvent.data = (__bridge NSDictionary *)record->arguments[0];
+            trackingEvent.acknowledgement = [self.journal acknowledgementForRecord:record
+                                                                             count:inboxes.count];
+            [eventBatcher addEvent:trackingEvent];
+            RIEventRecordDispose(record);
+            return;
         }
+        
+        // Hand on pending events first to keep the order of tracking calls
+        [eventBatcher flush];
+    }
+    
+    // A single arena record is shared by all trackers, each tracker's inbox links it without
+    // allocating
+    RIEventArenaRecord *arenaRecord = RIEventArenaRecordCreate(record, inboxes.count, self.journal);
+    
+    // Shed for lack of memory
+    if (!arenaRecord) return;
+    
+    for (RIEventInbox *inbox in inboxes) {
+        [inbox addRecord:arenaRecord priority:priority];
     }
 }
 
+/**
+ *  The priority of a record, by its event name if configured, else by its kind
+ */
+- (RIEventInboxPriority)priorityForRecord:(const RIEventRecord *)record
+{
+    NSData *recordPriorities = self.recordPriorities;
+    
+    // Calls made before start are dispatched to no tracker
+    if (record->kind >= recordPriorities.length) return RIEventInboxPriorityNormal;
+    
+    if (RIEventRecordKindEvent == record->kind) {
+        NSData *eventPriorities = self.eventPriorities;
+        if (record->names[0] < eventPriorities.length) {
+            uint8_t priority = ((const uint8_t *)eventPriorities.bytes)[record->names[0]];
+            if (kRITrackingNoEventPriority != priority) return priority;
+        }
+    }
+    
+    return ((const uint8_t *)recordPriorities.bytes)[record->kind];
+}
+
+#pragma mark - RIEventTracking protocol
+
+- (void)trackEvent:(NSString *)event
+             value:(NSNumber *)value
+            action:(NSString *)action
+          category:(NSString *)category
+              data:(NSDictionary *)data
+{
+    RIDebugLog(@"Tracking event: '%@' with value: %@ with action: %@ with category: %@ and data: %@"
+               , event, value, action, category, data);
+    
+    RIEventRecord record = RIEventRecordMakeEvent(event, value, action, category, data);
+    [self trackRecord:&record];
+}
+
+#pragma mark - RIExceptionTracking protocol
+
+- (void)trackExceptionWithName:(NSString *)name
+{
+    RIDebugLog(@"Tracking exception with name '%@'", name);
+    
+    RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindException, name);
+    [self trackRecord:&record];
+}
+
 #pragma mark - RIOpenURLTracking protocol
 
 - (void)registerHandler:(void (^)(NSDictionary *))handlerBlock forOpenURLPattern:(NSString *)pattern
 {
     RIDebugLog(@"Registering handler for deeplink URL match pattern '%@'", pattern);
     
-    NSError *error;
-    NSArray *matches;
-    NSMutableArray *macros = [NSMutableArray array];
-    
-    while (YES) {
-        NSRegularExpression *regex = [NSRegularExpression
-                                      regularExpressionWithPattern:@"\\{([^\\}]+)\\}"
-                                      options:0
-                                      error:&error];
-        
-        if (error) {
-            RIRaiseError(@"Unexpected error when registering open URL handler "
-                         @"for pattern '%@': %@", pattern, error);
-            return;
+    RIOpenURLHandler *handler = [self handlerWithBlock:handlerBlock forOpenURLPattern:pattern];
+    
+    if (handler) [self.router addHandler:handler];
+}
+
+- (void)registerHandlersForOpenURLPatterns:(NSArray *)routes
+{
+    RIDebugLog(@"Registering handlers for %lu deeplink URL match patterns",
+               (unsigned long)routes.count);
+    
+    NSMutableArray *handlers = [NSMutableArray arrayWithCapacity:routes.count];
+    
+    for (NSArray *route in routes) {
+        if (2 != route.count) {
+            RIRaiseError(@"Invalid deeplink URL route '%@', expected a pattern and a handler", route);
+            continue;
         }
         
-        matches = [regex matchesInString:pattern
-                                 options:0
-                                   range:NSMakeRange(0, pattern.length)];
+        RIOpenURLHandler *handler = [self handlerWithBlock:route[1] forOpenURLPattern:route[0]];
         
-        if (0 == matches.count) break;
-        
-        NSRange macroRange = [matches[0] rangeAtIndex:1];
-        NSRange range = [matches[0] rangeAtIndex:0];
-        NSString *macro = [pattern substringWithRange:macroRange];
-        
-        [macros addObject:macro];
-        pattern = [pattern stringByReplacingCharactersInRange:range withString:@"(.*)"];
+        if (handler) [handlers addObject:handler];
     }
     
-    RIDebugLog(@"Deeplink handler pattern captures macros '%@'", macros);
-    
-    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:pattern
-                                                                           options:0
-                                                                             error:&error];
+    [self.router addHandlers:handlers];
+}
+
+- (RIOpenURLHandler *)handlerWithBlock:(void (^)(NSDictionary *))handlerBlock
+                     forOpenURLPattern:(NSString *)pattern
+{
+    NSError *error;
+    RIOpenURLPattern *compiledPattern = [RIOpenURLPattern patternWithString:pattern error:&error];
     
-    if (error) {
-        RIRaiseError(@"Unexpected error when creating regular expression with pattern '%@'",
-                     pattern);
-        return;
+    if (!compiledPattern) {
+        RIRaiseError(@"Unexpected error when creating regular expression with pattern '%@': %@",
+                     pattern, error);
+        return nil;
     }
     
-    RIOpenURLHandler *handler = [[RIOpenURLHandler alloc] initWithHandlerBlock:handlerBlock
-                                                                         regex:regex
-                                                                        macros:macros];
-    
-    [self.handlers addObject:handler];
+    return [[RIOpenURLHandler alloc] initWithHandlerBlock:handlerBlock pattern:compiledPattern];
 }
 
 - (void)trackOpenURL:(NSURL *)url
 {
     RIDebugLog(@"Tracking deepling with URL '%@'", url);
     
-    if (!self.trackers) {
-        RIRaiseError(@"Invalid call with non-existent trackers. Tracking initialisation was either "
-                     @"missing or has probably failed.");
-        return;
-    }
+    [self.router handleOpenURLView:[[RIOpenURLView alloc] initWithURL:url]];
     
-    for (RIOpenURLHandler *handler in self.handlers) {
-        [handler handleOpenURL:url];
-    }
-    
-    for (id tracker in self.trackers) {
-        if ([tracker conformsToProtocol:@protocol(RIOpenURLTracking)]) {
-            [((id<RITracker>)tracker).queue addOperationWithBlock:^{
-                [(id<RIOpenURLTracking>)tracker trackOpenURL:url];
-            }];
-        }
-    }
+    RIEventRecord record = RIEventRecordMakeOpenURL(url);
+    [self trackRecord:&record];
 }
 
 #pragma mark - RIScreenTracking protocol
@@ -204,18 +1006,96 @@ static dispatch_once_t sharedInstanceToken;
 {
     RIDebugLog(@"Tracking screen with name: '%@'", name);
     
-    if (!self.trackers){
-        RIRaiseError(@"Invalid call with non-existent trackers. Tracking initialisation was either "
-                     @"missing or has probably failed.");
+    RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, name);
+    [self trackRecord:&record];
+}
+
+#pragma mark - RIEcommerceEventTracking protocol
+
+/**
+ *  Hand an e-commerce call to the inbox of each e-commerce tracker, behind the tracking calls of the
+ *  same or a higher priority made before. E-commerce calls are not journaled. Calls made before
+ *  initialisation completed are held like other tracking calls and replayed after them.
+ */
+- (void)dispatchEcommerceCall:(void (^)(id<RIEcommerceEventTracking> tracker))call
+{
+    @synchronized(self) {
+        NSMutableArray *calls = self.preStartEcommerceCalls;
+        
+        if (calls) {
+            if (kRITrackingPreStartBufferCapacity == calls.count) {
+                [calls removeObjectAtIndex:0];
+                self.preStartEcommerceDroppedCount++;
+            }
+            [calls addObject:[call copy]];
+            return;
+        }
+    }
+    
+    NSArray *inboxes = self.ecommerceInboxes;
+    
+    if (!inboxes) {
+        RIRaiseError(@"Invalid call with non-existent trackers. Initialisation may have failed.");
         return;
     }
     
-    for (id tracker in self.trackers) {
-        if ([tracker conformsToProtocol:@protocol(RIScreenTracking)]) {
-            [((id<RITracker>)tracker).queue addOperationWithBlock:^{
-                [(id<RIScreenTracking>)tracker trackScreenWithName:name];
-            }];
-        }
+    // Hand on pending events first to keep the order of tracking calls
+    [self.eventBatcher flush];
+    
+    RIEventInboxPriority priority = self.ecommercePriority;
+    
+    for (RIEventInbox *inbox in inboxes) {
+        id<RIEcommerceEventTracking> tracker = inbox.tracker;
+        [inbox addCallWithBlock:^(BOOL shed) {
+            if (!shed) call(tracker);
+        } count:1 priority:priority];
+    }
+}
+
+- (void)trackCheckoutWithTransactionId:(NSString *)idTransaction total:(RITrackingTotal *)total
+{
+    RIDebugLog(@"Tracking checkout with transaction id: '%@'", idTransaction);
+    
+    [self dispatchEcommerceCall:^(id<RIEcommerceEventTracking> tracker) {
+        [tracker trackCheckoutWithTransactionId:idTransaction total:total];
+    }];
+}
+
+- (void)trackProductAddToCart:(RITrackingProduct *)product
+{
+    RIDebugLog(@"Tracking product added to cart: '%@'", product.identifier);
+    
+    // Trackers run later on their queues, the caller may change the product meanwhile
+    RITrackingProduct *addedProduct = [product copy];
+    
+    [self dispatchEcommerceCall:^(id<RIEcommerceEventTracking> tracker) {
+        [tracker trackProductAddToCart:addedProduct];
+    }];
+}
+
+- (void)trackRemoveFromCartForProductWithID:(NSString *)idTransaction quantity:(NSNumber *)quantity
+{
+    RIDebugLog(@"Tracking %@ of product removed from cart: '%@'", quantity, idTransaction);
+    
+    [self dispatchEcommerceCall:^(id<RIEcommerceEventTracking> tracker) {
+        [tracker trackRemoveFromCartForProductWithID:idTransaction quantity:quantity];
+    }];
+}
+
+#pragma mark - Configuration reload
+
+- (void)configurationDidChange:(NSNotification *)notification
+{
+    NSSet *keys = notification.userInfo[kRITrackingConfigurationChangedKeysKey];
+    
+    if (0 == keys.count) return;
+    
+    for (RIEventInbox *inbox in self.inboxes) {
+        id<RITracker> tracker = inbox.tracker;
+        if (![tracker respondsToSelector:@selector(configurationDidChangeKeys:)]) continue;
+        [inbox addOperationWithBlock:^{
+            [tracker configurationDidChangeKeys:keys];
+        } priority:RIEventInboxPriorityCritical];
     }
 }
 
@@ -223,6 +1103,7 @@ static dispatch_once_t sharedInstanceToken;
 
 + (void)reset
 {
+    [sharedInstance.pipeline stop];
     sharedInstance = nil;
     sharedInstanceToken = 0;
 }
@@ -0,0 +1,79 @@
+//
+//  RITrackingCart.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class RITrackingProduct;
+
+/**
+ *  State machine of a shopping cart, keyed by product identifier, for trackers implementing
+ *  RIEcommerceEventTracking.
+ *
+ *  Quantities and the total value are kept up to date on every change, a checkout costs the number
+ *  of products in the cart regardless of how many changes led there. The cart is persisted as a
+ *  snapshot of its products after every change, so it survives relaunches.
+ *
+ *  A cart is not thread safe, it is meant to be used from the queue of its tracker only.
+ */
+@interface RITrackingCart : NSObject
+
+/**
+ *  The number of distinct products in the cart
+ */
+@property (readonly) NSUInteger count;
+
+/**
+ *  The number of units of all products in the cart
+ */
+@property (readonly) NSUInteger quantity;
+
+/**
+ *  The sum of price times quantity of all products in the cart
+ */
+@property (readonly) NSDecimalNumber *value;
+
+/**
+ *  Create and initialize a `RITrackingCart` object, restoring the products persisted at a path
+ *
+ *  @param path (optional) Path of the file the cart is persisted to, nil to keep the cart in memory.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithPath:(NSString *)path;
+
+/**
+ *  Add units of a product to the cart. Name, price, currency and category of a product already in
+ *  the cart are replaced by the ones given.
+ *
+ *  @param product The product added, a nil quantity adds one unit.
+ */
+- (void)addProduct:(RITrackingProduct *)product;
+
+/**
+ *  Remove units of a product from the cart
+ *
+ *  @param identifier The identifier of the product.
+ *  @param quantity (optional) The number of units removed, nil to remove all units.
+ */
+- (void)removeProductWithIdentifier:(NSString *)identifier quantity:(NSNumber *)quantity;
+
+/**
+ *  The products in the cart, each with its quantity
+ *
+ *  @return The products
+ */
+- (NSArray *)products;
+
+/**
+ *  Empty the cart, returning its products
+ *
+ *  @return The products the cart held, each with its quantity
+ */
+- (NSArray *)checkout;
+
+@end
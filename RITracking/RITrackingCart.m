@@ -0,0 +1,232 @@
+//
+//  RITrackingCart.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RITrackingCart.h"
+#import "RITracking.h"
+
+/**
+ *  Short keys of a product in the persisted snapshot
+ */
+static NSString * const kRITrackingCartIdentifier = @"i";
+static NSString * const kRITrackingCartName = @"n";
+static NSString * const kRITrackingCartQuantity = @"q";
+static NSString * const kRITrackingCartPrice = @"p";
+static NSString * const kRITrackingCartCurrency = @"c";
+static NSString * const kRITrackingCartCategory = @"g";
+
+@interface RITrackingCart ()
+{
+    NSDecimal _value;
+}
+
+@property NSString *path;
+@property NSMutableDictionary *productsByIdentifier;
+@property (readwrite) NSUInteger quantity;
+
+@end
+
+@implementation RITrackingCart
+
+- (instancetype)initWithPath:(NSString *)path
+{
+    if ((self = [super init])) {
+        self.path = path;
+        self.productsByIdentifier = [NSMutableDictionary dictionary];
+        _value = [[NSDecimalNumber zero] decimalValue];
+        
+        if (path) [self restore];
+    }
+    return self;
+}
+
+- (NSUInteger)count
+{
+    return self.productsByIdentifier.count;
+}
+
+- (NSDecimalNumber *)value
+{
+    return [NSDecimalNumber decimalNumberWithDecimal:_value];
+}
+
+/**
+ *  Add or subtract the value of a number of units of a product from the total value
+ */
+- (void)addValueOfProduct:(RITrackingProduct *)product quantity:(NSInteger)quantity
+{
+    if (!product.price || 0 == quantity) return;
+    
+    NSDecimal price = [product.price decimalValue];
+    NSDecimal units = [@(quantity) decimalValue];
+    NSDecimal value;
+    NSDecimalMultiply(&value, &price, &units, NSRoundPlain);
+    NSDecimalAdd(&_value, &_value, &value, NSRoundPlain);
+}
+
+- (void)addProduct:(RITrackingProduct *)product
+{
+    if (!product.identifier) {
+        RIRaiseError(@"Missing identifier of product '%@' added to cart", product.name);
+        return;
+    }
+    
+    NSInteger quantity = product.quantity ? product.quantity.integerValue : 1;
+    
+    if (0 >= quantity) return;
+    
+    RITrackingProduct *current = self.productsByIdentifier[product.identifier];
+    RITrackingProduct *added = [product copy];
+    
+    if (current) {
+        // The units in the cart take the latest price
+        [self addValueOfProduct:current quantity:-current.quantity.integerValue];
+        quantity += current.quantity.integerValue;
+        self.quantity -= current.quantity.unsignedIntegerValue;
+    }
+    
+    added.quantity = @(quantity);
+    self.productsByIdentifier[added.identifier] = added;
+    self.quantity += (NSUInteger)quantity;
+    [self addValueOfProduct:added quantity:quantity];
+    
+    [self persist];
+}
+
+- (void)removeProductWithIdentifier:(NSString *)identifier quantity:(NSNumber *)quantity
+{
+    RITrackingProduct *current = identifier ? self.productsByIdentifier[identifier] : nil;
+    
+    if (!current) {
+        RIDebugLog(@"Product '%@' removed is not in the cart", identifier);
+        return;
+    }
+    
+    NSInteger units = current.quantity.integerValue;
+    NSInteger removed = quantity ? MIN(MAX(0, quantity.integerValue), units) : units;
+    
+    if (0 == removed) return;
+    
+    [self addValueOfProduct:current quantity:-removed];
+    self.quantity -= (NSUInteger)removed;
+    
+    if (removed == units) {
+        [self.productsByIdentifier removeObjectForKey:identifier];
+    } else {
+        current.quantity = @(units - removed);
+    }
+    
+    [self persist];
+}
+
+- (NSArray *)products
+{
+    NSMutableArray *products = [NSMutableArray arrayWithCapacity:self.productsByIdentifier.count];
+    
+    for (RITrackingProduct *product in self.productsByIdentifier.objectEnumerator) {
+        [products addObject:[product copy]];
+    }
+    
+    return [products copy];
+}
+
+- (NSArray *)checkout
+{
+    // The products are handed over, no need to copy them
+    NSArray *products = self.productsByIdentifier.allValues;
+    
+    self.productsByIdentifier = [NSMutableDictionary dictionary];
+    self.quantity = 0;
+    _value = [[NSDecimalNumber zero] decimalValue];
+    
+    [self persist];
+    
+    return products;
+}
+
+#pragma mark - Persistence
+
+- (void)persist
+{
+    if (!self.path) return;
+    
+    if (0 == self.productsByIdentifier.count) {
+        [[NSFileManager defaultManager] removeItemAtPath:self.path error:NULL];
+        return;
+    }
+    
+    NSMutableArray *snapshot = [NSMutableArray arrayWithCapacity:self.productsByIdentifier.count];
+    
+    for (RITrackingProduct *product in self.productsByIdentifier.objectEnumerator) {
+        NSMutableDictionary *entry = [NSMutableDictionary dictionaryWithCapacity:6];
+        entry[kRITrackingCartIdentifier] = product.identifier;
+        entry[kRITrackingCartQuantity] = product.quantity;
+        if (product.name) entry[kRITrackingCartName] = product.name;
+        if (product.price) entry[kRITrackingCartPrice] = product.price;
+        if (product.currency) entry[kRITrackingCartCurrency] = product.currency;
+        if (product.category) entry[kRITrackingCartCategory] = product.category;
+        [snapshot addObject:entry];
+    }
+    
+    NSError *error;
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:snapshot
+                                                              format:NSPropertyListBinaryFormat_v1_0
+                                                             options:0
+                                                               error:&error];
+    
+    if (!data) {
+        RIRaiseError(@"Unexpected error when serialising cart: %@", error);
+        return;
+    }
+    
+    [[NSFileManager defaultManager] createDirectoryAtPath:[self.path stringByDeletingLastPathComponent]
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:NULL];
+    
+    if (![data writeToFile:self.path options:NSDataWritingAtomic error:&error]) {
+        RILog(RILogLevelWarning, @"Failed to persist cart to path '%@': %@", self.path, error);
+    }
+}
+
+- (void)restore
+{
+    NSData *data = [NSData dataWithContentsOfFile:self.path];
+    
+    if (!data) return;
+    
+    NSArray *snapshot = [NSPropertyListSerialization propertyListWithData:data
+                                                                  options:NSPropertyListImmutable
+                                                                   format:NULL
+                                                                    error:NULL];
+    
+    if (![snapshot isKindOfClass:NSArray.class]) {
+        RILog(RILogLevelWarning, @"Discarding unreadable cart at path '%@'", self.path);
+        return;
+    }
+    
+    for (NSDictionary *entry in snapshot) {
+        if (![entry isKindOfClass:NSDictionary.class] || !entry[kRITrackingCartIdentifier]) continue;
+        
+        RITrackingProduct *product = [[RITrackingProduct alloc] init];
+        product.identifier = entry[kRITrackingCartIdentifier];
+        product.quantity = entry[kRITrackingCartQuantity];
+        product.name = entry[kRITrackingCartName];
+        product.price = entry[kRITrackingCartPrice];
+        product.currency = entry[kRITrackingCartCurrency];
+        product.category = entry[kRITrackingCartCategory];
+        
+        NSInteger quantity = product.quantity.integerValue;
+        if (0 >= quantity) continue;
+        
+        self.productsByIdentifier[product.identifier] = product;
+        self.quantity += (NSUInteger)quantity;
+        [self addValueOfProduct:product quantity:quantity];
+    }
+}
+
+@end
@@ -8,8 +8,62 @@
 
 #import <Foundation/Foundation.h>
 
+/**
+ *  Notification posted after a new configuration snapshot got published
+ */
+extern NSString * const kRITrackingConfigurationDidChangeNotification;
+
+/**
+ *  Key in the user info of kRITrackingConfigurationDidChangeNotification for the set of keys whose
+ *  values differ from the previous snapshot
+ */
+extern NSString * const kRITrackingConfigurationChangedKeysKey;
+
+/**
+ *  Key in the user info of kRITrackingConfigurationDidChangeNotification for the snapshot published
+ */
+extern NSString * const kRITrackingConfigurationSnapshotKey;
+
+/**
+ *  Immutable versioned view of the configuration of RITracking
+ */
+@interface RITrackingConfigurationSnapshot : NSObject
+
+/**
+ *  Version of the snapshot, increasing with every publication
+ */
+@property (readonly) uint64_t version;
+
+/**
+ *  The configuration settings. Snapshots loaded from a compiled configuration decode all values on
+ *  each access, prefer `objectForKey:`.
+ */
+@property (readonly) NSDictionary *properties;
+
+/**
+ *  Lookup a configuration value, given it's key
+ *
+ *  @param key The key to search
+ *
+ *  @return Returns the value for the given key
+ */
+- (id)objectForKey:(NSString *)key;
+
+/**
+ *  All keys of the configuration
+ *
+ *  @return The keys
+ */
+- (NSArray *)allKeys;
+
+@end
+
 /**
  *  RITrackingConfiguration has the configuration for RITracking
+ *
+ *  The configuration is published as immutable snapshots behind an atomic pointer. Readers never
+ *  lock and see either the previous or the next snapshot, never a partially loaded one. A superseded
+ *  snapshot is freed, along with its compiled configuration, once no reader holds it anymore.
  */
 @interface RITrackingConfiguration : NSObject
 
@@ -22,9 +76,21 @@
  */
 + (id)valueForKey:(NSString *)key;
 
+/**
+ *  The current configuration snapshot. Reading several keys from one snapshot gives a consistent
+ *  view even while the configuration is reloaded.
+ *
+ *  @return The current snapshot
+ */
++ (RITrackingConfigurationSnapshot *)snapshot;
+
 /**
  *  Loads a property list located in the given path to read the contained configuration settings
  *
+ *  The property list is compiled into a binary form in the caches directory, which is memory-mapped
+ *  on later loads as long as the source is unchanged. The settings are published as new snapshot, after which kRITrackingConfigurationDidChangeNotification
+ *  is posted. On failure an empty snapshot is published to avoid stale information.
+ *
  *  @param path The path where is the configuration file
  *
  *  @return True in case of sucess, false in case of error
@@ -8,54 +8,174 @@
 
 #import "RITrackingConfiguration.h"
 #import "RITracking.h"
+#import "RITrackingConfigurationCache.h"
+#import <sched.h>
 
-@interface RITrackingConfiguration ()
+NSString * const kRITrackingConfigurationDidChangeNotification =
+@"RITrackingConfigurationDidChangeNotification";
+NSString * const kRITrackingConfigurationChangedKeysKey = @"RITrackingConfigurationChangedKeys";
+NSString * const kRITrackingConfigurationSnapshotKey = @"RITrackingConfigurationSnapshot";
 
-@property NSDictionary *properties;
+@interface RITrackingConfigurationSnapshot ()
+
+@property (readwrite) uint64_t version;
+@property NSDictionary *dictionary;
+@property RITrackingConfigurationCache *cache;
 
 @end
 
-@implementation RITrackingConfiguration
+@implementation RITrackingConfigurationSnapshot
+
+- (NSDictionary *)properties
+{
+    return self.cache ? [self.cache dictionary] : self.dictionary;
+}
 
-static RITrackingConfiguration* sharedInstance;
-static dispatch_once_t sharedInstanceToken;
+- (id)objectForKey:(NSString *)key
+{
+    return self.cache ? [self.cache objectForKey:key] : self.dictionary[key];
+}
 
-+ (instancetype)sharedInstance
+- (NSArray *)allKeys
 {
-    dispatch_once(&sharedInstanceToken, ^{
-        sharedInstance = [[RITrackingConfiguration alloc] init];
-    });
-    return sharedInstance;
+    return self.cache ? [self.cache allKeys] : self.dictionary.allKeys;
 }
 
+@end
+
+@implementation RITrackingConfiguration
+
+/**
+ *  The current snapshot, retained while published
+ */
+static void *currentSnapshot;
+
+/**
+ *  Readers between loading the current snapshot and retaining it, counted in the slot of the reader
+ *  epoch they entered in. A superseded snapshot is released once both slots drained, so a reader
+ *  that loaded the pointer just before a reload never sees a deallocated snapshot.
+ */
+static uint64_t snapshotReaderEpoch;
+static uint64_t snapshotReaders[2];
+
 + (id)valueForKey:(NSString *)key
 {
-    return [RITrackingConfiguration sharedInstance].properties[key];
+    return [[RITrackingConfiguration snapshot] objectForKey:key];
+}
+
++ (RITrackingConfigurationSnapshot *)snapshot
+{
+    uint64_t slot = __atomic_load_n(&snapshotReaderEpoch, __ATOMIC_SEQ_CST) & 1;
+    __atomic_add_fetch(&snapshotReaders[slot], 1, __ATOMIC_SEQ_CST);
+    void *snapshot = __atomic_load_n(&currentSnapshot, __ATOMIC_SEQ_CST);
+    void *retained = snapshot ? (void *)CFBridgingRetain((__bridge id)snapshot) : NULL;
+    __atomic_sub_fetch(&snapshotReaders[slot], 1, __ATOMIC_RELEASE);
+    
+    if (!retained) {
+        static RITrackingConfigurationSnapshot *emptySnapshot;
+        static dispatch_once_t onceToken;
+        dispatch_once(&onceToken, ^{
+            emptySnapshot = [[RITrackingConfigurationSnapshot alloc] init];
+        });
+        return emptySnapshot;
+    }
+    
+    return CFBridgingRelease(retained);
+}
+
+/**
+ *  Release a snapshot no longer published, once no reader may still be about to retain it. Readers
+ *  entering meanwhile count in the other slot and load the snapshot published since, so waiting for
+ *  each slot after switching away from it does not starve.
+ */
++ (void)releaseSupersededSnapshot:(void *)snapshot
+{
+    if (!snapshot) return;
+    
+    for (NSUInteger idx = 0; idx < 2; idx++) {
+        uint64_t slot = __atomic_fetch_add(&snapshotReaderEpoch, 1, __ATOMIC_SEQ_CST) & 1;
+        while (0 != __atomic_load_n(&snapshotReaders[slot], __ATOMIC_ACQUIRE)) sched_yield();
+    }
+    
+    // The last release frees the snapshot and unmaps its compiled configuration
+    CFBridgingRelease(snapshot);
 }
 
 + (BOOL)loadFromPropertyListAtPath:(NSString *)path
 {
-    // Clear old values to avoid stale information
-    [RITrackingConfiguration sharedInstance].properties = nil;
+    RITrackingConfigurationCache *cache =
+    [RITrackingConfigurationCache cacheForPropertyListAtPath:path
+                                                   directory:[RITrackingConfiguration cacheDirectory]];
+    
+    if (cache) {
+        [RITrackingConfiguration publishProperties:nil cache:cache];
+        return YES;
+    }
     
     NSDictionary *properties = [NSDictionary dictionaryWithContentsOfFile:path];
     
+    // Clear old values to avoid stale information
+    [RITrackingConfiguration publishProperties:properties cache:nil];
+    
     if (!properties) {
         RIRaiseError(@"Missing properties when loading property file at path '%@'", path);
         return NO;
     }
     
-    [RITrackingConfiguration sharedInstance].properties = properties;
-    
     return YES;
 }
 
++ (NSString *)cacheDirectory
+{
+    NSString *caches = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES)
+                        firstObject] ?: NSTemporaryDirectory();
+    return [caches stringByAppendingPathComponent:@"RITrackingConfiguration"];
+}
+
++ (void)publishProperties:(NSDictionary *)properties cache:(RITrackingConfigurationCache *)cache
+{
+    RITrackingConfigurationSnapshot *snapshot = [[RITrackingConfigurationSnapshot alloc] init];
+    snapshot.dictionary = [properties copy];
+    snapshot.cache = cache;
+    
+    RITrackingConfigurationSnapshot *previous;
+    
+    @synchronized(self) {
+        previous = (__bridge RITrackingConfigurationSnapshot *)currentSnapshot;
+        snapshot.version = previous.version + 1;
+        
+        void *old = __atomic_exchange_n(&currentSnapshot, (void *)CFBridgingRetain(snapshot),
+                                        __ATOMIC_SEQ_CST);
+        [RITrackingConfiguration releaseSupersededSnapshot:old];
+    }
+    
+    NSMutableSet *changedKeys = [NSMutableSet setWithArray:[snapshot allKeys]];
+    NSArray *previousKeys = [previous allKeys];
+    
+    // Values are only compared on reload, the first load changes all keys without decoding
+    if (previousKeys.count) {
+        [changedKeys addObjectsFromArray:previousKeys];
+        for (NSString *key in [changedKeys allObjects]) {
+            id value = [snapshot objectForKey:key];
+            if (value && [value isEqual:[previous objectForKey:key]]) [changedKeys removeObject:key];
+        }
+    }
+    
+    [[NSNotificationCenter defaultCenter]
+     postNotificationName:kRITrackingConfigurationDidChangeNotification
+     object:self
+     userInfo:@{kRITrackingConfigurationChangedKeysKey: [changedKeys copy],
+                kRITrackingConfigurationSnapshotKey: snapshot}];
+}
+
 #pragma mark - Hidden test helpers
 
 + (void)clear
 {
-    sharedInstance = nil;
-    sharedInstanceToken = 0;
+    @synchronized(self) {
+        void *old = __atomic_exchange_n(&currentSnapshot, NULL, __ATOMIC_SEQ_CST);
+        [RITrackingConfiguration releaseSupersededSnapshot:old];
+    }
 }
 
 @end
@@ -0,0 +1,60 @@
+//
+//  RITrackingConfigurationCache.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Compiled binary form of a configuration property list, memory-mapped and read without full
+ *  deserialisation.
+ *
+ *  The file holds a table of entries sorted by key, so a value is found by binary search over the
+ *  mapped bytes. Strings, numbers and booleans are decoded straight from the mapping, other values
+ *  are stored as binary property lists and only decoded when accessed. The file is keyed by the size,
+ *  modification time and CRC32 of the source property list and compiled again when it changed.
+ */
+@interface RITrackingConfigurationCache : NSObject
+
+/**
+ *  Map the compiled form of a property list, compiling it first if missing or outdated
+ *
+ *  @param path The path of the source property list.
+ *  @param directory The directory holding compiled files.
+ *
+ *  @return The mapped configuration, or nil if the source is missing or invalid
+ */
++ (instancetype)cacheForPropertyListAtPath:(NSString *)path directory:(NSString *)directory;
+
+/**
+ *  The number of keys in the configuration
+ */
+@property (readonly) NSUInteger count;
+
+/**
+ *  Lookup a configuration value, given it's key
+ *
+ *  @param key The key to search
+ *
+ *  @return Returns the value for the given key
+ */
+- (id)objectForKey:(NSString *)key;
+
+/**
+ *  All keys of the configuration, in sorted order
+ *
+ *  @return The keys
+ */
+- (NSArray *)allKeys;
+
+/**
+ *  Decode the complete configuration
+ *
+ *  @return The configuration settings
+ */
+- (NSDictionary *)dictionary;
+
+@end
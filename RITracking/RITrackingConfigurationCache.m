@@ -0,0 +1,367 @@
+//
+//  RITrackingConfigurationCache.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RITrackingConfigurationCache.h"
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <fcntl.h>
+#import <unistd.h>
+#import <zlib.h>
+
+#define RI_CONFIGURATION_CACHE_MAGIC 0x46434952u /* "RICF" */
+#define RI_CONFIGURATION_CACHE_VERSION 1u
+
+typedef NS_ENUM(uint32_t, RITrackingConfigurationCacheType) {
+    RITrackingConfigurationCacheTypeString = 1,
+    RITrackingConfigurationCacheTypeInteger,
+    RITrackingConfigurationCacheTypeReal,
+    RITrackingConfigurationCacheTypeBoolean,
+    RITrackingConfigurationCacheTypePropertyList
+};
+
+/**
+ *  Identity of the source property list a compiled file was created from
+ */
+typedef struct RITrackingConfigurationCacheSource {
+    uint64_t size;
+    int64_t modificationSeconds;
+    int64_t modificationNanoseconds;
+    uint32_t crc;
+    uint32_t reserved;
+} RITrackingConfigurationCacheSource;
+
+typedef struct RITrackingConfigurationCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    RITrackingConfigurationCacheSource source;
+    uint32_t count;
+    uint32_t reserved;
+} RITrackingConfigurationCacheHeader;
+
+/**
+ *  Entry of the key table. Offsets are relative to the start of the file.
+ */
+typedef struct RITrackingConfigurationCacheEntry {
+    uint32_t keyOffset;
+    uint32_t keyLength;
+    uint32_t valueOffset;
+    uint32_t valueLength;
+    uint32_t type;
+    uint32_t reserved;
+} RITrackingConfigurationCacheEntry;
+
+static int RITrackingConfigurationCacheCompareKeys(const void *a, size_t aLength,
+                                                   const void *b, size_t bLength)
+{
+    int result = memcmp(a, b, MIN(aLength, bLength));
+    if (result) return result;
+    return aLength < bLength ? -1 : (aLength > bLength ? 1 : 0);
+}
+
+/**
+ *  Read size and modification time of the source, and its CRC32 unless the compiled file already
+ *  matches both
+ */
+static BOOL RITrackingConfigurationCacheReadSource(NSString *path,
+                                                   const RITrackingConfigurationCacheSource *compiled,
+                                                   RITrackingConfigurationCacheSource *source)
+{
+    int fd = open(path.fileSystemRepresentation, O_RDONLY);
+    if (fd < 0) return NO;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return NO;
+    }
+    
+    memset(source, 0, sizeof(*source));
+    source->size = (uint64_t)info.st_size;
+#ifdef __APPLE__
+    source->modificationSeconds = info.st_mtimespec.tv_sec;
+    source->modificationNanoseconds = info.st_mtimespec.tv_nsec;
+#else
+    source->modificationSeconds = info.st_mtim.tv_sec;
+    source->modificationNanoseconds = info.st_mtim.tv_nsec;
+#endif
+    
+    if (compiled && compiled->size == source->size &&
+        compiled->modificationSeconds == source->modificationSeconds &&
+        compiled->modificationNanoseconds == source->modificationNanoseconds) {
+        source->crc = compiled->crc;
+        close(fd);
+        return YES;
+    }
+    
+    void *bytes = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == bytes) return NO;
+    
+    source->crc = (uint32_t)crc32(0, bytes, (uInt)info.st_size);
+    munmap(bytes, (size_t)info.st_size);
+    return YES;
+}
+
+/**
+ *  Store the identity of the source in the header of a compiled file, so later loads of a source
+ *  touched without changing skip reading it again
+ */
+static void RITrackingConfigurationCacheWriteSource(NSString *compiledPath,
+                                                    const RITrackingConfigurationCacheSource *source)
+{
+    int fd = open(compiledPath.fileSystemRepresentation, O_WRONLY);
+    if (fd < 0) return;
+    
+    // A torn write only makes the next load check or compile the source again
+    pwrite(fd, source, sizeof(*source), offsetof(RITrackingConfigurationCacheHeader, source));
+    close(fd);
+}
+
+@interface RITrackingConfigurationCache ()
+{
+    const uint8_t *_bytes;
+    size_t _length;
+    const RITrackingConfigurationCacheEntry *_entries;
+}
+
+@property (readwrite) NSUInteger count;
+
+@end
+
+@implementation RITrackingConfigurationCache
+
++ (instancetype)cacheForPropertyListAtPath:(NSString *)path directory:(NSString *)directory
+{
+    if (0 == path.length) return nil;
+    
+    NSString *fileName = [NSString stringWithFormat:@"%08lx.ricf",
+                          crc32(0, (const Bytef *)path.UTF8String, (uInt)strlen(path.UTF8String))];
+    NSString *compiledPath = [directory stringByAppendingPathComponent:fileName];
+    
+    RITrackingConfigurationCache *cache = [[RITrackingConfigurationCache alloc]
+                                           initWithContentsOfFile:compiledPath];
+    
+    RITrackingConfigurationCacheSource source;
+    const RITrackingConfigurationCacheHeader *header = cache ? (const void *)cache->_bytes : NULL;
+    if (!RITrackingConfigurationCacheReadSource(path, header ? &header->source : NULL, &source)) {
+        return nil;
+    }
+    
+    // Content unchanged, even if the modification time differs
+    if (header && header->source.size == source.size && header->source.crc == source.crc) {
+        if (header->source.modificationSeconds != source.modificationSeconds ||
+            header->source.modificationNanoseconds != source.modificationNanoseconds) {
+            RITrackingConfigurationCacheWriteSource(compiledPath, &source);
+        }
+        return cache;
+    }
+    
+    NSDictionary *properties = [NSDictionary dictionaryWithContentsOfFile:path];
+    if (!properties) return nil;
+    
+    [[NSFileManager defaultManager] createDirectoryAtPath:directory
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:NULL];
+    
+    if (![self compileProperties:properties toPath:compiledPath source:&source]) return nil;
+    
+    return [[RITrackingConfigurationCache alloc] initWithContentsOfFile:compiledPath];
+}
+
++ (BOOL)compileProperties:(NSDictionary *)properties
+                   toPath:(NSString *)path
+                   source:(const RITrackingConfigurationCacheSource *)source
+{
+    NSArray *keys = [properties.allKeys sortedArrayUsingComparator:^NSComparisonResult(NSString *a,
+                                                                                       NSString *b) {
+        int result = RITrackingConfigurationCacheCompareKeys(a.UTF8String, strlen(a.UTF8String),
+                                                             b.UTF8String, strlen(b.UTF8String));
+        return result < 0 ? NSOrderedAscending : (result > 0 ? NSOrderedDescending : NSOrderedSame);
+    }];
+    
+    NSUInteger tableLength = sizeof(RITrackingConfigurationCacheHeader) +
+    keys.count * sizeof(RITrackingConfigurationCacheEntry);
+    NSMutableData *table = [NSMutableData dataWithLength:tableLength];
+    NSMutableData *data = [NSMutableData data];
+    
+    RITrackingConfigurationCacheHeader *header = table.mutableBytes;
+    header->magic = RI_CONFIGURATION_CACHE_MAGIC;
+    header->version = RI_CONFIGURATION_CACHE_VERSION;
+    header->source = *source;
+    header->count = (uint32_t)keys.count;
+    
+    RITrackingConfigurationCacheEntry *entries = (void *)(header + 1);
+    
+    for (NSUInteger idx = 0; idx < keys.count; idx++) {
+        NSString *key = keys[idx];
+        if (![key isKindOfClass:[NSString class]]) return NO;
+        id value = properties[key];
+        RITrackingConfigurationCacheEntry *entry = &entries[idx];
+        
+        entry->keyOffset = (uint32_t)(tableLength + data.length);
+        entry->keyLength = (uint32_t)strlen(key.UTF8String);
+        [data appendBytes:key.UTF8String length:entry->keyLength];
+        
+        NSData *valueData;
+        if ([value isKindOfClass:[NSString class]]) {
+            entry->type = RITrackingConfigurationCacheTypeString;
+            valueData = [value dataUsingEncoding:NSUTF8StringEncoding];
+        } else if ([value isKindOfClass:[NSNumber class]] &&
+                   CFGetTypeID((__bridge CFTypeRef)value) == CFBooleanGetTypeID()) {
+            entry->type = RITrackingConfigurationCacheTypeBoolean;
+            uint8_t boolean = [value boolValue];
+            valueData = [NSData dataWithBytes:&boolean length:sizeof(boolean)];
+        } else if ([value isKindOfClass:[NSNumber class]] &&
+                   CFNumberIsFloatType((__bridge CFNumberRef)value)) {
+            entry->type = RITrackingConfigurationCacheTypeReal;
+            double real = [value doubleValue];
+            valueData = [NSData dataWithBytes:&real length:sizeof(real)];
+        } else if ([value isKindOfClass:[NSNumber class]]) {
+            entry->type = RITrackingConfigurationCacheTypeInteger;
+            int64_t integer = [value longLongValue];
+            valueData = [NSData dataWithBytes:&integer length:sizeof(integer)];
+        } else {
+            entry->type = RITrackingConfigurationCacheTypePropertyList;
+            valueData = [NSPropertyListSerialization dataWithPropertyList:value
+                                                                   format:NSPropertyListBinaryFormat_v1_0
+                                                                  options:0
+                                                                    error:NULL];
+            if (!valueData) return NO;
+        }
+        
+        // Keep numbers aligned for direct reads from the mapping
+        [data increaseLengthBy:(8 - (tableLength + data.length) % 8) % 8];
+        entry->valueOffset = (uint32_t)(tableLength + data.length);
+        entry->valueLength = (uint32_t)valueData.length;
+        [data appendData:valueData];
+    }
+    
+    [table appendData:data];
+    return [table writeToFile:path atomically:YES];
+}
+
+- (instancetype)initWithContentsOfFile:(NSString *)path
+{
+    int fd = open(path.fileSystemRepresentation, O_RDONLY);
+    if (fd < 0) return nil;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(RITrackingConfigurationCacheHeader)) {
+        close(fd);
+        return nil;
+    }
+    
+    void *bytes = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == bytes) return nil;
+    
+    const RITrackingConfigurationCacheHeader *header = bytes;
+    size_t tableLength = sizeof(*header) + (size_t)header->count * sizeof(RITrackingConfigurationCacheEntry);
+    if (RI_CONFIGURATION_CACHE_MAGIC != header->magic ||
+        RI_CONFIGURATION_CACHE_VERSION != header->version || tableLength > (size_t)info.st_size) {
+        munmap(bytes, (size_t)info.st_size);
+        return nil;
+    }
+    
+    const RITrackingConfigurationCacheEntry *entries = (const void *)(header + 1);
+    for (uint32_t idx = 0; idx < header->count; idx++) {
+        if ((size_t)entries[idx].keyOffset + entries[idx].keyLength > (size_t)info.st_size ||
+            (size_t)entries[idx].valueOffset + entries[idx].valueLength > (size_t)info.st_size) {
+            munmap(bytes, (size_t)info.st_size);
+            return nil;
+        }
+    }
+    
+    if ((self = [super init])) {
+        _bytes = bytes;
+        _length = (size_t)info.st_size;
+        _entries = entries;
+        self.count = header->count;
+    } else {
+        munmap(bytes, (size_t)info.st_size);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_bytes) munmap((void *)_bytes, _length);
+}
+
+- (id)objectForKey:(NSString *)key
+{
+    const char *bytes = key.UTF8String;
+    size_t length = strlen(bytes);
+    NSUInteger low = 0;
+    NSUInteger high = self.count;
+    
+    while (low < high) {
+        NSUInteger middle = low + (high - low) / 2;
+        const RITrackingConfigurationCacheEntry *entry = &_entries[middle];
+        int result = RITrackingConfigurationCacheCompareKeys(_bytes + entry->keyOffset,
+                                                             entry->keyLength, bytes, length);
+        if (0 == result) return [self valueForEntry:entry];
+        if (result < 0) low = middle + 1; else high = middle;
+    }
+    
+    return nil;
+}
+
+- (id)valueForEntry:(const RITrackingConfigurationCacheEntry *)entry
+{
+    const uint8_t *value = _bytes + entry->valueOffset;
+    
+    switch ((RITrackingConfigurationCacheType)entry->type) {
+        case RITrackingConfigurationCacheTypeString:
+            return [[NSString alloc] initWithBytes:value
+                                            length:entry->valueLength
+                                          encoding:NSUTF8StringEncoding];
+        case RITrackingConfigurationCacheTypeInteger:
+            return @(*(const int64_t *)value);
+        case RITrackingConfigurationCacheTypeReal:
+            return @(*(const double *)value);
+        case RITrackingConfigurationCacheTypeBoolean:
+            return @((BOOL)*value);
+        case RITrackingConfigurationCacheTypePropertyList: {
+            NSData *data = [NSData dataWithBytesNoCopy:(void *)value
+                                                length:entry->valueLength
+                                          freeWhenDone:NO];
+            return [NSPropertyListSerialization propertyListWithData:data
+                                                             options:NSPropertyListImmutable
+                                                              format:NULL
+                                                               error:NULL];
+        }
+    }
+    
+    return nil;
+}
+
+- (NSArray *)allKeys
+{
+    NSMutableArray *keys = [NSMutableArray arrayWithCapacity:self.count];
+    for (NSUInteger idx = 0; idx < self.count; idx++) {
+        [keys addObject:[[NSString alloc] initWithBytes:_bytes + _entries[idx].keyOffset
+                                                 length:_entries[idx].keyLength
+                                               encoding:NSUTF8StringEncoding]];
+    }
+    return keys;
+}
+
+- (NSDictionary *)dictionary
+{
+    NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithCapacity:self.count];
+    NSArray *keys = [self allKeys];
+    for (NSUInteger idx = 0; idx < self.count; idx++) {
+        id value = [self valueForEntry:&_entries[idx]];
+        if (value) dictionary[keys[idx]] = value;
+    }
+    return dictionary;
+}
+
+@end
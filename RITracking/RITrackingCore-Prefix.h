@@ -0,0 +1,13 @@
+//
+//  RITrackingCore-Prefix.h
+//  RITracking
+//
+//  Prefix header of the headless core built by the GNUmakefile, in place of RITracking-Prefix.pch
+//  which pulls in UIKit. GNUstep's Foundation does not import CoreFoundation.
+//
+
+#ifdef __OBJC__
+    #import <Foundation/Foundation.h>
+    #import <CoreFoundation/CoreFoundation.h>
+    #import "RITracking.h"
+#endif
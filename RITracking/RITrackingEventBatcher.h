@@ -0,0 +1,42 @@
+//
+//  RITrackingEventBatcher.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Convenience controller to gather tracked events for a time window or up to a maximum count and
+ *  hand them on as one batch
+ */
+@interface RITrackingEventBatcher : NSObject
+
+/**
+ *  Create and initialize a `RITrackingEventBatcher` object
+ *
+ *  @param interval The time window in seconds, starting with the first event added to a batch.
+ *  @param maxCount The maximum number of events in a batch. Zero for no limit.
+ *  @param handler A handler to be called with each batch, serialised in order of the batches.
+ *
+ *  @return The object created
+ */
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                        maxCount:(NSUInteger)maxCount
+                         handler:(void (^)(NSArray *))handler;
+
+/**
+ *  Add an event to the current batch
+ *
+ *  @param event The event to add.
+ */
+- (void)addEvent:(id)event;
+
+/**
+ *  Hand on the current batch immediately, if it contains any events
+ */
+- (void)flush;
+
+@end
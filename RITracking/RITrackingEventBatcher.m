@@ -0,0 +1,91 @@
+//
+//  RITrackingEventBatcher.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RITrackingEventBatcher.h"
+
+typedef void(^RITrackingEventBatcherHandler)(NSArray *);
+
+@interface RITrackingEventBatcher ()
+
+@property (copy) RITrackingEventBatcherHandler handler;
+@property NSTimeInterval interval;
+@property NSUInteger maxCount;
+@property NSMutableArray *events;
+@property NSUInteger generation;
+@property dispatch_queue_t timerQueue;
+
+@end
+
+@implementation RITrackingEventBatcher
+
+- (instancetype)initWithInterval:(NSTimeInterval)interval
+                        maxCount:(NSUInteger)maxCount
+                         handler:(void (^)(NSArray *))handler
+{
+    if ((self = [super init])) {
+        self.handler = handler;
+        self.interval = interval;
+        self.maxCount = maxCount;
+        self.events = [NSMutableArray array];
+        self.timerQueue = dispatch_queue_create("de.rocket-internet.RITracking.batcher",
+                                                DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)addEvent:(id)event
+{
+    @synchronized(self) {
+        [self.events addObject:event];
+        
+        if (0 < self.maxCount && self.maxCount <= self.events.count) {
+            [self flushLocked];
+            return;
+        }
+        
+        if (1 == self.events.count) {
+            // The first event of a batch opens its time window
+            NSUInteger generation = self.generation;
+            __weak RITrackingEventBatcher *weakSelf = self;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.interval * NSEC_PER_SEC)),
+                           self.timerQueue, ^{
+                               [weakSelf flushGeneration:generation];
+                           });
+        }
+    }
+}
+
+- (void)flush
+{
+    @synchronized(self) {
+        [self flushLocked];
+    }
+}
+
+- (void)flushGeneration:(NSUInteger)generation
+{
+    @synchronized(self) {
+        // Skip if the batch of the expired time window was already handed on
+        if (generation != self.generation) return;
+        [self flushLocked];
+    }
+}
+
+- (void)flushLocked
+{
+    if (0 == self.events.count) return;
+    
+    NSArray *batch = self.events;
+    self.events = [NSMutableArray arrayWithCapacity:batch.count];
+    self.generation++;
+    
+    // Called while locked to keep batches in order
+    self.handler(batch);
+}
+
+@end
@@ -0,0 +1,56 @@
+//
+//  RIVocabulary.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Compact identifier of an interned name, zero for no name
+ */
+typedef uint32_t RIVocabularyIdentifier;
+
+/**
+ *  Identifier of no name, i.e. of nil
+ */
+#define RIVocabularyIdentifierNone ((RIVocabularyIdentifier)0)
+
+/**
+ *  Intern a name in the process wide vocabulary of event, action, category and screen names.
+ *
+ *  Names recently interned on the calling thread are found in a small per-thread cache without
+ *  locking. Interned names are kept for the lifetime of the process, so only up to the capacity of
+ *  the vocabulary are interned. Callers carry the names beyond as strings.
+ *
+ *  @param name The name to intern, may be nil.
+ *
+ *  @return The identifier of the name, RIVocabularyIdentifierNone for nil or if the vocabulary is full
+ */
+RIVocabularyIdentifier RIVocabularyIntern(NSString *name);
+
+/**
+ *  Set the number of names the vocabulary interns at most. Names already interned are kept, even
+ *  beyond a lower capacity. Defaults to 4096.
+ *
+ *  @param capacity The number of names.
+ */
+void RIVocabularySetCapacity(NSUInteger capacity);
+
+/**
+ *  Resolve an identifier to its name, without locking
+ *
+ *  @param identifier An identifier returned by RIVocabularyIntern.
+ *
+ *  @return The name, nil for RIVocabularyIdentifierNone
+ */
+NSString *RIVocabularyName(RIVocabularyIdentifier identifier);
+
+/**
+ *  The number of names interned
+ *
+ *  @return The count
+ */
+NSUInteger RIVocabularyCount(void);
@@ -0,0 +1,144 @@
+//
+//  RIVocabulary.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIVocabulary.h"
+#import <pthread.h>
+
+/**
+ *  Names are stored in fixed chunks that are never moved, so readers index them without locking
+ */
+#define RI_VOCABULARY_CHUNK_SIZE 4096
+#define RI_VOCABULARY_CHUNKS 4096
+
+/**
+ *  Default number of names interned at most
+ */
+#define RI_VOCABULARY_DEFAULT_CAPACITY 4096
+
+/**
+ *  Size of the direct-mapped per-thread cache of interned names
+ */
+#define RI_VOCABULARY_CACHE_SIZE 256
+
+typedef struct RIVocabularyCacheEntry {
+    CFStringRef name;
+    RIVocabularyIdentifier identifier;
+} RIVocabularyCacheEntry;
+
+static CFStringRef *RIVocabularyChunks[RI_VOCABULARY_CHUNKS];
+static uint32_t RIVocabularyNameCount;
+static uint32_t RIVocabularyCapacity = RI_VOCABULARY_DEFAULT_CAPACITY;
+static CFMutableDictionaryRef RIVocabularyIdentifiers;
+static pthread_mutex_t RIVocabularyMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t RIVocabularyCacheKey;
+static pthread_once_t RIVocabularyCacheKeyOnce = PTHREAD_ONCE_INIT;
+
+static void RIVocabularyCacheKeyCreate(void)
+{
+    // Cached names are owned by the shared table, so a thread's cache is simply freed on exit
+    pthread_key_create(&RIVocabularyCacheKey, free);
+}
+
+static RIVocabularyCacheEntry *RIVocabularyCache(void)
+{
+    pthread_once(&RIVocabularyCacheKeyOnce, RIVocabularyCacheKeyCreate);
+    RIVocabularyCacheEntry *entries = pthread_getspecific(RIVocabularyCacheKey);
+    if (!entries) {
+        entries = calloc(RI_VOCABULARY_CACHE_SIZE, sizeof(RIVocabularyCacheEntry));
+        pthread_setspecific(RIVocabularyCacheKey, entries);
+    }
+    return entries;
+}
+
+/**
+ *  Look up or add a name in the shared table
+ */
+static RIVocabularyIdentifier RIVocabularyInternShared(CFStringRef name, CFStringRef *storedName)
+{
+    pthread_mutex_lock(&RIVocabularyMutex);
+    
+    if (!RIVocabularyIdentifiers) {
+        RIVocabularyIdentifiers = CFDictionaryCreateMutable(kCFAllocatorDefault, 0,
+                                                            &kCFTypeDictionaryKeyCallBacks, NULL);
+    }
+    
+    const void *value;
+    RIVocabularyIdentifier identifier = RIVocabularyIdentifierNone;
+    
+    if (CFDictionaryGetValueIfPresent(RIVocabularyIdentifiers, name, &value)) {
+        identifier = (RIVocabularyIdentifier)(uintptr_t)value;
+    } else if (RIVocabularyNameCount < RIVocabularyCapacity) {
+        uint32_t idx = RIVocabularyNameCount;
+        CFStringRef *chunk = RIVocabularyChunks[idx / RI_VOCABULARY_CHUNK_SIZE];
+        if (!chunk) {
+            chunk = calloc(RI_VOCABULARY_CHUNK_SIZE, sizeof(CFStringRef));
+            __atomic_store_n(&RIVocabularyChunks[idx / RI_VOCABULARY_CHUNK_SIZE], chunk,
+                             __ATOMIC_RELEASE);
+        }
+        // Mutable names are copied, so the stored name never changes
+        CFStringRef copy = CFStringCreateCopy(kCFAllocatorDefault, name);
+        chunk[idx % RI_VOCABULARY_CHUNK_SIZE] = copy;
+        identifier = idx + 1;
+        CFDictionarySetValue(RIVocabularyIdentifiers, copy, (const void *)(uintptr_t)identifier);
+        __atomic_store_n(&RIVocabularyNameCount, idx + 1, __ATOMIC_RELEASE);
+    }
+    
+    if (identifier) *storedName = RIVocabularyChunks[(identifier - 1) / RI_VOCABULARY_CHUNK_SIZE]
+        [(identifier - 1) % RI_VOCABULARY_CHUNK_SIZE];
+    
+    pthread_mutex_unlock(&RIVocabularyMutex);
+    return identifier;
+}
+
+RIVocabularyIdentifier RIVocabularyIntern(NSString *name)
+{
+    if (!name) return RIVocabularyIdentifierNone;
+    
+    CFStringRef string = (__bridge CFStringRef)name;
+    RIVocabularyCacheEntry *entry = &RIVocabularyCache()[CFHash(string) % RI_VOCABULARY_CACHE_SIZE];
+    
+    if (entry->name && (entry->name == string || CFEqual(entry->name, string))) {
+        return entry->identifier;
+    }
+    
+    CFStringRef storedName = NULL;
+    RIVocabularyIdentifier identifier = RIVocabularyInternShared(string, &storedName);
+    
+    if (identifier) {
+        // Stored names live as long as the process, so the cache holds them without retaining
+        entry->name = storedName;
+        entry->identifier = identifier;
+    }
+    
+    return identifier;
+}
+
+void RIVocabularySetCapacity(NSUInteger capacity)
+{
+    pthread_mutex_lock(&RIVocabularyMutex);
+    RIVocabularyCapacity = (uint32_t)MIN(capacity, RI_VOCABULARY_CHUNKS * RI_VOCABULARY_CHUNK_SIZE);
+    pthread_mutex_unlock(&RIVocabularyMutex);
+}
+
+NSString *RIVocabularyName(RIVocabularyIdentifier identifier)
+{
+    if (RIVocabularyIdentifierNone == identifier) return nil;
+    
+    if (identifier > __atomic_load_n(&RIVocabularyNameCount, __ATOMIC_ACQUIRE)) return nil;
+    
+    uint32_t idx = identifier - 1;
+    CFStringRef *chunk = __atomic_load_n(&RIVocabularyChunks[idx / RI_VOCABULARY_CHUNK_SIZE],
+                                         __ATOMIC_ACQUIRE);
+    
+    return (__bridge NSString *)chunk[idx % RI_VOCABULARY_CHUNK_SIZE];
+}
+
+NSUInteger RIVocabularyCount(void)
+{
+    return __atomic_load_n(&RIVocabularyNameCount, __ATOMIC_ACQUIRE);
+}
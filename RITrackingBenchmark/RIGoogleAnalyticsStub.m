@@ -0,0 +1,201 @@
+//
+//  RIGoogleAnalyticsStub.m
+//  RITrackingBenchmark
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+//  Stand-in for the parts of the Google Analytics library the hit benchmark uses, as the library
+//  only ships for iOS. The builder keeps its parameters in a mutable dictionary and copies it on
+//  build, like the library's.
+//
+
+#import "GAIDictionaryBuilder.h"
+#import "GAIFields.h"
+
+NSString *const kGAIHitType = @"&t";
+NSString *const kGAIScreenName = @"&cd";
+
+NSString *const kGAIEventCategory = @"&ec";
+NSString *const kGAIEventAction = @"&ea";
+NSString *const kGAIEventLabel = @"&el";
+NSString *const kGAIEventValue = @"&ev";
+
+NSString *const kGAISocialNetwork = @"&sn";
+NSString *const kGAISocialAction = @"&sa";
+NSString *const kGAISocialTarget = @"&st";
+
+NSString *const kGAITransactionId = @"&ti";
+NSString *const kGAITransactionAffiliation = @"&ta";
+NSString *const kGAITransactionRevenue = @"&tr";
+NSString *const kGAITransactionShipping = @"&ts";
+NSString *const kGAITransactionTax = @"&tt";
+NSString *const kGAICurrencyCode = @"&cu";
+
+NSString *const kGAIItemPrice = @"&ip";
+NSString *const kGAIItemQuantity = @"&iq";
+NSString *const kGAIItemSku = @"&ic";
+NSString *const kGAIItemName = @"&in";
+NSString *const kGAIItemCategory = @"&iv";
+
+NSString *const kGAITimingCategory = @"&utc";
+NSString *const kGAITimingVar = @"&utv";
+NSString *const kGAITimingValue = @"&utt";
+NSString *const kGAITimingLabel = @"&utl";
+
+NSString *const kGAIExDescription = @"&exd";
+NSString *const kGAIExFatal = @"&exf";
+
+NSString *const kGAIAppView = @"appview";
+NSString *const kGAIEvent = @"event";
+NSString *const kGAISocial = @"social";
+NSString *const kGAITransaction = @"transaction";
+NSString *const kGAIItem = @"item";
+NSString *const kGAIException = @"exception";
+NSString *const kGAITiming = @"timing";
+
+@interface GAIDictionaryBuilder ()
+
+@property NSMutableDictionary *parameters;
+
+@end
+
+@implementation GAIDictionaryBuilder
+
+- (instancetype)init
+{
+    if ((self = [super init])) {
+        self.parameters = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (GAIDictionaryBuilder *)set:(NSString *)value forKey:(NSString *)key
+{
+    self.parameters[key] = value ?: (id)[NSNull null];
+    return self;
+}
+
+- (GAIDictionaryBuilder *)setAll:(NSDictionary *)params
+{
+    for (id key in params) {
+        id value = params[key];
+        if (![key isKindOfClass:NSString.class]) continue;
+        if ([value isKindOfClass:NSString.class] || [value isKindOfClass:NSNull.class]) {
+            self.parameters[key] = value;
+        }
+    }
+    return self;
+}
+
+- (NSString *)get:(NSString *)paramName
+{
+    id value = self.parameters[paramName];
+    return [value isKindOfClass:NSString.class] ? value : nil;
+}
+
+- (NSMutableDictionary *)build
+{
+    return [self.parameters mutableCopy];
+}
+
+- (GAIDictionaryBuilder *)setCampaignParametersFromUrl:(NSString *)urlString
+{
+    // Campaign parameters are not part of any hit measured
+    return self;
+}
+
++ (GAIDictionaryBuilder *)createAppView
+{
+    return [[[GAIDictionaryBuilder alloc] init] set:kGAIAppView forKey:kGAIHitType];
+}
+
++ (GAIDictionaryBuilder *)createEventWithCategory:(NSString *)category
+                                           action:(NSString *)action
+                                            label:(NSString *)label
+                                            value:(NSNumber *)value
+{
+    GAIDictionaryBuilder *builder = [[GAIDictionaryBuilder alloc] init];
+    [builder set:kGAIEvent forKey:kGAIHitType];
+    [builder set:category forKey:kGAIEventCategory];
+    [builder set:action forKey:kGAIEventAction];
+    [builder set:label forKey:kGAIEventLabel];
+    [builder set:[value stringValue] forKey:kGAIEventValue];
+    return builder;
+}
+
++ (GAIDictionaryBuilder *)createExceptionWithDescription:(NSString *)description
+                                               withFatal:(NSNumber *)fatal
+{
+    GAIDictionaryBuilder *builder = [[GAIDictionaryBuilder alloc] init];
+    [builder set:kGAIException forKey:kGAIHitType];
+    [builder set:description forKey:kGAIExDescription];
+    [builder set:[fatal stringValue] forKey:kGAIExFatal];
+    return builder;
+}
+
++ (GAIDictionaryBuilder *)createItemWithTransactionId:(NSString *)transactionId
+                                                 name:(NSString *)name
+                                                  sku:(NSString *)sku
+                                             category:(NSString *)category
+                                                price:(NSNumber *)price
+                                             quantity:(NSNumber *)quantity
+                                         currencyCode:(NSString *)currencyCode
+{
+    GAIDictionaryBuilder *builder = [[GAIDictionaryBuilder alloc] init];
+    [builder set:kGAIItem forKey:kGAIHitType];
+    [builder set:transactionId forKey:kGAITransactionId];
+    [builder set:name forKey:kGAIItemName];
+    [builder set:sku forKey:kGAIItemSku];
+    [builder set:category forKey:kGAIItemCategory];
+    [builder set:[price stringValue] forKey:kGAIItemPrice];
+    [builder set:[quantity stringValue] forKey:kGAIItemQuantity];
+    [builder set:currencyCode forKey:kGAICurrencyCode];
+    return builder;
+}
+
++ (GAIDictionaryBuilder *)createSocialWithNetwork:(NSString *)network
+                                           action:(NSString *)action
+                                           target:(NSString *)target
+{
+    GAIDictionaryBuilder *builder = [[GAIDictionaryBuilder alloc] init];
+    [builder set:kGAISocial forKey:kGAIHitType];
+    [builder set:network forKey:kGAISocialNetwork];
+    [builder set:action forKey:kGAISocialAction];
+    [builder set:target forKey:kGAISocialTarget];
+    return builder;
+}
+
++ (GAIDictionaryBuilder *)createTimingWithCategory:(NSString *)category
+                                          interval:(NSNumber *)intervalMillis
+                                              name:(NSString *)name
+                                             label:(NSString *)label
+{
+    GAIDictionaryBuilder *builder = [[GAIDictionaryBuilder alloc] init];
+    [builder set:kGAITiming forKey:kGAIHitType];
+    [builder set:category forKey:kGAITimingCategory];
+    [builder set:[intervalMillis stringValue] forKey:kGAITimingValue];
+    [builder set:name forKey:kGAITimingVar];
+    [builder set:label forKey:kGAITimingLabel];
+    return builder;
+}
+
++ (GAIDictionaryBuilder *)createTransactionWithId:(NSString *)transactionId
+                                      affiliation:(NSString *)affiliation
+                                          revenue:(NSNumber *)revenue
+                                              tax:(NSNumber *)tax
+                                         shipping:(NSNumber *)shipping
+                                     currencyCode:(NSString *)currencyCode
+{
+    GAIDictionaryBuilder *builder = [[GAIDictionaryBuilder alloc] init];
+    [builder set:kGAITransaction forKey:kGAIHitType];
+    [builder set:transactionId forKey:kGAITransactionId];
+    [builder set:affiliation forKey:kGAITransactionAffiliation];
+    [builder set:[revenue stringValue] forKey:kGAITransactionRevenue];
+    [builder set:[tax stringValue] forKey:kGAITransactionTax];
+    [builder set:[shipping stringValue] forKey:kGAITransactionShipping];
+    [builder set:currencyCode forKey:kGAICurrencyCode];
+    return builder;
+}
+
+@end
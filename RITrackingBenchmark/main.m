@@ -0,0 +1,460 @@
+//
+//  main.m
+//  RITrackingBenchmark
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <time.h>
+#import <sys/resource.h>
+#import <dispatch/dispatch.h>
+#ifdef __APPLE__
+#import <mach/mach.h>
+#endif
+#import "RITracking.h"
+#import "RITrackerRegistry.h"
+#import "RIEventInbox.h"
+#import "RIGoogleAnalyticsHitTemplate.h"
+#import "RIGoogleAnalyticsMock.h"
+#import "GAIDictionaryBuilder.h"
+#import "GAIFields.h"
+
+static NSString * const kRIBenchmarkTrackerKey = @"RITrackingBenchmarkTracker";
+static NSUInteger const kRIBenchmarkDefaultCallCount = 100000;
+static NSUInteger const kRIBenchmarkDefaultTrackerCount = 4;
+static NSUInteger const kRIBenchmarkWarmUpCount = 1000;
+
+/**
+ *  Numbers of stub trackers the executor scaling benchmark runs with
+ */
+static NSUInteger const kRIBenchmarkScalingTrackerCounts[] = {2, 8, 32};
+
+#pragma mark - Allocation counting
+
+#ifdef __GLIBC__
+
+/**
+ *  Count every allocation of the process by interposing the allocator, glibc's own functions do the
+ *  allocation
+ */
+#define RI_BENCHMARK_COUNTS_ALLOCATIONS 1
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+static uint64_t RIBenchmarkAllocationCount;
+
+void *malloc(size_t size)
+{
+    __atomic_add_fetch(&RIBenchmarkAllocationCount, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    __atomic_add_fetch(&RIBenchmarkAllocationCount, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    __atomic_add_fetch(&RIBenchmarkAllocationCount, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(pointer, size);
+}
+
+#endif
+
+static uint64_t RIBenchmarkAllocations(void)
+{
+#ifdef RI_BENCHMARK_COUNTS_ALLOCATIONS
+    return __atomic_load_n(&RIBenchmarkAllocationCount, __ATOMIC_RELAXED);
+#else
+    return 0;
+#endif
+}
+
+static uint64_t RIBenchmarkNow(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * NSEC_PER_SEC + (uint64_t)time.tv_nsec;
+}
+
+/**
+ *  The number of threads of the process
+ */
+static NSUInteger RIBenchmarkThreadCount(void)
+{
+#ifdef __APPLE__
+    thread_act_array_t threads;
+    mach_msg_type_number_t count = 0;
+    if (KERN_SUCCESS != task_threads(mach_task_self(), &threads, &count)) return 0;
+    vm_deallocate(mach_task_self(), (vm_address_t)threads, count * sizeof(thread_act_t));
+    return count;
+#else
+    NSUInteger count = 0;
+    char line[256];
+    FILE *status = fopen("/proc/self/status", "r");
+    while (status && fgets(line, sizeof(line), status)) {
+        if (1 == sscanf(line, "Threads: %lu", (unsigned long *)&count)) break;
+    }
+    if (status) fclose(status);
+    return count;
+#endif
+}
+
+/**
+ *  The number of voluntary and involuntary context switches of the process
+ */
+static uint64_t RIBenchmarkContextSwitches(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)usage.ru_nvcsw + (uint64_t)usage.ru_nivcsw;
+}
+
+static int RIBenchmarkCompare(const void *a, const void *b)
+{
+    uint64_t left = *(const uint64_t *)a;
+    uint64_t right = *(const uint64_t *)b;
+    return left < right ? -1 : left > right;
+}
+
+#pragma mark - Stub tracker
+
+/**
+ *  Tracker implementing all tracking protocols, only counting its calls
+ */
+@interface RIBenchmarkTracker : NSObject
+<
+    RITracker,
+    RIEventTracking,
+    RIScreenTracking,
+    RIExceptionTracking,
+    RIOpenURLTracking,
+    RIEcommerceEventTracking
+>
+
+@end
+
+static NSMutableArray *RIBenchmarkTrackers;
+
+@implementation RIBenchmarkTracker
+{
+    uint64_t _callCount;
+}
+
+@synthesize queue;
+
+- (instancetype)init
+{
+    if ((self = [super init])) {
+        self.queue = [[NSOperationQueue alloc] init];
+        self.queue.maxConcurrentOperationCount = 1;
+    }
+    return self;
+}
+
+- (void)countCall
+{
+    __atomic_add_fetch(&_callCount, 1, __ATOMIC_RELAXED);
+}
+
+- (void)applicationDidLaunchWithOptions:(NSDictionary *)options
+{
+}
+
+- (void)trackEvent:(NSString *)event
+             value:(NSNumber *)value
+            action:(NSString *)action
+          category:(NSString *)category
+              data:(NSDictionary *)data
+{
+    [self countCall];
+}
+
+- (void)trackScreenWithName:(NSString *)name
+{
+    [self countCall];
+}
+
+- (void)trackExceptionWithName:(NSString *)name
+{
+    [self countCall];
+}
+
+- (void)trackOpenURL:(NSURL *)url
+{
+    [self countCall];
+}
+
+- (void)registerHandler:(void (^)(NSDictionary *))handlerBlock forOpenURLPattern:(NSString *)pattern
+{
+}
+
+- (void)registerHandlersForOpenURLPatterns:(NSArray *)routes
+{
+}
+
+- (void)trackCheckoutWithTransactionId:(NSString *)idTransaction total:(RITrackingTotal *)total
+{
+    [self countCall];
+}
+
+- (void)trackProductAddToCart:(RITrackingProduct *)product
+{
+    [self countCall];
+}
+
+- (void)trackRemoveFromCartForProductWithID:(NSString *)idTransaction quantity:(NSNumber *)quantity
+{
+    [self countCall];
+}
+
+@end
+
+#pragma mark - Benchmark
+
+/**
+ *  Time a tracking call made a number of times, until all trackers processed the calls
+ */
+static void RIBenchmarkRun(NSString *name, NSUInteger count, void (^call)(NSUInteger idx))
+{
+    uint64_t *latencies = malloc(count * sizeof(uint64_t));
+    
+    for (NSUInteger idx = 0; idx < kRIBenchmarkWarmUpCount; idx++) {
+        @autoreleasepool {
+            call(idx);
+        }
+    }
+    for (RIBenchmarkTracker *tracker in RIBenchmarkTrackers) {
+        [tracker.queue waitUntilAllOperationsAreFinished];
+    }
+    
+    uint64_t allocations = RIBenchmarkAllocations();
+    uint64_t start = RIBenchmarkNow();
+    
+    @autoreleasepool {
+        for (NSUInteger idx = 0; idx < count; idx++) {
+            uint64_t callStart = RIBenchmarkNow();
+            call(idx);
+            latencies[idx] = RIBenchmarkNow() - callStart;
+        }
+    }
+    
+    uint64_t called = RIBenchmarkNow();
+    
+    for (RIBenchmarkTracker *tracker in RIBenchmarkTrackers) {
+        [tracker.queue waitUntilAllOperationsAreFinished];
+    }
+    
+    uint64_t processed = RIBenchmarkNow();
+    allocations = RIBenchmarkAllocations() - allocations;
+    
+    qsort(latencies, count, sizeof(uint64_t), RIBenchmarkCompare);
+    
+    printf("%-36s %12.0f calls/s %12.0f events/s  p50 %7llu ns  p99 %7llu ns  %7.2f allocs/call\n",
+           name.UTF8String,
+           count / ((called - start) / (double)NSEC_PER_SEC),
+           count / ((processed - start) / (double)NSEC_PER_SEC),
+           (unsigned long long)latencies[count / 2],
+           (unsigned long long)latencies[MIN(count - 1, count * 99 / 100)],
+           allocations / (double)count);
+    
+    free(latencies);
+}
+
+/**
+ *  Fan screen views out to a number of stub trackers through their inboxes, running on the trackers'
+ *  own queues or as lanes of the shared executor, until all trackers processed them
+ */
+static void RIBenchmarkScaling(NSUInteger trackerCount, NSUInteger count, BOOL shared)
+{
+    NSMutableArray *trackers = [NSMutableArray arrayWithCapacity:trackerCount];
+    NSMutableArray *inboxes = [NSMutableArray arrayWithCapacity:trackerCount];
+    RIEventExecutor *executor = shared ? [RIEventExecutor sharedExecutor] : nil;
+    
+    for (NSUInteger idx = 0; idx < trackerCount; idx++) {
+        RIBenchmarkTracker *tracker = [[RIBenchmarkTracker alloc] init];
+        RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+        inbox.executor = executor;
+        [trackers addObject:tracker];
+        [inboxes addObject:inbox];
+    }
+    
+    NSUInteger threadCount = 0;
+    uint64_t contextSwitches = RIBenchmarkContextSwitches();
+    uint64_t start = RIBenchmarkNow();
+    
+    @autoreleasepool {
+        for (NSUInteger idx = 0; idx < count; idx++) {
+            RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"screen");
+            RIEventArenaRecord *arenaRecord = RIEventArenaRecordCreate(&record, trackerCount, nil);
+            for (RIEventInbox *inbox in inboxes) {
+                [inbox addRecord:arenaRecord];
+            }
+            // Sample while the trackers are busy
+            if (idx == count / 2) threadCount = RIBenchmarkThreadCount();
+        }
+    }
+    
+    if (executor) {
+        [executor waitUntilIdle];
+    } else {
+        for (RIBenchmarkTracker *tracker in trackers) {
+            [tracker.queue waitUntilAllOperationsAreFinished];
+        }
+    }
+    
+    uint64_t processed = RIBenchmarkNow();
+    contextSwitches = RIBenchmarkContextSwitches() - contextSwitches;
+    
+    printf("%-17s %2lu trackers  %3lu threads  %9llu context switches  %12.0f events/s\n",
+           shared ? "shared executor" : "queue per tracker", (unsigned long)trackerCount,
+           (unsigned long)threadCount, (unsigned long long)contextSwitches,
+           count * trackerCount / ((processed - start) / (double)NSEC_PER_SEC));
+}
+
+/**
+ *  Time building Google Analytics event hits and sending them to the stand-in tracker, with a
+ *  dictionary builder per hit as the adapter did before and with the adapter's hit template
+ */
+static void RIBenchmarkHits(NSString *name, NSUInteger count, NSDictionary *(^hit)(NSNumber *value))
+{
+    RIGoogleAnalyticsMockTracker *tracker = [[RIGoogleAnalyticsMockTracker alloc] init];
+    // Only count the hits
+    tracker.hits = nil;
+    
+    uint64_t allocations = RIBenchmarkAllocations();
+    uint64_t start = RIBenchmarkNow();
+    
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        @autoreleasepool {
+            [tracker send:hit(@(idx))];
+        }
+    }
+    
+    uint64_t elapsed = RIBenchmarkNow() - start;
+    allocations = RIBenchmarkAllocations() - allocations;
+    
+    printf("%-36s %12.0f hits/s  %7.0f ns/hit  %7.2f allocs/hit\n",
+           name.UTF8String,
+           tracker.hitCount / (elapsed / (double)NSEC_PER_SEC),
+           elapsed / (double)tracker.hitCount,
+           allocations / (double)tracker.hitCount);
+}
+
+int main(int argc, const char *argv[])
+{
+    @autoreleasepool {
+        NSUInteger count = 1 < argc ? (NSUInteger)strtoul(argv[1], NULL, 10) : 0;
+        NSUInteger trackerCount = 2 < argc ? (NSUInteger)strtoul(argv[2], NULL, 10) : 0;
+        count = count ?: kRIBenchmarkDefaultCallCount;
+        trackerCount = trackerCount ?: kRIBenchmarkDefaultTrackerCount;
+        
+        RILogSetLevel(RILogLevelWarning);
+        
+        RIBenchmarkTrackers = [NSMutableArray array];
+        for (NSUInteger idx = 0; idx < trackerCount; idx++) {
+            [RITrackerRegistry registerTrackerNamed:[NSString stringWithFormat:@"RIBenchmarkTracker%lu",
+                                                     (unsigned long)idx]
+                          requiredConfigurationKeys:@[kRIBenchmarkTrackerKey]
+                                            factory:^id<RITracker>{
+                                                RIBenchmarkTracker *tracker = [[RIBenchmarkTracker alloc] init];
+                                                [RIBenchmarkTrackers addObject:tracker];
+                                                return tracker;
+                                            }];
+        }
+        
+        NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"RITrackingBenchmark.plist"];
+        [@{kRIBenchmarkTrackerKey: @YES} writeToFile:path atomically:YES];
+        
+        RITracking *tracking = [RITracking sharedInstance];
+        [tracking startWithConfigurationFromPropertyListAtPath:path launchOptions:nil];
+        [tracking registerHandler:^(NSDictionary *parameters) {
+        } forOpenURLPattern:@".*/{sku}/p\\.html.*"];
+        
+        printf("RITrackingBenchmark: %lu calls to %lu stub trackers per API%s\n", (unsigned long)count,
+               (unsigned long)RIBenchmarkTrackers.count,
+#ifdef RI_BENCHMARK_COUNTS_ALLOCATIONS
+               ""
+#else
+               ", allocations not counted on this platform"
+#endif
+               );
+        
+        NSNumber *value = @42;
+        NSURL *url = [NSURL URLWithString:@"ritracking://shop/12345/p.html?ref=benchmark"];
+        RITrackingProduct *product = [[RITrackingProduct alloc] init];
+        product.identifier = @"12345";
+        product.name = @"Benchmark product";
+        product.price = @9.99;
+        product.quantity = @1;
+        RITrackingTotal *total = [[RITrackingTotal alloc] init];
+        total.net = @9.99;
+        total.currency = @"EUR";
+        
+        RIBenchmarkRun(@"trackEvent:value:action:category:data:", count, ^(NSUInteger idx) {
+            [tracking trackEvent:@"event" value:value action:@"action" category:@"category" data:nil];
+        });
+        RIBenchmarkRun(@"trackScreenWithName:", count, ^(NSUInteger idx) {
+            [tracking trackScreenWithName:@"screen"];
+        });
+        RIBenchmarkRun(@"trackExceptionWithName:", count, ^(NSUInteger idx) {
+            [tracking trackExceptionWithName:@"exception"];
+        });
+        RIBenchmarkRun(@"trackOpenURL:", count, ^(NSUInteger idx) {
+            [tracking trackOpenURL:url];
+        });
+        RIBenchmarkRun(@"trackProductAddToCart:", count, ^(NSUInteger idx) {
+            [tracking trackProductAddToCart:product];
+        });
+        RIBenchmarkRun(@"trackRemoveFromCartForProductWithID:", count, ^(NSUInteger idx) {
+            [tracking trackRemoveFromCartForProductWithID:@"12345" quantity:@1];
+        });
+        RIBenchmarkRun(@"trackCheckoutWithTransactionId:total:", count, ^(NSUInteger idx) {
+            [tracking trackCheckoutWithTransactionId:@"transaction" total:total];
+        });
+        
+#if RI_TRACKER_METRICS
+        for (RITrackerMetricsSnapshot *snapshot in [tracking trackerMetricsSnapshots]) {
+            printf("%s\n", snapshot.description.UTF8String);
+        }
+#endif
+        
+        printf("\nRITrackingBenchmark: %lu screen views fanned out, shared executor of %lu workers\n",
+               (unsigned long)count, (unsigned long)[RIEventExecutor sharedExecutor].workerCount);
+        
+        for (size_t idx = 0; idx < sizeof(kRIBenchmarkScalingTrackerCounts) / sizeof(NSUInteger); idx++) {
+            RIBenchmarkScaling(kRIBenchmarkScalingTrackerCounts[idx], count, NO);
+            RIBenchmarkScaling(kRIBenchmarkScalingTrackerCounts[idx], count, YES);
+        }
+        
+        printf("\nRITrackingBenchmark: %lu Google Analytics event hits to a stand-in tracker\n",
+               (unsigned long)count);
+        
+        RIGoogleAnalyticsHitTemplate *eventTemplate =
+        [[RIGoogleAnalyticsHitTemplate alloc] initWithHit:[[GAIDictionaryBuilder createEventWithCategory:nil
+                                                                                                  action:nil
+                                                                                                   label:nil
+                                                                                                   value:nil] build]
+                                                   fields:@[kGAIEventCategory, kGAIEventAction, kGAIEventLabel, kGAIEventValue]];
+        
+        RIBenchmarkHits(@"dictionary builder per hit", count, ^NSDictionary *(NSNumber *value) {
+            return [[GAIDictionaryBuilder createEventWithCategory:@"category"
+                                                           action:@"action"
+                                                            label:@"label"
+                                                            value:value] build];
+        });
+        RIBenchmarkHits(@"hit template", count, ^NSDictionary *(NSNumber *value) {
+            id values[] = {@"category", @"action", @"label", value};
+            return [eventTemplate hitWithValues:values];
+        });
+        
+        [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    }
+    return 0;
+}
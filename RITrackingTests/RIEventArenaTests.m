@@ -0,0 +1,223 @@
+//
+//  RIEventArenaTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+#import "RIEventArena.h"
+#import "RIEventInbox.h"
+#import "RITrackerRegistry.h"
+#import "MBBlockSwizzle.h"
+#import "XCTestCase+AsyncTesting.h"
+#import "RITrackerMock.h"
+
+static NSString * const kRIEventArenaTestsKey = @"RIEventArenaTestsKey";
+static NSUInteger const kRIEventArenaTestsTrackerCount = 4;
+static NSUInteger const kBenchmarkEventCount = 10000;
+
+@interface RITracking ()
+
+@property NSArray *trackers;
+
++ (void)reset;
+
+@end
+
+@interface RITrackingConfiguration ()
+
++ (void)clear;
+
+@end
+
+static size_t RIBenchmarkBlocksInUse(void)
+{
+    malloc_statistics_t statistics;
+    malloc_zone_statistics(NULL, &statistics);
+    return statistics.blocks_in_use;
+}
+
+@interface RIEventArenaTests : XCTestCase
+
+@end
+
+@implementation RIEventArenaTests
+
++ (void)setUp
+{
+    for (NSUInteger idx = 0; idx < kRIEventArenaTestsTrackerCount; idx++) {
+        [RITrackerRegistry registerTrackerNamed:[NSString stringWithFormat:@"RIEventArenaTests%lu",
+                                                 (unsigned long)idx]
+                      requiredConfigurationKeys:@[kRIEventArenaTestsKey]
+                                        factory:^id<RITracker>{
+                                            return [[RITrackerMock alloc] init];
+                                        }];
+    }
+}
+
+- (void)setUp
+{
+    [super setUp];
+    [RITrackingConfiguration clear];
+    [RITracking reset];
+}
+
+- (void)tearDown
+{
+    [RITrackingConfiguration clear];
+    [RITracking reset];
+    [super tearDown];
+}
+
+- (void)testArenaRecyclesBlocksFreedOnAnyThread
+{
+    void *blocks[256];
+    for (NSUInteger idx = 0; idx < 256; idx++) {
+        blocks[idx] = RIEventArenaAllocate();
+    }
+    
+    dispatch_apply(256, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t idx) {
+        RIEventArenaFree(blocks[idx]);
+    });
+    
+    uint64_t slabCount = RIEventArenaSlabCount();
+    for (NSUInteger idx = 0; idx < 256; idx++) {
+        blocks[idx] = RIEventArenaAllocate();
+    }
+    
+    NSAssert(slabCount == RIEventArenaSlabCount(), @"Expected freed blocks to be reused");
+    
+    for (NSUInteger idx = 0; idx < 256; idx++) {
+        RIEventArenaFree(blocks[idx]);
+    }
+}
+
+- (void)testArenaRecordIsDisposedOnceConsumedByAllTrackers
+{
+    __weak id weakData;
+    RIEventArenaRecord *arenaRecord;
+    
+    @autoreleasepool {
+        NSDictionary *data = [NSDictionary dictionaryWithObject:[[NSUUID UUID] UUIDString] forKey:@"foo"];
+        weakData = data;
+        RIEventRecord record = RIEventRecordMakeEvent(@"event", @1.5, nil, nil, data);
+        arenaRecord = RIEventArenaRecordCreate(&record, 2, nil);
+    }
+    
+    NSAssert(RIEventRecordValueTypeReal == arenaRecord->record.value.type &&
+             1.5 == arenaRecord->record.value.real, @"Expected value to be held inline");
+    
+    RIEventArenaRecordConsume(arenaRecord);
+    NSAssert(nil != weakData, @"Expected record to be kept until consumed by all trackers");
+    
+    RIEventArenaRecordConsume(arenaRecord);
+    NSAssert(nil == weakData, @"Expected record to be disposed once consumed by all trackers");
+}
+
+- (void)testInboxDeliversRecordsAndOperationsInOrder
+{
+    RITrackerMock *tracker = [[RITrackerMock alloc] init];
+    RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+    NSMutableArray *expected = [NSMutableArray array];
+    
+    dispatch_queue_t producer = dispatch_queue_create("RIEventArenaTests", DISPATCH_QUEUE_SERIAL);
+    for (NSUInteger idx = 0; idx < 1000; idx++) {
+        NSString *name = [NSString stringWithFormat:@"screen-%lu", (unsigned long)idx];
+        [expected addObject:name];
+        dispatch_async(producer, ^{
+            if (idx % 10) {
+                RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, name);
+                [inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)];
+            } else {
+                [inbox addOperationWithBlock:^{
+                    [tracker.names addObject:name];
+                }];
+            }
+        });
+    }
+    dispatch_sync(producer, ^{});
+    
+    [inbox addOperationWithBlock:^{
+        [self notify:XCTAsyncTestCaseStatusSucceeded];
+    }];
+    [self waitForStatus:XCTAsyncTestCaseStatusSucceeded timeout:2];
+    
+    NSAssert([tracker.names isEqualToArray:expected], @"Expected tracking calls in order of adding");
+}
+
+/**
+ *  Count the heap blocks each trackEvent: call holds until its trackers ran, with the trackers'
+ *  queues suspended: once for the former fan-out of one block operation per tracker, once for the
+ *  shared arena record linked into the trackers' inboxes.
+ */
+- (void)testBenchmarkAllocationsPerTrackEvent
+{
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class c, NSString *filePath)
+                             {
+                                 return @{kRIEventArenaTestsKey: @"1"};
+                             }, ^{
+                                 [[RITracking sharedInstance] startWithConfigurationFromPropertyListAtPath:@"foo"
+                                                                                             launchOptions:nil];
+                             });
+    
+    NSArray *trackers = [RITracking sharedInstance].trackers;
+    NSAssert(kRIEventArenaTestsTrackerCount == trackers.count, @"Expected test trackers to be created");
+    
+    for (RITrackerMock *tracker in trackers) {
+        [tracker.queue waitUntilAllOperationsAreFinished];
+        tracker.names = nil;
+    }
+    
+    for (NSNumber *inboxes in @[@NO, @YES]) {
+        for (RITrackerMock *tracker in trackers) {
+            tracker.queue.suspended = YES;
+        }
+        
+        size_t blocks = RIBenchmarkBlocksInUse();
+        uint64_t slabs = RIEventArenaSlabCount();
+        
+        for (NSUInteger idx = 0; idx < kBenchmarkEventCount; idx++) {
+            @autoreleasepool {
+                NSNumber *value = @(idx);
+                if (inboxes.boolValue) {
+                    [[RITracking sharedInstance] trackEvent:@"event"
+                                                      value:value
+                                                     action:@"action"
+                                                   category:@"category"
+                                                       data:nil];
+                } else {
+                    // Former fan-out, capturing the arguments in one block operation per tracker
+                    for (RITrackerMock *tracker in trackers) {
+                        [tracker.queue addOperationWithBlock:^{
+                            [tracker trackEvent:@"event"
+                                          value:value
+                                         action:@"action"
+                                       category:@"category"
+                                           data:nil];
+                        }];
+                    }
+                }
+            }
+        }
+        
+        double blocksPerCall = ((double)RIBenchmarkBlocksInUse() - blocks) / kBenchmarkEventCount;
+        uint64_t slabCount = RIEventArenaSlabCount() - slabs;
+        
+        for (RITrackerMock *tracker in trackers) {
+            tracker.queue.suspended = NO;
+            [tracker.queue waitUntilAllOperationsAreFinished];
+        }
+        
+        NSLog(@"RIEventArenaBenchmark %@ trackers=%lu heap blocks/trackEvent=%.2f arena slabs=%llu",
+              inboxes.boolValue ? @"arena   " : @"blockops",
+              (unsigned long)trackers.count, blocksPerCall, (unsigned long long)slabCount);
+    }
+}
+
+@end
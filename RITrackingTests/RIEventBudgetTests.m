@@ -0,0 +1,208 @@
+//
+//  RIEventBudgetTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RIEventBudget.h"
+#import "RIEventInbox.h"
+#import "RITrackerMock.h"
+
+@interface RIEventBudgetTests : XCTestCase
+
+@property RITrackerMock *tracker;
+@property RIEventInbox *inbox;
+
+@end
+
+@implementation RIEventBudgetTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.tracker = [[RITrackerMock alloc] init];
+    self.inbox = [[RIEventInbox alloc] initWithTracker:self.tracker];
+    [self.tracker.queue setSuspended:YES];
+}
+
+- (void)tearDown
+{
+    RIEventBudgetSetLimit(0);
+    [super tearDown];
+}
+
+/**
+ *  Limit the budget to a number of records on top of the bytes held by other inboxes
+ */
+- (void)limitBudgetToRecordCount:(NSUInteger)count
+{
+    RIEventBudgetSetLimit(RIEventBudgetUsage() + count * kRecordSize);
+}
+
+- (void)addScreensFrom:(NSUInteger)from to:(NSUInteger)to
+{
+    for (NSUInteger idx = from; idx < to; idx++) {
+        RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen,
+                                                         [NSString stringWithFormat:@"s%lu",
+                                                          (unsigned long)idx]);
+        [self.inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)];
+    }
+}
+
+- (NSArray *)deliveredNames
+{
+    [self.tracker.queue setSuspended:NO];
+    [self.tracker.queue waitUntilAllOperationsAreFinished];
+    return [self.tracker.names copy];
+}
+
+- (void)testDropNewestShedsCallsBeyondBudget
+{
+    size_t usage = RIEventBudgetUsage();
+    [self limitBudgetToRecordCount:4];
+    
+    [self addScreensFrom:0 to:6];
+    
+    NSAssert(RIEventBudgetLimit() == RIEventBudgetUsage(), @"Expected the budget to be full");
+    NSAssert(2 == [self.inbox shedCountForRecordKind:RIEventRecordKindScreen],
+             @"Expected the calls beyond the budget to be shed");
+    NSAssert([[self deliveredNames] isEqualToArray:@[@"s0", @"s1", @"s2", @"s3"]],
+             @"Expected the oldest calls to be delivered");
+    NSAssert(usage == RIEventBudgetUsage(), @"Expected delivered calls to release their bytes");
+}
+
+- (void)testDropOldestShedsQueuedCalls
+{
+    self.inbox.overflowPolicy = RIEventInboxOverflowPolicyDropOldest;
+    [self limitBudgetToRecordCount:4];
+    
+    [self addScreensFrom:0 to:6];
+    
+    NSAssert(2 == [self.inbox shedCountForRecordKind:RIEventRecordKindScreen],
+             @"Expected the oldest calls to be shed");
+    NSAssert([[self deliveredNames] isEqualToArray:@[@"s2", @"s3", @"s4", @"s5"]],
+             @"Expected the newest calls to be delivered");
+}
+
+- (void)testBlockShedsCallAfterTimeout
+{
+    self.inbox.overflowPolicy = RIEventInboxOverflowPolicyBlock;
+    self.inbox.blockTimeout = 0.05;
+    [self limitBudgetToRecordCount:1];
+    
+    NSDate *start = [NSDate date];
+    [self addScreensFrom:0 to:2];
+    
+    NSAssert(0.04 < -[start timeIntervalSinceNow], @"Expected the caller to be blocked until the timeout");
+    NSAssert(1 == [self.inbox shedCountForRecordKind:RIEventRecordKindScreen],
+             @"Expected the call to be shed after the timeout");
+    NSAssert([[self deliveredNames] isEqualToArray:@[@"s0"]], @"Expected the queued call to be delivered");
+}
+
+- (void)testBlockWaitsForRoom
+{
+    self.inbox.overflowPolicy = RIEventInboxOverflowPolicyBlock;
+    self.inbox.blockTimeout = 5;
+    [self limitBudgetToRecordCount:1];
+    
+    NSOperationQueue *queue = self.tracker.queue;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.05 * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                       [queue setSuspended:NO];
+                   });
+    [self addScreensFrom:0 to:2];
+    
+    NSAssert(0 == [self.inbox shedCountForRecordKind:RIEventRecordKindScreen],
+             @"Expected no call to be shed");
+    NSAssert([[self deliveredNames] isEqualToArray:@[@"s0", @"s1"]],
+             @"Expected the blocked call to be delivered once the tracker made room");
+}
+
+- (void)testSpillDeliversSpilledCallsInOrder
+{
+    self.inbox.spillPath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"RIEventBudgetTests/spill"];
+    self.inbox.overflowPolicy = RIEventInboxOverflowPolicySpill;
+    [self limitBudgetToRecordCount:2];
+    
+    [self addScreensFrom:0 to:5];
+    
+    NSAssert(3 == self.inbox.spilledCount, @"Expected the calls beyond the budget to be spilled");
+    NSAssert(0 == [self.inbox shedCountForRecordKind:RIEventRecordKindScreen],
+             @"Expected no call to be shed");
+    NSAssert([[self deliveredNames] isEqualToArray:@[@"s0", @"s1", @"s2", @"s3", @"s4"]],
+             @"Expected spilled calls to be delivered after the calls in memory");
+}
+
+- (void)testCompactionShedsOldestCalls
+{
+    self.inbox.overflowPolicy = RIEventInboxOverflowPolicyDropOldest;
+    [self addScreensFrom:0 to:5];
+    size_t usage = RIEventBudgetUsage();
+    
+    NSAssert(2 * kRecordSize == [self.inbox compactReleasingSize:2 * kRecordSize],
+             @"Expected the bytes of two calls to be released");
+    NSAssert(usage - 2 * kRecordSize == RIEventBudgetUsage(), @"Expected the budget to be released");
+    NSAssert([[self deliveredNames] isEqualToArray:@[@"s2", @"s3", @"s4"]],
+             @"Expected the remaining calls to be delivered");
+}
+
+- (void)testCompactionKeepsCallsOfBlockingInbox
+{
+    self.inbox.overflowPolicy = RIEventInboxOverflowPolicyBlock;
+    [self addScreensFrom:0 to:3];
+    
+    NSAssert(0 == [self.inbox compactReleasingSize:SIZE_MAX], @"Expected no bytes to be released");
+    NSAssert(3 == [self deliveredNames].count, @"Expected all calls to be delivered");
+}
+
+- (void)addCallWithName:(NSString *)name count:(NSUInteger)count shedNames:(NSMutableArray *)shedNames
+{
+    RITrackerMock *tracker = self.tracker;
+    [self.inbox addCallWithBlock:^(BOOL shed) {
+        if (shed) {
+            [shedNames addObject:name];
+        } else {
+            [tracker trackScreenWithName:name];
+        }
+    } count:count priority:RIEventInboxPriorityNormal];
+}
+
+- (void)testCallsMadeAsOperationsShedBeyondBudget
+{
+    NSMutableArray *shedNames = [NSMutableArray array];
+    size_t usage = RIEventBudgetUsage();
+    [self limitBudgetToRecordCount:4];
+    
+    // A call of a single tracking call is charged more than a record, two fit into the budget
+    for (NSUInteger idx = 0; idx < 3; idx++) {
+        [self addCallWithName:[NSString stringWithFormat:@"c%lu", (unsigned long)idx]
+                        count:1
+                    shedNames:shedNames];
+    }
+    
+    NSAssert(1 == self.inbox.shedCallCount && [shedNames isEqualToArray:@[@"c2"]],
+             @"Expected the call beyond the budget to be shed");
+    NSAssert([[self deliveredNames] isEqualToArray:@[@"c0", @"c1"]],
+             @"Expected the calls within the budget to be delivered");
+    NSAssert(usage == RIEventBudgetUsage(), @"Expected delivered calls to release their bytes");
+}
+
+- (void)testDropOldestShedsQueuedCallsMadeAsOperations
+{
+    NSMutableArray *shedNames = [NSMutableArray array];
+    self.inbox.overflowPolicy = RIEventInboxOverflowPolicyDropOldest;
+    [self limitBudgetToRecordCount:4];
+    
+    [self addCallWithName:@"c0" count:2 shedNames:shedNames];
+    [self addScreensFrom:0 to:3];
+    
+    NSAssert(2 == self.inbox.shedCallCount && [shedNames isEqualToArray:@[@"c0"]],
+             @"Expected the oldest call to be shed with the tracking calls it makes");
+    NSAssert([[self deliveredNames] isEqualToArray:@[@"s0", @"s1", @"s2"]],
+             @"Expected the newest calls to be delivered");
+}
+
+@end
@@ -0,0 +1,42 @@
+//
+//  RIEventBufferTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RIEventBuffer.h"
+
+@interface RIEventBufferTests : XCTestCase
+
+@end
+
+@implementation RIEventBufferTests
+
+- (void)testBufferReplaysRecordsInOrderAndDropsOldestOnOverflow
+{
+    RIEventBuffer *buffer = [[RIEventBuffer alloc] initWithCapacity:2];
+    
+    for (NSString *name in @[@"foo", @"bar", @"baz"]) {
+        RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, name);
+        NSAssert([buffer addRecord:&record], @"Expected record to be added to open buffer");
+    }
+    
+    NSAssert(1 == buffer.droppedCount, @"Expected oldest record to be dropped and counted");
+    
+    NSMutableArray *names = [NSMutableArray array];
+    [buffer closeWithReplayHandler:^(RIEventRecord *record) {
+        [names addObject:RIEventRecordName(record)];
+        RIEventRecordDispose(record);
+    }];
+    
+    NSAssert([names isEqualToArray:(@[@"bar", @"baz"])], @"Expected remaining records in order");
+    
+    RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"qux");
+    NSAssert(![buffer addRecord:&record], @"Expected closed buffer to refuse records");
+    RIEventRecordDispose(&record);
+}
+
+@end
@@ -0,0 +1,79 @@
+//
+//  RIEventExecutorTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RIEventExecutor.h"
+#import "RIEventInbox.h"
+#import "RITrackerMock.h"
+
+static NSUInteger const kLaneCount = 8;
+static NSUInteger const kScreenCount = 1000;
+
+@interface RIEventExecutorTests : XCTestCase
+
+@end
+
+@implementation RIEventExecutorTests
+
+- (void)testInboxLanesKeepOrderOnSharedWorkers
+{
+    RIEventExecutor *executor = [[RIEventExecutor alloc] initWithWorkerCount:3];
+    NSMutableArray *trackers = [NSMutableArray array];
+    NSMutableArray *inboxes = [NSMutableArray array];
+    NSMutableArray *expected = [NSMutableArray array];
+    
+    for (NSUInteger idx = 0; idx < kLaneCount; idx++) {
+        RITrackerMock *tracker = [[RITrackerMock alloc] init];
+        RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+        inbox.executor = executor;
+        [trackers addObject:tracker];
+        [inboxes addObject:inbox];
+    }
+    
+    for (NSUInteger idx = 0; idx < kScreenCount; idx++) {
+        NSString *name = [NSString stringWithFormat:@"s%lu", (unsigned long)idx];
+        [expected addObject:name];
+        
+        RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, name);
+        RIEventArenaRecord *arenaRecord = RIEventArenaRecordCreate(&record, kLaneCount, nil);
+        for (RIEventInbox *inbox in inboxes) {
+            [inbox addRecord:arenaRecord];
+        }
+    }
+    
+    [executor waitUntilIdle];
+    
+    for (RITrackerMock *tracker in trackers) {
+        NSAssert(!tracker.concurrent, @"Expected a tracker never to be called concurrently");
+        NSAssert([tracker.names isEqualToArray:expected], @"Expected a tracker's calls in order");
+        NSAssert(0 == tracker.queue.operationCount, @"Expected no work on the tracker's own queue");
+    }
+}
+
+- (void)testOperationsRunOnLaneInOrderWithRecords
+{
+    RIEventExecutor *executor = [[RIEventExecutor alloc] initWithWorkerCount:2];
+    RITrackerMock *tracker = [[RITrackerMock alloc] init];
+    RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+    inbox.executor = executor;
+    
+    RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"first");
+    [inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)];
+    [inbox addOperationWithBlock:^{
+        [tracker trackScreenWithName:@"operation"];
+    }];
+    record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"last");
+    [inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)];
+    
+    [executor waitUntilIdle];
+    
+    NSAssert([tracker.names isEqualToArray:@[@"first", @"operation", @"last"]],
+             @"Expected operations in order with records");
+}
+
+@end
@@ -0,0 +1,291 @@
+//
+//  RIEventJournalTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach_time.h>
+#import <signal.h>
+#import <sys/stat.h>
+#import <sys/wait.h>
+#import "RIJournal.h"
+#import "RIEventJournal.h"
+#import "XCTestCase+AsyncTesting.h"
+
+typedef struct RIEventJournalTestsRecovery {
+    uint64_t identifiers[1024];
+    uint32_t values[1024];
+    size_t count;
+    size_t total;
+} RIEventJournalTestsRecovery;
+
+static void RIEventJournalTestsRecoverEntry(uint64_t identifier,
+                                            const void *payload,
+                                            size_t length,
+                                            void *context)
+{
+    RIEventJournalTestsRecovery *recovery = context;
+    uint32_t value;
+    NSCAssert(sizeof(value) == length, @"Unexpected payload length of recovered entry");
+    memcpy(&value, payload, sizeof(value));
+    NSCAssert(value == recovery->total, @"Expected recovered entries in order without gaps");
+    if (recovery->count < 1024) {
+        recovery->identifiers[recovery->count] = identifier;
+        recovery->values[recovery->count] = value;
+        recovery->count++;
+    }
+    recovery->total++;
+}
+
+static void RIEventJournalTestsRecoverEntryEveryThird(uint64_t identifier,
+                                                      const void *payload,
+                                                      size_t length,
+                                                      void *context)
+{
+    RIEventJournalTestsRecovery *recovery = context;
+    uint32_t value;
+    memcpy(&value, payload, sizeof(value));
+    NSCAssert(value == recovery->count * 3, @"Expected unacknowledged entries in order");
+    recovery->identifiers[recovery->count++] = identifier;
+}
+
+static void RIEventJournalTestsStopProcess(void)
+{
+    static uint32_t published;
+    if (100 == published++) raise(SIGSTOP);
+}
+
+@interface RIEventJournalTests : XCTestCase
+
+@property NSString *directory;
+
+@end
+
+@implementation RIEventJournalTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtPath:self.directory
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:NULL];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.directory error:NULL];
+    [super tearDown];
+}
+
+- (NSUInteger)segmentFileCount
+{
+    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.directory error:NULL];
+    return [files filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"self ENDSWITH '.seg'"]].count;
+}
+
+- (void)testJournalRecoversOnlyUnacknowledgedEntriesAndDeletesProcessedSegments
+{
+    RIJournal *journal = RIJournalOpen(self.directory.fileSystemRepresentation, 4096);
+    
+    for (uint32_t value = 0; value < 1000; value++) {
+        uint64_t identifier = RIJournalAppend(journal, &value, sizeof(value));
+        NSAssert(0 != identifier, @"Expected entry to be appended");
+        // Leave one in three entries unacknowledged, as if the process died before processing
+        if (0 != value % 3) RIJournalAcknowledge(journal, identifier);
+    }
+    RIJournalClose(journal);
+    
+    journal = RIJournalOpen(self.directory.fileSystemRepresentation, 4096);
+    RIEventJournalTestsRecovery *recovery = calloc(1, sizeof(RIEventJournalTestsRecovery));
+    RIJournalRecover(journal, RIEventJournalTestsRecoverEntryEveryThird, recovery);
+    
+    NSAssert(334 == recovery->count, @"Expected all unacknowledged entries to be recovered");
+    
+    for (size_t idx = 0; idx < recovery->count; idx++) {
+        RIJournalAcknowledge(journal, recovery->identifiers[idx]);
+    }
+    RIJournalClose(journal);
+    free(recovery);
+    
+    NSAssert(1 == [self segmentFileCount],
+             @"Expected only the segment last appended to be left once all entries are acknowledged");
+}
+
+- (void)testJournalRecoveryStopsAtTornEntry
+{
+    RIJournal *journal = RIJournalOpen(self.directory.fileSystemRepresentation, 4096);
+    for (uint32_t value = 0; value < 10; value++) {
+        RIJournalAppend(journal, &value, sizeof(value));
+    }
+    RIJournalClose(journal);
+    
+    // Corrupt the payload of the last entry, as left by a write torn by a system crash
+    NSString *file = [[[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.directory
+                                                                          error:NULL] firstObject];
+    NSFileHandle *handle = [NSFileHandle fileHandleForUpdatingAtPath:
+                            [self.directory stringByAppendingPathComponent:file]];
+    [handle seekToFileOffset:16 + 9 * 32 + 24];
+    [handle writeData:[NSData dataWithBytes:"\xff" length:1]];
+    [handle closeFile];
+    
+    journal = RIJournalOpen(self.directory.fileSystemRepresentation, 4096);
+    RIEventJournalTestsRecovery *recovery = calloc(1, sizeof(RIEventJournalTestsRecovery));
+    RIJournalRecover(journal, RIEventJournalTestsRecoverEntry, recovery);
+    RIJournalClose(journal);
+    
+    NSAssert(9 == recovery->total, @"Expected recovery to stop at the torn entry");
+    free(recovery);
+}
+
+- (void)testJournalSurvivesFailedSegmentRotation
+{
+    RIJournal *journal = RIJournalOpen(self.directory.fileSystemRepresentation, 4096);
+    uint32_t value = 0;
+    uint64_t identifier = RIJournalAppend(journal, &value, sizeof(value));
+    
+    // No new segment can be created in a read-only directory
+    chmod(self.directory.fileSystemRepresentation, 0500);
+    
+    while (RIJournalAppend(journal, &value, sizeof(value))) {
+        value++;
+    }
+    
+    NSAssert(0 == RIJournalAppend(journal, &value, sizeof(value)), @"Expected append without segment to fail");
+    NSAssert(!RIJournalAcknowledge(journal, identifier), @"Expected acknowledgement without segment to fail");
+    NSAssert(!RIJournalSync(journal), @"Expected sync without segment to fail");
+    
+    chmod(self.directory.fileSystemRepresentation, 0700);
+    
+    NSAssert(0 != RIJournalAppend(journal, &value, sizeof(value)),
+             @"Expected append to rotate once a segment can be created again");
+    NSAssert(RIJournalAcknowledge(journal, identifier), @"Expected acknowledgement after rotation");
+    NSAssert(RIJournalSync(journal), @"Expected sync after rotation");
+    RIJournalClose(journal);
+}
+
+- (void)testJournalOpenedAgainLeavesSegmentsOfOpenJournalToIt
+{
+    const char *directory = self.directory.fileSystemRepresentation;
+    RIJournal *previous = RIJournalOpen(directory, 4096);
+    uint64_t identifiers[300];
+    for (uint32_t value = 0; value < 300; value++) {
+        identifiers[value] = RIJournalAppend(previous, &value, sizeof(value));
+    }
+    
+    // A journal opened again on the directory, as on a restart, leaves entries in flight alone
+    RIJournal *journal = RIJournalOpen(directory, 4096);
+    RIEventJournalTestsRecovery *recovery = calloc(1, sizeof(RIEventJournalTestsRecovery));
+    NSAssert(0 == RIJournalRecover(journal, RIEventJournalTestsRecoverEntry, recovery),
+             @"Expected no entry of the journal still open to be recovered");
+    
+    for (uint32_t value = 0; value < 300; value++) {
+        RIJournalAppend(journal, &value, sizeof(value));
+        RIJournalAcknowledge(previous, identifiers[value]);
+    }
+    RIJournalClose(previous);
+    RIJournalClose(journal);
+    
+    journal = RIJournalOpen(directory, 4096);
+    RIJournalRecover(journal, RIEventJournalTestsRecoverEntry, recovery);
+    RIJournalClose(journal);
+    
+    NSAssert(300 == recovery->total,
+             @"Expected exactly the unacknowledged entries of the second journal to be recovered");
+    free(recovery);
+}
+
+- (void)testJournalRecoversAfterProcessKilledPartwayThroughEntry
+{
+    const char *directory = self.directory.fileSystemRepresentation;
+    
+    pid_t pid = fork();
+    if (0 == pid) {
+        // Child process stops itself with its 101st entry written except for its size, only
+        // calling into the C journal
+        RIJournalEntryWillPublishHook = RIEventJournalTestsStopProcess;
+        RIJournal *journal = RIJournalOpen(directory, 1 << 16);
+        for (uint32_t value = 0; journal; value++) {
+            RIJournalAppend(journal, &value, sizeof(value));
+        }
+        _exit(1);
+    }
+    
+    int status;
+    waitpid(pid, &status, WUNTRACED);
+    BOOL stopped = WIFSTOPPED(status);
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+    NSAssert(stopped, @"Expected the appending process to stop partway through an entry");
+    
+    RIJournal *journal = RIJournalOpen(directory, 1 << 16);
+    RIEventJournalTestsRecovery *recovery = calloc(1, sizeof(RIEventJournalTestsRecovery));
+    RIJournalRecover(journal, RIEventJournalTestsRecoverEntry, recovery);
+    RIJournalClose(journal);
+    
+    NSAssert(100 == recovery->total,
+             @"Expected exactly the entries completed before the kill to be recovered");
+    free(recovery);
+}
+
+- (void)testEventJournalReplaysRecordsNotAcknowledged
+{
+    RIEventJournal *journal = [[RIEventJournal alloc] initWithDirectory:self.directory
+                                                            segmentSize:4096];
+    
+    RIEventRecord processed = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"foo");
+    RIEventRecord pending = RIEventRecordMakeEvent(@"bar", @1, @"action", @"category", @{@"baz": @"qux"});
+    NSAssert([journal appendRecord:&processed] && [journal appendRecord:&pending],
+             @"Expected records to be journaled");
+    [[journal acknowledgementForRecord:&processed count:1] trackerDidProcess];
+    RIEventRecordDispose(&processed);
+    RIEventRecordDispose(&pending);
+    journal = nil;
+    
+    journal = [[RIEventJournal alloc] initWithDirectory:self.directory segmentSize:4096];
+    NSMutableArray *events = [NSMutableArray array];
+    [journal recoverWithHandler:^(RIEventRecord *record) {
+        [events addObject:@[@(record->kind), RIEventRecordName(record),
+                            (__bridge id)record->arguments[0]]];
+        [journal acknowledgeIdentifier:record->journalIdentifier];
+        RIEventRecordDispose(record);
+        [self notify:XCTAsyncTestCaseStatusSucceeded];
+    }];
+    [self waitForStatus:XCTAsyncTestCaseStatusSucceeded timeout:2];
+    
+    NSAssert([events isEqualToArray:(@[@[@(RIEventRecordKindEvent), @"bar", @{@"baz": @"qux"}]])],
+             @"Expected only the unacknowledged record to be replayed");
+}
+
+- (void)testBenchmarkJournalThroughput
+{
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    
+    for (NSNumber *payloadSize in @[@32, @256, @1024]) {
+        RIJournal *journal = RIJournalOpen(self.directory.fileSystemRepresentation, 1 << 20);
+        NSUInteger const count = 100000;
+        void *payload = calloc(1, payloadSize.unsignedIntegerValue);
+        
+        uint64_t start = mach_absolute_time();
+        for (NSUInteger idx = 0; idx < count; idx++) {
+            uint64_t identifier = RIJournalAppend(journal, payload, payloadSize.unsignedIntegerValue);
+            RIJournalAcknowledge(journal, identifier);
+        }
+        double seconds = (mach_absolute_time() - start) * timebase.numer / timebase.denom / 1e9;
+        
+        NSLog(@"RIEventJournalBenchmark payload=%4luB append+acknowledge=%.0f/s (%.1f MB/s)",
+              (unsigned long)payloadSize.unsignedIntegerValue,
+              count / seconds,
+              count * payloadSize.doubleValue / seconds / 1e6);
+        
+        free(payload);
+        RIJournalClose(journal);
+    }
+}
+
+@end
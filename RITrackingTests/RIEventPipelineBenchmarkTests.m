@@ -0,0 +1,136 @@
+//
+//  RIEventPipelineBenchmarkTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach_time.h>
+#import <pthread.h>
+#import "RIEventPipeline.h"
+
+static NSUInteger const kBenchmarkEventCount = 200000;
+
+/**
+ *  Context of a producer thread, enqueueing its share of events and sampling each call's latency
+ */
+typedef struct RIBenchmarkProducer {
+    NSUInteger count;
+    uint64_t *latencies;
+    void *target;
+    BOOL useRing;
+} RIBenchmarkProducer;
+
+static void *RIBenchmarkProduce(void *context)
+{
+    RIBenchmarkProducer *producer = context;
+    
+    @autoreleasepool {
+        for (NSUInteger idx = 0; idx < producer->count; idx++) {
+            uint64_t start = mach_absolute_time();
+            if (producer->useRing) {
+                RIEventRecord record = RIEventRecordMakeEvent(@"event", nil, @"action", @"category", nil);
+                [(__bridge RIEventPipeline *)producer->target enqueueRecord:&record];
+            } else {
+                NSString *event = @"event";
+                [(__bridge NSOperationQueue *)producer->target addOperationWithBlock:^{
+                    (void)event;
+                }];
+            }
+            producer->latencies[idx] = mach_absolute_time() - start;
+        }
+    }
+    
+    return NULL;
+}
+
+static int RIBenchmarkCompare(const void *a, const void *b)
+{
+    uint64_t lhs = *(const uint64_t *)a, rhs = *(const uint64_t *)b;
+    return lhs < rhs ? -1 : lhs > rhs;
+}
+
+@interface RIEventPipelineBenchmarkTests : XCTestCase
+
+@end
+
+@implementation RIEventPipelineBenchmarkTests
+
+- (void)testBenchmarkRingPipelineAgainstOperationQueue
+{
+    for (NSNumber *producerCount in @[@1, @2, @8, @32]) {
+        [self runBenchmarkWithProducers:producerCount.unsignedIntegerValue useRing:NO];
+        [self runBenchmarkWithProducers:producerCount.unsignedIntegerValue useRing:YES];
+    }
+}
+
+- (void)runBenchmarkWithProducers:(NSUInteger)producerCount useRing:(BOOL)useRing
+{
+    __block int64_t handled = 0;
+    NSOperationQueue *queue = nil;
+    RIEventPipeline *pipeline = nil;
+    void *target;
+    
+    if (useRing) {
+        pipeline = [[RIEventPipeline alloc] initWithCapacity:kBenchmarkEventCount
+                                                     handler:^(const RIEventRecord *record) {
+                                                         __atomic_add_fetch(&handled, 1, __ATOMIC_RELAXED);
+                                                     }];
+        target = (__bridge void *)pipeline;
+    } else {
+        queue = [[NSOperationQueue alloc] init];
+        queue.maxConcurrentOperationCount = 1;
+        target = (__bridge void *)queue;
+    }
+    
+    NSUInteger perProducer = kBenchmarkEventCount / producerCount;
+    NSUInteger total = perProducer * producerCount;
+    uint64_t *latencies = calloc(total, sizeof(uint64_t));
+    RIBenchmarkProducer *producers = calloc(producerCount, sizeof(RIBenchmarkProducer));
+    pthread_t *threads = calloc(producerCount, sizeof(pthread_t));
+    
+    uint64_t start = mach_absolute_time();
+    for (NSUInteger idx = 0; idx < producerCount; idx++) {
+        producers[idx] = (RIBenchmarkProducer){perProducer, latencies + idx * perProducer, target, useRing};
+        pthread_create(&threads[idx], NULL, RIBenchmarkProduce, &producers[idx]);
+    }
+    for (NSUInteger idx = 0; idx < producerCount; idx++) {
+        pthread_join(threads[idx], NULL);
+    }
+    uint64_t enqueued = mach_absolute_time();
+    
+    if (useRing) {
+        uint64_t accepted = total - pipeline.droppedCount;
+        while ((uint64_t)__atomic_load_n(&handled, __ATOMIC_RELAXED) < accepted) {
+            usleep(100);
+        }
+        [pipeline stop];
+    } else {
+        [queue waitUntilAllOperationsAreFinished];
+    }
+    uint64_t drained = mach_absolute_time();
+    
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    double nsPerTick = (double)timebase.numer / timebase.denom;
+    
+    qsort(latencies, total, sizeof(uint64_t), RIBenchmarkCompare);
+    
+    NSLog(@"RIEventPipelineBenchmark %@ producers=%2lu enqueue p50=%.0fns p99=%.0fns "
+          @"enqueue=%.0f/s end-to-end=%.0f/s dropped=%llu",
+          useRing ? @"ring          " : @"NSOperationQueue",
+          (unsigned long)producerCount,
+          latencies[total / 2] * nsPerTick,
+          latencies[total * 99 / 100] * nsPerTick,
+          total / ((enqueued - start) * nsPerTick / NSEC_PER_SEC),
+          total / ((drained - start) * nsPerTick / NSEC_PER_SEC),
+          useRing ? pipeline.droppedCount : 0);
+    
+    free(threads);
+    free(producers);
+    free(latencies);
+}
+
+@end
@@ -0,0 +1,248 @@
+//
+//  RIEventPriorityTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RIEventInbox.h"
+#import "RIEventExecutor.h"
+#import "RITrackerMock.h"
+
+static NSUInteger const kBulkScreenCount = 200;
+static NSUInteger const kSaturationCriticalCount = 200;
+static NSUInteger const kSaturationBacklog = 1000;
+static NSTimeInterval const kSaturationCallDuration = 0.00005;
+static NSTimeInterval const kSaturationSchedulingSlack = 0.005;
+
+/**
+ *  The inbox's entries processed per lane slice and its starvation limit
+ */
+static NSUInteger const kLaneSliceCount = 64;
+static NSUInteger const kStarvationLimit = 8;
+
+/**
+ *  Stand-in tracker taking a fixed time per screen view, timestamping the delivery of the
+ *  exceptions named by their index
+ */
+@interface RIEventPriorityTestsTracker : RITrackerMock
+
+@property CFAbsoluteTime *deliveryTimes;
+@property (readonly) NSUInteger exceptionCount;
+
+@end
+
+@implementation RIEventPriorityTestsTracker
+{
+    NSUInteger _exceptionCount;
+}
+
+- (NSUInteger)exceptionCount
+{
+    return __atomic_load_n(&_exceptionCount, __ATOMIC_ACQUIRE);
+}
+
+- (void)trackScreenWithName:(NSString *)name
+{
+    CFAbsoluteTime end = CFAbsoluteTimeGetCurrent() + kSaturationCallDuration;
+    while (CFAbsoluteTimeGetCurrent() < end);
+    [super trackScreenWithName:name];
+}
+
+- (void)trackExceptionWithName:(NSString *)name
+{
+    self.deliveryTimes[name.integerValue] = CFAbsoluteTimeGetCurrent();
+    __atomic_add_fetch(&_exceptionCount, 1, __ATOMIC_RELEASE);
+    [super trackExceptionWithName:name];
+}
+
+@end
+
+static int RIEventPriorityTestsCompare(const void *a, const void *b)
+{
+    CFAbsoluteTime left = *(const CFAbsoluteTime *)a;
+    CFAbsoluteTime right = *(const CFAbsoluteTime *)b;
+    return left < right ? -1 : left > right;
+}
+
+@interface RIEventPriorityTests : XCTestCase
+
+@property RITrackerMock *tracker;
+@property RIEventInbox *inbox;
+
+@end
+
+@implementation RIEventPriorityTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.tracker = [[RITrackerMock alloc] init];
+    self.inbox = [[RIEventInbox alloc] initWithTracker:self.tracker];
+}
+
+- (void)addScreenWithName:(NSString *)name priority:(RIEventInboxPriority)priority
+{
+    RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, name);
+    [self.inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil) priority:priority];
+}
+
+- (void)testCriticalOvertakesQueuedBulkLoad
+{
+    self.tracker.queue.suspended = YES;
+    
+    for (NSUInteger idx = 0; idx < kBulkScreenCount; idx++) {
+        [self addScreenWithName:@"bulk" priority:RIEventInboxPriorityBulk];
+    }
+    RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindException, @"exception");
+    [self.inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil) priority:RIEventInboxPriorityCritical];
+    
+    self.tracker.queue.suspended = NO;
+    [self.tracker.queue waitUntilAllOperationsAreFinished];
+    
+    NSAssert(kBulkScreenCount + 1 == self.tracker.names.count, @"Expected all calls tracked");
+    NSAssert([self.tracker.names[0] isEqualToString:@"exception"],
+             @"Expected the exception to overtake the bulk screens queued");
+}
+
+/**
+ *  Keep an inbox saturated with bulk screens by a producer thread, next to another saturated lane
+ *  of the same executor worker, while critical exceptions are injected one at a time.
+ *
+ *  A critical exception waits at most for the entry in progress, a slice of the other lane and an
+ *  entry of each lower priority let through by the starvation limit, never for the bulk backlog.
+ */
+- (void)testCriticalLatencyBoundedUnderSaturatingBulkLoad
+{
+    RIEventExecutor *executor = [[RIEventExecutor alloc] initWithWorkerCount:1];
+    RIEventPriorityTestsTracker *tracker = [[RIEventPriorityTestsTracker alloc] init];
+    RIEventPriorityTestsTracker *neighbour = [[RIEventPriorityTestsTracker alloc] init];
+    RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+    RIEventInbox *neighbourInbox = [[RIEventInbox alloc] initWithTracker:neighbour];
+    CFAbsoluteTime enqueueTimes[kSaturationCriticalCount];
+    CFAbsoluteTime deliveryTimes[kSaturationCriticalCount];
+    tracker.deliveryTimes = deliveryTimes;
+    tracker.names = nil;
+    neighbour.names = nil;
+    inbox.executor = executor;
+    neighbourInbox.executor = executor;
+    
+    __block BOOL done = NO;
+    __block uint64_t produced = 0;
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_queue_t producers = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    for (RIEventInbox *producerInbox in @[inbox, neighbourInbox]) {
+        RIEventPriorityTestsTracker *producerTracker = (RIEventPriorityTestsTracker *)producerInbox.tracker;
+        dispatch_group_async(group, producers, ^{
+            uint64_t count = 0;
+            while (!done) {
+                if (count - producerTracker.screenCount >= kSaturationBacklog) {
+                    usleep(100);
+                    continue;
+                }
+                RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"bulk");
+                [producerInbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)
+                                priority:RIEventInboxPriorityBulk];
+                count++;
+                if (producerInbox == inbox) __atomic_store_n(&produced, count, __ATOMIC_RELEASE);
+            }
+        });
+    }
+    
+    while (__atomic_load_n(&produced, __ATOMIC_ACQUIRE) - tracker.screenCount < kSaturationBacklog / 2) {
+        usleep(100);
+    }
+    
+    NSUInteger bulkCount = tracker.screenCount;
+    uint64_t minimumBacklog = UINT64_MAX;
+    for (NSUInteger idx = 0; idx < kSaturationCriticalCount; idx++) {
+        uint64_t backlog = __atomic_load_n(&produced, __ATOMIC_ACQUIRE) - tracker.screenCount;
+        minimumBacklog = MIN(minimumBacklog, backlog);
+        RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindException,
+                                                         [NSString stringWithFormat:@"%lu",
+                                                          (unsigned long)idx]);
+        enqueueTimes[idx] = CFAbsoluteTimeGetCurrent();
+        [inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil) priority:RIEventInboxPriorityCritical];
+        usleep(1000);
+    }
+    
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:10];
+    while (kSaturationCriticalCount > tracker.exceptionCount && 0 < [deadline timeIntervalSinceNow]) {
+        usleep(1000);
+    }
+    bulkCount = tracker.screenCount - bulkCount;
+    done = YES;
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    [executor waitUntilIdle];
+    
+    NSAssert(kSaturationCriticalCount == tracker.exceptionCount, @"Expected all critical exceptions tracked");
+    NSAssert(kSaturationBacklog / 2 <= minimumBacklog, @"Expected bulk screens queued ahead of every exception");
+    
+    CFAbsoluteTime latencies[kSaturationCriticalCount];
+    for (NSUInteger idx = 0; idx < kSaturationCriticalCount; idx++) {
+        latencies[idx] = deliveryTimes[idx] - enqueueTimes[idx];
+    }
+    qsort(latencies, kSaturationCriticalCount, sizeof(CFAbsoluteTime), RIEventPriorityTestsCompare);
+    
+    // The entry in progress, a slice of the other lane, a starved entry of each lower priority
+    NSUInteger entriesAhead = 1 + kLaneSliceCount + (RIEventInboxPriorityBulk - RIEventInboxPriorityCritical);
+    NSTimeInterval bound = 2 * entriesAhead * kSaturationCallDuration + kSaturationSchedulingSlack;
+    NSTimeInterval p99 = latencies[kSaturationCriticalCount * 99 / 100];
+    NSTimeInterval maximum = latencies[kSaturationCriticalCount - 1];
+    
+    NSAssert(p99 < bound, @"Expected p99 latency of critical exceptions %.1fms below %.1fms",
+             p99 * 1000, bound * 1000);
+    NSAssert(maximum < minimumBacklog * kSaturationCallDuration,
+             @"Expected no critical exception to wait for the bulk backlog, waited %.1fms", maximum * 1000);
+    NSAssert(kSaturationCriticalCount / kStarvationLimit <= bulkCount,
+             @"Expected bulk screens to keep their share while critical exceptions overtake them");
+}
+
+- (void)testLowerPrioritiesNotStarved
+{
+    self.tracker.queue.suspended = YES;
+    
+    for (NSUInteger idx = 0; idx < 40; idx++) {
+        [self addScreenWithName:@"critical" priority:RIEventInboxPriorityCritical];
+    }
+    for (NSUInteger idx = 0; idx < 5; idx++) {
+        [self addScreenWithName:@"bulk" priority:RIEventInboxPriorityBulk];
+    }
+    
+    self.tracker.queue.suspended = NO;
+    [self.tracker.queue waitUntilAllOperationsAreFinished];
+    
+    NSMutableArray *expected = [NSMutableArray array];
+    for (NSUInteger round = 0; round < 5; round++) {
+        for (NSUInteger idx = 0; idx < 8; idx++) {
+            [expected addObject:@"critical"];
+        }
+        [expected addObject:@"bulk"];
+    }
+    
+    NSAssert([self.tracker.names isEqualToArray:expected],
+             @"Expected a bulk screen after every 8 critical screens");
+}
+
+- (void)testOrderKeptWithinPriority
+{
+    self.tracker.queue.suspended = YES;
+    
+    [self addScreenWithName:@"n1" priority:RIEventInboxPriorityNormal];
+    [self addScreenWithName:@"b1" priority:RIEventInboxPriorityBulk];
+    [self.inbox addOperationWithBlock:^{
+        [self.tracker trackScreenWithName:@"c1"];
+    } priority:RIEventInboxPriorityCritical];
+    [self addScreenWithName:@"n2" priority:RIEventInboxPriorityNormal];
+    [self addScreenWithName:@"c2" priority:RIEventInboxPriorityCritical];
+    
+    self.tracker.queue.suspended = NO;
+    [self.tracker.queue waitUntilAllOperationsAreFinished];
+    
+    NSAssert([self.tracker.names isEqualToArray:@[@"c1", @"c2", @"n1", @"n2", @"b1"]],
+             @"Expected entries by priority, in order within a priority");
+}
+
+@end
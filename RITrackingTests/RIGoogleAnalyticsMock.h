@@ -0,0 +1,67 @@
+//
+//  RIGoogleAnalyticsMock.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "GAITracker.h"
+
+@class RIGoogleAnalyticsMockAnalytics;
+
+/**
+ *  Stand-in Google Analytics tracker, recording the hits sent and the parameters set, to test and
+ *  measure adapters without the vendor library doing any work
+ */
+@interface RIGoogleAnalyticsMockTracker : NSObject <GAITracker>
+
+/**
+ *  The hits sent, in order, nil if hits are only counted
+ */
+@property NSMutableArray *hits;
+
+/**
+ *  The number of hits sent
+ */
+@property (readonly) NSUInteger hitCount;
+
+/**
+ *  The number of parameters set on the tracker
+ */
+@property (readonly) NSUInteger setCount;
+
+/**
+ *  The stand-in Google Analytics instance counting the hits sent as pending, if any
+ */
+@property (weak) RIGoogleAnalyticsMockAnalytics *analytics;
+
+@end
+
+/**
+ *  Stand-in Google Analytics instance, recording dispatch calls and the number of hits pending at
+ *  each of them
+ */
+@interface RIGoogleAnalyticsMockAnalytics : NSObject
+
+@property NSTimeInterval dispatchInterval;
+
+/**
+ *  The number of hits sent and not dispatched yet
+ */
+@property (readonly) NSUInteger pendingHitCount;
+
+/**
+ *  The number of hits pending at each dispatch call, in order
+ */
+@property (readonly) NSArray *dispatchedHitCounts;
+
+- (void)dispatch;
+
+/**
+ *  Count a hit sent as pending
+ */
+- (void)hitSent;
+
+@end
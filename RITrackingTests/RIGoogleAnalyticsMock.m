@@ -0,0 +1,100 @@
+//
+//  RIGoogleAnalyticsMock.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RIGoogleAnalyticsMock.h"
+
+@interface RIGoogleAnalyticsMockTracker ()
+
+@property (readwrite) NSUInteger hitCount;
+@property (readwrite) NSUInteger setCount;
+@property NSMutableDictionary *parameters;
+
+@end
+
+@implementation RIGoogleAnalyticsMockTracker
+
+- (instancetype)init
+{
+    if ((self = [super init])) {
+        self.hits = [NSMutableArray array];
+        self.parameters = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (NSString *)name
+{
+    return @"RIGoogleAnalyticsMockTracker";
+}
+
+- (void)set:(NSString *)parameterName value:(NSString *)value
+{
+    @synchronized(self) {
+        self.setCount++;
+        self.parameters[parameterName] = value;
+    }
+}
+
+- (NSString *)get:(NSString *)parameterName
+{
+    @synchronized(self) {
+        return self.parameters[parameterName];
+    }
+}
+
+- (void)send:(NSDictionary *)parameters
+{
+    @synchronized(self) {
+        self.hitCount++;
+        [self.hits addObject:parameters];
+    }
+    [self.analytics hitSent];
+}
+
+@end
+
+@interface RIGoogleAnalyticsMockAnalytics ()
+
+@property (readwrite) NSUInteger pendingHitCount;
+@property NSMutableArray *dispatches;
+
+@end
+
+@implementation RIGoogleAnalyticsMockAnalytics
+
+- (instancetype)init
+{
+    if ((self = [super init])) {
+        self.dispatches = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (NSArray *)dispatchedHitCounts
+{
+    @synchronized(self) {
+        return [self.dispatches copy];
+    }
+}
+
+- (void)dispatch
+{
+    @synchronized(self) {
+        [self.dispatches addObject:@(self.pendingHitCount)];
+        self.pendingHitCount = 0;
+    }
+}
+
+- (void)hitSent
+{
+    @synchronized(self) {
+        self.pendingHitCount++;
+    }
+}
+
+@end
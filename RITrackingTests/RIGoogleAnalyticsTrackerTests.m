@@ -0,0 +1,199 @@
+//
+//  RIGoogleAnalyticsTrackerTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RIGoogleAnalyticsTracker.h"
+#import "RIGoogleAnalyticsMock.h"
+#import "RIGoogleAnalyticsDispatchController.h"
+#import "RITrackingCart.h"
+#import "MBBlockSwizzle.h"
+#import "GAI.h"
+#import "GAIDictionaryBuilder.h"
+#import "GAIFields.h"
+
+@interface RIGoogleAnalyticsTracker ()
+
+@property (nonatomic) id<GAITracker> analyticsTracker;
+@property (nonatomic) RIGoogleAnalyticsDispatchController *dispatchController;
+@property (nonatomic) RITrackingCart *cart;
+
+@end
+
+@interface RIGoogleAnalyticsTrackerTests : XCTestCase
+
+@property RIGoogleAnalyticsMockTracker *mockTracker;
+@property RIGoogleAnalyticsMockAnalytics *mockAnalytics;
+@property RIGoogleAnalyticsTracker *tracker;
+
+@end
+
+@implementation RIGoogleAnalyticsTrackerTests
+
+- (void)setUp
+{
+    [super setUp];
+    RILogSetLevel(RILogLevelWarning);
+    self.mockTracker = [[RIGoogleAnalyticsMockTracker alloc] init];
+    self.tracker = [[RIGoogleAnalyticsTracker alloc] init];
+    self.tracker.analyticsTracker = self.mockTracker;
+    self.mockAnalytics = [[RIGoogleAnalyticsMockAnalytics alloc] init];
+    self.mockTracker.analytics = self.mockAnalytics;
+    self.tracker.dispatchController = [[RIGoogleAnalyticsDispatchController alloc]
+                                       initWithAnalytics:(GAI *)self.mockAnalytics];
+    self.tracker.cart = [[RITrackingCart alloc] initWithPath:nil];
+}
+
+- (void)testTrackerSendsScreenNameWithHitWithoutSettingIt
+{
+    [self.tracker trackScreenWithName:@"foo"];
+    [self.tracker trackScreenWithName:@"bar"];
+    
+    NSAssert(0 == self.mockTracker.setCount, @"Expected shared tracker not to be changed");
+    NSAssert(2 == self.mockTracker.hitCount, @"Expected a hit per screen");
+    NSAssert([self.mockTracker.hits[0][kGAIHitType] isEqualToString:kGAIAppView] &&
+             [self.mockTracker.hits[0][kGAIScreenName] isEqualToString:@"foo"] &&
+             [self.mockTracker.hits[1][kGAIScreenName] isEqualToString:@"bar"],
+             @"Expected app view hits carrying the screen name");
+}
+
+- (void)testTrackerSendsHitsEqualToDictionaryBuilder
+{
+    [self.tracker trackEvent:@"label" value:@42 action:@"action" category:@"category" data:nil];
+    [self.tracker trackEvent:@"label" value:nil action:nil category:@"category" data:nil];
+    [self.tracker trackExceptionWithName:@"exception"];
+    
+    NSArray *expected = @[
+                          [[GAIDictionaryBuilder createEventWithCategory:@"category"
+                                                                  action:@"action"
+                                                                   label:@"label"
+                                                                   value:@42] build],
+                          [[GAIDictionaryBuilder createEventWithCategory:@"category"
+                                                                  action:nil
+                                                                   label:@"label"
+                                                                   value:nil] build],
+                          [[GAIDictionaryBuilder createExceptionWithDescription:@"exception"
+                                                                      withFatal:NO] build]
+                          ];
+    
+    NSAssert([self.mockTracker.hits isEqualToArray:expected],
+             @"Expected hits from templates to equal the dictionary builder's");
+}
+
+- (void)testTrackerResolvesGoogleAnalyticsTrackerOnce
+{
+    __block NSUInteger defaultTrackerCount = 0;
+    RIGoogleAnalyticsMockTracker *mockTracker = self.mockTracker;
+    RIGoogleAnalyticsTracker *tracker = [[RIGoogleAnalyticsTracker alloc] init];
+    
+    MBSwizzleWithBlockAndRun(@"GAI", @selector(defaultTracker), NO, ^id<GAITracker>(GAI *gai) {
+        defaultTrackerCount++;
+        return mockTracker;
+    }, ^{
+        for (NSUInteger idx = 0; idx < 10; idx++) {
+            [tracker trackScreenWithName:@"foo"];
+        }
+    });
+    
+    NSAssert(1 == defaultTrackerCount, @"Expected default tracker to be resolved once");
+    NSAssert(10 == mockTracker.hitCount, @"Expected hits to be sent to the resolved tracker");
+}
+
+- (void)testTrackerSendsTransactionAndItemsOfCartOnCheckout
+{
+    RITrackingProduct *product = [[RITrackingProduct alloc] init];
+    product.identifier = @"sku";
+    product.name = @"name";
+    product.category = @"category";
+    product.price = @2.5;
+    product.quantity = @2;
+    
+    [self.tracker trackProductAddToCart:product];
+    [self.tracker trackProductAddToCart:product];
+    [self.tracker trackRemoveFromCartForProductWithID:@"sku" quantity:@1];
+    
+    NSAssert(0 == self.mockTracker.hitCount, @"Expected no hits before checkout");
+    
+    RITrackingTotal *total = [[RITrackingTotal alloc] init];
+    total.tax = @1;
+    total.shipping = @3;
+    total.currency = @"EUR";
+    [self.tracker trackCheckoutWithTransactionId:@"transaction" total:total];
+    
+    NSArray *expected = @[
+                          [[GAIDictionaryBuilder createTransactionWithId:@"transaction"
+                                                             affiliation:nil
+                                                                 revenue:@7.5
+                                                                     tax:@1
+                                                                shipping:@3
+                                                            currencyCode:@"EUR"] build],
+                          [[GAIDictionaryBuilder createItemWithTransactionId:@"transaction"
+                                                                        name:@"name"
+                                                                         sku:@"sku"
+                                                                    category:@"category"
+                                                                       price:@2.5
+                                                                    quantity:@3
+                                                                currencyCode:@"EUR"] build]
+                          ];
+    
+    NSAssert([self.mockTracker.hits isEqualToArray:expected],
+             @"Expected transaction with the cart's value followed by its items");
+    NSAssert([self.mockAnalytics.dispatchedHitCounts isEqualToArray:@[@2]],
+             @"Expected transaction and items to be dispatched together");
+    NSAssert(0 == self.tracker.cart.count, @"Expected empty cart after checkout");
+}
+
+- (void)testDispatchControllerDispatchesWhenPendingHitsReachThreshold
+{
+    self.tracker.dispatchController.threshold = 10;
+    
+    for (NSUInteger idx = 0; idx < 25; idx++) {
+        [self.tracker trackScreenWithName:@"foo"];
+    }
+    
+    NSAssert([self.mockAnalytics.dispatchedHitCounts isEqualToArray:@[@10, @10]],
+             @"Expected a dispatch whenever ten hits are pending");
+    NSAssert(5 == self.mockAnalytics.pendingHitCount, @"Expected remaining hits to be pending");
+    
+    [self.tracker.dispatchController intervalDidElapse];
+    
+    NSAssert([self.mockAnalytics.dispatchedHitCounts isEqualToArray:@[@10, @10, @5]],
+             @"Expected remaining hits to be dispatched when the interval elapsed");
+}
+
+- (void)testDispatchControllerStretchesIntervalWhileIdle
+{
+    RIGoogleAnalyticsDispatchController *controller = self.tracker.dispatchController;
+    controller.minimumInterval = 5;
+    controller.maximumInterval = 30;
+    [controller start];
+    
+    NSAssert(5 == self.mockAnalytics.dispatchInterval, @"Expected to start with the minimum interval");
+    
+    NSMutableArray *intervals = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 4; idx++) {
+        [controller intervalDidElapse];
+        [intervals addObject:@(self.mockAnalytics.dispatchInterval)];
+    }
+    
+    NSAssert([intervals isEqualToArray:@[@10, @20, @30, @30]],
+             @"Expected interval to double while idle up to the maximum");
+    NSAssert(0 == self.mockAnalytics.dispatchedHitCounts.count, @"Expected no dispatch while idle");
+    
+    [self.tracker trackScreenWithName:@"foo"];
+    
+    NSAssert(5 == self.mockAnalytics.dispatchInterval && 5 == controller.interval,
+             @"Expected a hit to reset the interval to the minimum");
+    
+    [controller intervalDidElapse];
+    
+    NSAssert([self.mockAnalytics.dispatchedHitCounts isEqualToArray:@[@1]] &&
+             5 == self.mockAnalytics.dispatchInterval,
+             @"Expected the hit to be dispatched without stretching the interval");
+}
+
+@end
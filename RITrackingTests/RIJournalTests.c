@@ -0,0 +1,345 @@
+//
+//  RIJournalTests.c
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+//  Tests and benchmark of the journal in plain C, each run against a fresh temporary directory:
+//
+//      ./obj/RIJournalTests [benchmark]
+//
+
+#include "RIJournal.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RI_JOURNAL_TESTS_CHECK(condition, message) \
+do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: %s\n", __func__, __LINE__, (message)); \
+        return false; \
+    } \
+} while (0)
+
+typedef struct RIJournalTestsRecovery {
+    uint64_t identifiers[1024];
+    uint32_t values[1024];
+    size_t count;
+    size_t total;
+    bool inOrder;
+} RIJournalTestsRecovery;
+
+static void RIJournalTestsRecoverEntry(uint64_t identifier,
+                                       const void *payload,
+                                       size_t length,
+                                       void *context)
+{
+    RIJournalTestsRecovery *recovery = context;
+    uint32_t value = 0;
+    if (sizeof(value) == length) memcpy(&value, payload, sizeof(value));
+    
+    if (value != recovery->total) recovery->inOrder = false;
+    if (recovery->count < 1024) {
+        recovery->identifiers[recovery->count] = identifier;
+        recovery->values[recovery->count] = value;
+        recovery->count++;
+    }
+    recovery->total++;
+}
+
+static size_t RIJournalTestsRecover(const char *directory, RIJournalTestsRecovery *recovery)
+{
+    memset(recovery, 0, sizeof(RIJournalTestsRecovery));
+    recovery->inOrder = true;
+    RIJournal *journal = RIJournalOpen(directory, 4096);
+    if (!journal) return 0;
+    RIJournalRecover(journal, RIJournalTestsRecoverEntry, recovery);
+    
+    for (size_t idx = 0; idx < recovery->count; idx++) {
+        RIJournalAcknowledge(journal, recovery->identifiers[idx]);
+    }
+    RIJournalClose(journal);
+    return recovery->total;
+}
+
+static size_t RIJournalTestsSegmentFileCount(const char *directory)
+{
+    size_t count = 0;
+    DIR *dir = opendir(directory);
+    struct dirent *entry;
+    while (dir && (entry = readdir(dir))) {
+        size_t length = strlen(entry->d_name);
+        if (4 < length && 0 == strcmp(entry->d_name + length - 4, ".seg")) count++;
+    }
+    if (dir) closedir(dir);
+    return count;
+}
+
+static uint64_t RIJournalTestsNow(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+}
+
+#pragma mark - Tests
+
+static bool RIJournalTestsRecoversOnlyUnacknowledgedEntriesAndPurgesSegments(const char *directory)
+{
+    RIJournal *journal = RIJournalOpen(directory, 4096);
+    RI_JOURNAL_TESTS_CHECK(journal, "Expected journal to open");
+    
+    for (uint32_t value = 0; value < 1000; value++) {
+        uint64_t identifier = RIJournalAppend(journal, &value, sizeof(value));
+        RI_JOURNAL_TESTS_CHECK(0 != identifier, "Expected entry to be appended");
+        // Leave one in three entries unacknowledged, as if the process died before processing
+        if (0 != value % 3) RIJournalAcknowledge(journal, identifier);
+    }
+    RIJournalClose(journal);
+    
+    RIJournalTestsRecovery recovery;
+    memset(&recovery, 0, sizeof(recovery));
+    journal = RIJournalOpen(directory, 4096);
+    RIJournalRecover(journal, RIJournalTestsRecoverEntry, &recovery);
+    
+    RI_JOURNAL_TESTS_CHECK(334 == recovery.count, "Expected all unacknowledged entries to be recovered");
+    for (size_t idx = 0; idx < recovery.count; idx++) {
+        RI_JOURNAL_TESTS_CHECK(idx * 3 == recovery.values[idx], "Expected unacknowledged entries in order");
+        RIJournalAcknowledge(journal, recovery.identifiers[idx]);
+    }
+    RIJournalClose(journal);
+    
+    RI_JOURNAL_TESTS_CHECK(1 == RIJournalTestsSegmentFileCount(directory),
+                           "Expected only the segment last appended to be left once all entries are "
+                           "acknowledged");
+    return true;
+}
+
+static bool RIJournalTestsRecoveryStopsAtTornEntry(const char *directory)
+{
+    RIJournal *journal = RIJournalOpen(directory, 4096);
+    RI_JOURNAL_TESTS_CHECK(journal, "Expected journal to open");
+    for (uint32_t value = 0; value < 10; value++) {
+        RIJournalAppend(journal, &value, sizeof(value));
+    }
+    RIJournalClose(journal);
+    
+    // Corrupt the payload of the last entry, as left by a write torn by a system crash
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%08x.seg", directory, 1u);
+    int fd = open(path, O_WRONLY);
+    RI_JOURNAL_TESTS_CHECK(0 <= fd, "Expected the segment file to exist");
+    pwrite(fd, "\xff", 1, 16 + 9 * 32 + 24);
+    close(fd);
+    
+    RIJournalTestsRecovery recovery;
+    RI_JOURNAL_TESTS_CHECK(9 == RIJournalTestsRecover(directory, &recovery),
+                           "Expected recovery to stop at the torn entry");
+    return true;
+}
+
+static bool RIJournalTestsSurvivesFailedSegmentRotation(const char *directory)
+{
+    // Permissions do not keep the superuser from creating a segment
+    if (0 == geteuid()) return true;
+    
+    RIJournal *journal = RIJournalOpen(directory, 4096);
+    RI_JOURNAL_TESTS_CHECK(journal, "Expected journal to open");
+    uint32_t value = 0;
+    uint64_t identifier = RIJournalAppend(journal, &value, sizeof(value));
+    
+    // No new segment can be created in a read-only directory
+    chmod(directory, 0500);
+    while (RIJournalAppend(journal, &value, sizeof(value))) {
+        value++;
+    }
+    
+    bool failed = (0 == RIJournalAppend(journal, &value, sizeof(value)) &&
+                   !RIJournalAcknowledge(journal, identifier) &&
+                   !RIJournalSync(journal));
+    chmod(directory, 0700);
+    RI_JOURNAL_TESTS_CHECK(failed, "Expected calls without segment to fail");
+    
+    RI_JOURNAL_TESTS_CHECK(0 != RIJournalAppend(journal, &value, sizeof(value)),
+                           "Expected append to rotate once a segment can be created again");
+    RI_JOURNAL_TESTS_CHECK(RIJournalAcknowledge(journal, identifier),
+                           "Expected acknowledgement after rotation");
+    RI_JOURNAL_TESTS_CHECK(RIJournalSync(journal), "Expected sync after rotation");
+    RIJournalClose(journal);
+    return true;
+}
+
+static bool RIJournalTestsLeavesSegmentsOfOpenJournalToIt(const char *directory)
+{
+    RIJournal *previous = RIJournalOpen(directory, 4096);
+    RI_JOURNAL_TESTS_CHECK(previous, "Expected journal to open");
+    uint64_t identifiers[600];
+    for (uint32_t value = 0; value < 300; value++) {
+        identifiers[value] = RIJournalAppend(previous, &value, sizeof(value));
+    }
+    
+    // A journal opened again on the directory, as on a restart, leaves entries in flight alone
+    RIJournal *journal = RIJournalOpen(directory, 4096);
+    RI_JOURNAL_TESTS_CHECK(journal, "Expected journal to open again");
+    RIJournalTestsRecovery recovery;
+    memset(&recovery, 0, sizeof(recovery));
+    RI_JOURNAL_TESTS_CHECK(0 == RIJournalRecover(journal, RIJournalTestsRecoverEntry, &recovery),
+                           "Expected no entry of the journal still open to be recovered");
+    
+    // Both journals rotate through segments without taking each other's
+    for (uint32_t value = 300; value < 600; value++) {
+        identifiers[value] = RIJournalAppend(previous, &value, sizeof(value));
+        RIJournalAppend(journal, &value, sizeof(value));
+    }
+    for (size_t idx = 0; idx < 600; idx++) {
+        RI_JOURNAL_TESTS_CHECK(0 != identifiers[idx], "Expected entry to be appended");
+        RIJournalAcknowledge(previous, identifiers[idx]);
+    }
+    RIJournalClose(previous);
+    RIJournalClose(journal);
+    
+    RI_JOURNAL_TESTS_CHECK(300 == RIJournalTestsRecover(directory, &recovery),
+                           "Expected exactly the unacknowledged entries of the second journal to be "
+                           "recovered");
+    RI_JOURNAL_TESTS_CHECK(300 == recovery.values[0] && 599 == recovery.values[299],
+                           "Expected the entries of the second journal in order");
+    return true;
+}
+
+static void RIJournalTestsStopProcess(void)
+{
+    static uint32_t published;
+    if (100 == published++) raise(SIGSTOP);
+}
+
+static bool RIJournalTestsRecoversAfterProcessKilledPartwayThroughEntry(const char *directory)
+{
+    pid_t pid = fork();
+    RI_JOURNAL_TESTS_CHECK(0 <= pid, "Expected the appending process to start");
+    
+    if (0 == pid) {
+        // The child stops itself with its 101st entry written except for its size
+        RIJournalEntryWillPublishHook = RIJournalTestsStopProcess;
+        RIJournal *journal = RIJournalOpen(directory, 1 << 16);
+        for (uint32_t value = 0; journal; value++) {
+            RIJournalAppend(journal, &value, sizeof(value));
+        }
+        _exit(1);
+    }
+    
+    int status;
+    waitpid(pid, &status, WUNTRACED);
+    bool stopped = WIFSTOPPED(status);
+    kill(pid, SIGKILL);
+    waitpid(pid, &status, 0);
+    RI_JOURNAL_TESTS_CHECK(stopped, "Expected the appending process to stop partway through an entry");
+    
+    RIJournalTestsRecovery recovery;
+    RI_JOURNAL_TESTS_CHECK(100 == RIJournalTestsRecover(directory, &recovery),
+                           "Expected exactly the entries completed before the kill to be recovered");
+    RI_JOURNAL_TESTS_CHECK(recovery.inOrder && 99 == recovery.values[99],
+                           "Expected the completed entries in order");
+    return true;
+}
+
+#pragma mark - Benchmark
+
+static void RIJournalTestsBenchmark(const char *directory)
+{
+    size_t const payloadSizes[] = {32, 256, 1024};
+    size_t const count = 100000;
+    
+    for (size_t idx = 0; idx < sizeof(payloadSizes) / sizeof(payloadSizes[0]); idx++) {
+        RIJournal *journal = RIJournalOpen(directory, 1 << 20);
+        void *payload = calloc(1, payloadSizes[idx]);
+        if (!journal || !payload) {
+            free(payload);
+            RIJournalClose(journal);
+            return;
+        }
+    
+        uint64_t start = RIJournalTestsNow();
+        for (size_t call = 0; call < count; call++) {
+            uint64_t identifier = RIJournalAppend(journal, payload, payloadSizes[idx]);
+            RIJournalAcknowledge(journal, identifier);
+        }
+        double seconds = (RIJournalTestsNow() - start) / 1e9;
+    
+        printf("RIJournalBenchmark payload=%4zuB append+acknowledge=%.0f/s (%.1f MB/s)\n",
+               payloadSizes[idx], count / seconds, count * payloadSizes[idx] / seconds / 1e6);
+    
+        free(payload);
+        RIJournalClose(journal);
+    }
+}
+
+#pragma mark - Main
+
+static bool RIJournalTestsMakeDirectory(char *directory)
+{
+    const char *temporary = getenv("TMPDIR");
+    snprintf(directory, PATH_MAX, "%s/RIJournalTests.XXXXXX", temporary ? temporary : "/tmp");
+    return NULL != mkdtemp(directory);
+}
+
+static void RIJournalTestsRemoveDirectory(const char *directory)
+{
+    char path[PATH_MAX];
+    DIR *dir = opendir(directory);
+    struct dirent *entry;
+    while (dir && (entry = readdir(dir))) {
+        if ('.' == entry->d_name[0]) continue;
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        unlink(path);
+    }
+    if (dir) closedir(dir);
+    rmdir(directory);
+}
+
+int main(int argc, const char *argv[])
+{
+    static const struct {
+        const char *name;
+        bool (*run)(const char *directory);
+    } tests[] = {
+        {"RecoversOnlyUnacknowledgedEntriesAndPurgesSegments",
+            RIJournalTestsRecoversOnlyUnacknowledgedEntriesAndPurgesSegments},
+        {"RecoveryStopsAtTornEntry", RIJournalTestsRecoveryStopsAtTornEntry},
+        {"SurvivesFailedSegmentRotation", RIJournalTestsSurvivesFailedSegmentRotation},
+        {"LeavesSegmentsOfOpenJournalToIt", RIJournalTestsLeavesSegmentsOfOpenJournalToIt},
+        {"RecoversAfterProcessKilledPartwayThroughEntry",
+            RIJournalTestsRecoversAfterProcessKilledPartwayThroughEntry},
+    };
+    char directory[PATH_MAX];
+    int failures = 0;
+    
+    for (size_t idx = 0; idx < sizeof(tests) / sizeof(tests[0]); idx++) {
+        if (!RIJournalTestsMakeDirectory(directory)) {
+            fprintf(stderr, "Unable to create a temporary directory: %s\n", strerror(errno));
+            return 1;
+        }
+        bool passed = tests[idx].run(directory);
+        printf("%s %s\n", passed ? "PASS" : "FAIL", tests[idx].name);
+        failures += !passed;
+        RIJournalTestsRemoveDirectory(directory);
+    }
+    
+    if (1 < argc && 0 == strcmp(argv[1], "benchmark") && RIJournalTestsMakeDirectory(directory)) {
+        RIJournalTestsBenchmark(directory);
+        RIJournalTestsRemoveDirectory(directory);
+    }
+    
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+//
+//  RILogTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach_time.h>
+#import "RILog.h"
+
+static NSUInteger RILogTestsEvaluationCount;
+
+static NSString *RILogTestsEvaluate(void)
+{
+    RILogTestsEvaluationCount++;
+    return @"evaluated";
+}
+
+static void RILogTestsLogError(NSUInteger idx)
+{
+    RILog(RILogLevelError, @"Repeated error %lu", (unsigned long)idx);
+}
+
+@interface RILogTests : XCTestCase
+
+@property NSMutableArray *messages;
+
+@end
+
+@implementation RILogTests
+
+- (void)setUp
+{
+    [super setUp];
+    
+    NSMutableArray *messages = [NSMutableArray array];
+    self.messages = messages;
+    RILogSetHandler(^(RILogLevel level, NSString *message) {
+        [messages addObject:message];
+    });
+    RILogSetLevel(RILogLevelWarning);
+}
+
+- (void)tearDown
+{
+    RILogFlush();
+    RILogSetHandler(nil);
+    RILogSetLevel(RILogLevelWarning);
+    [super tearDown];
+}
+
+- (void)testLogSkipsArgumentsOfDisabledLevels
+{
+    RILogTestsEvaluationCount = 0;
+    
+    RILog(RILogLevelDebug, @"%@", RILogTestsEvaluate());
+    RILog(RILogLevelInfo, @"%@", RILogTestsEvaluate());
+    
+    NSAssert(0 == RILogTestsEvaluationCount, @"Expected arguments of disabled levels not to be evaluated");
+    
+    RILogSetLevel(RILogLevelDebug);
+    RIDebugLog(@"%@", RILogTestsEvaluate());
+    RILogFlush();
+    
+    NSAssert(1 == RILogTestsEvaluationCount, @"Expected arguments of enabled levels to be evaluated");
+    NSAssert([self.messages isEqualToArray:@[@"RITracking: evaluated"]], @"Expected debug record to be written");
+}
+
+- (void)testLogWritesRecordsInOrderFromBackgroundWriter
+{
+    RILogSetLevel(RILogLevelInfo);
+    NSMutableArray *expected = [NSMutableArray array];
+    
+    for (NSUInteger idx = 0; idx < 100; idx++) {
+        RILog(RILogLevelInfo, @"Record %lu", (unsigned long)idx);
+        [expected addObject:[NSString stringWithFormat:@"RITracking: Record %lu", (unsigned long)idx]];
+    }
+    RILogFlush();
+    
+    NSAssert([self.messages isEqualToArray:expected], @"Expected records to be written in order");
+}
+
+- (void)testLogRateLimitsRepeatedErrorsFromOneCallSite
+{
+    uint64_t suppressed = RILogSuppressedCount();
+    
+    for (NSUInteger idx = 0; idx < 1000; idx++) {
+        RILogTestsLogError(idx);
+    }
+    RILogFlush();
+    
+    NSAssert(1 == self.messages.count && [self.messages[0] hasSuffix:@"Repeated error 0"],
+             @"Expected only the first of repeated errors to be written");
+    NSAssert(999 == RILogSuppressedCount() - suppressed, @"Expected repeated errors to be counted");
+    
+    [NSThread sleepForTimeInterval:1.1];
+    RILogTestsLogError(1000);
+    RILogFlush();
+    
+    NSAssert(2 == self.messages.count &&
+             [self.messages[1] hasSuffix:@"Repeated error 1000 (999 similar records suppressed)"],
+             @"Expected next error after the window to tell the number suppressed");
+}
+
+- (void)testBenchmarkDisabledAndRateLimitedLogCalls
+{
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    NSUInteger const count = 1000000;
+    
+    uint64_t start = mach_absolute_time();
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        RILog(RILogLevelDebug, @"Disabled %@", @(idx));
+    }
+    double disabled = (mach_absolute_time() - start) * timebase.numer / timebase.denom / (double)count;
+    
+    start = mach_absolute_time();
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        RILog(RILogLevelError, @"Benchmark error %lu", (unsigned long)idx);
+    }
+    double limited = (mach_absolute_time() - start) * timebase.numer / timebase.denom / (double)count;
+    
+    NSLog(@"RILogBenchmark disabled=%.1fns/call rate-limited error=%.1fns/call", disabled, limited);
+}
+
+@end
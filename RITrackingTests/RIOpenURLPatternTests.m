@@ -0,0 +1,60 @@
+//
+//  RIOpenURLPatternTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RIOpenURLPattern.h"
+
+@interface RIOpenURLPatternTests : XCTestCase
+
+@end
+
+@implementation RIOpenURLPatternTests
+
+- (void)testPatternCompilesCaptureDirectivesInOrder
+{
+    RIOpenURLPattern *pattern = [RIOpenURLPattern patternWithString:@".*/{country}/c/{category}\\.html.*"
+                                                              error:NULL];
+    
+    NSAssert([pattern.macros isEqualToArray:(@[@"country", @"category"])],
+             @"Expected macros to be captured in order");
+    NSAssert([pattern.regex.pattern isEqualToString:@".*/(.*)/c/(.*)\\.html.*"],
+             @"Expected capture directives to be replaced by capture groups");
+}
+
+- (void)testPatternKeepsUnterminatedBraceLiteral
+{
+    RIOpenURLPattern *pattern = [RIOpenURLPattern patternWithString:@".*/{sku}/x\\{" error:NULL];
+    
+    NSAssert([pattern.macros isEqualToArray:(@[@"sku"])], @"Expected only terminated directive");
+    NSAssert([pattern.regex.pattern isEqualToString:@".*/(.*)/x\\{"],
+             @"Expected unterminated brace to be kept literal");
+}
+
+- (void)testPatternReportsInvalidRegularExpression
+{
+    NSError *error;
+    RIOpenURLPattern *pattern = [RIOpenURLPattern patternWithString:@"{sku}/(" error:&error];
+    
+    NSAssert(nil == pattern && nil != error, @"Expected invalid pattern to fail with error");
+}
+
+- (void)testPatternCompilationScalesLinearly
+{
+    NSMutableString *string = [NSMutableString string];
+    for (NSUInteger i = 0; i < 2000; i++) [string appendFormat:@"/{macro%lu}", (unsigned long)i];
+    
+    NSDate *start = [NSDate date];
+    RIOpenURLPattern *pattern = [RIOpenURLPattern patternWithString:string error:NULL];
+    NSTimeInterval duration = -[start timeIntervalSinceNow];
+    
+    NSLog(@"Compiled pattern with %lu capture directives in %.3fms",
+          (unsigned long)pattern.macros.count, duration * 1000);
+    NSAssert(2000 == pattern.macros.count, @"Expected all capture directives to be compiled");
+}
+
+@end
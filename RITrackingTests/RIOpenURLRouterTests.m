@@ -0,0 +1,196 @@
+//
+//  RIOpenURLRouterTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach_time.h>
+#import "RIOpenURLRouter.h"
+#import "RIOpenURLHandler.h"
+#import "RIOpenURLPattern.h"
+
+static RIOpenURLHandler *RIOpenURLRouterTestsHandler(NSString *string, void (^block)(NSDictionary *))
+{
+    RIOpenURLPattern *pattern = [RIOpenURLPattern patternWithString:string error:NULL];
+    return [[RIOpenURLHandler alloc] initWithHandlerBlock:block pattern:pattern];
+}
+
+@interface RIOpenURLRouterTests : XCTestCase
+
+@end
+
+@implementation RIOpenURLRouterTests
+
+- (void)testPatternSplitsIntoTrieComponents
+{
+    RIOpenURLPattern *pattern = [RIOpenURLPattern patternWithString:@"^app://shop\\.example/d/{sku}/x"
+                                                              error:NULL];
+    NSAssert([pattern.components isEqualToArray:(@[@"app", @"shop.example", @"d"])],
+             @"Expected literal components up to the capture");
+    
+    pattern = [RIOpenURLPattern patternWithString:@"^app://shop/d/product" error:NULL];
+    NSAssert([pattern.components isEqualToArray:(@[@"app", @"shop", @"d"])],
+             @"Expected last segment to be left out as it may be part of a longer one");
+    
+    pattern = [RIOpenURLPattern patternWithString:@"^app://shop/d/?x" error:NULL];
+    NSAssert([pattern.components isEqualToArray:(@[@"app", @"shop"])],
+             @"Expected segment followed by optional separator to be left out");
+    
+    pattern = [RIOpenURLPattern patternWithString:@"app://shop/d/{sku}" error:NULL];
+    NSAssert(0 == pattern.components.count, @"Expected unanchored pattern to have no components");
+    
+    pattern = [RIOpenURLPattern patternWithString:@"^app://shop/d|web://shop/d" error:NULL];
+    NSAssert(0 == pattern.components.count, @"Expected pattern with alternatives to have no components");
+}
+
+- (void)testRouterCallsTrieAndFallbackHandlersInOrderOfRegistration
+{
+    NSMutableArray *calls = [NSMutableArray array];
+    RIOpenURLRouter *router = [[RIOpenURLRouter alloc] init];
+    
+    [router addHandlers:@[
+        RIOpenURLRouterTestsHandler(@".*/d/{sku}.*", ^(NSDictionary *params) {
+            [calls addObject:@"regex"];
+        }),
+        RIOpenURLRouterTestsHandler(@"app://shop/{country}/d/{sku}", ^(NSDictionary *params) {
+            NSAssert([params[@"country"] isEqualToString:@"de"], @"Expected country segment");
+            NSAssert([params[@"sku"] isEqualToString:@"42"], @"Expected sku segment");
+            NSAssert([params[@"utm"] isEqualToString:@"push"], @"Expected query parameter");
+            [calls addObject:@"trie"];
+        }),
+        RIOpenURLRouterTestsHandler(@"app://shop/{country}/d$", ^(NSDictionary *params) {
+            NSAssert(NO, @"Unexpected call of anchored handler on longer path");
+        }),
+        RIOpenURLRouterTestsHandler(@"app://shop/de/d/{sku}", ^(NSDictionary *params) {
+            [calls addObject:@"literal"];
+        }),
+        RIOpenURLRouterTestsHandler(@"app://other/{country}/d/{sku}", ^(NSDictionary *params) {
+            NSAssert(NO, @"Unexpected call of handler for other host");
+        })
+    ]];
+    
+    [router handleOpenURL:[NSURL URLWithString:@"app://shop/de/d/42?utm=push"]];
+    
+    NSAssert([calls isEqualToArray:(@[@"regex", @"trie", @"literal"])],
+             @"Expected all matching handlers to be called in order of registration");
+}
+
+- (void)testRouterMatchesLikePerHandlerRegexLoop
+{
+    NSArray *patterns = @[@"app://product/{sku}", @"^app://product/{sku}", @"^app://product/{sku}$",
+                          @"^app://product/{sku}/reviews", @"^app://{host}/{sku}", @"app://product$",
+                          @"^app://product", @"^app://product/1", @"^app://product/?{sku}",
+                          @"^app://product//{sku}", @"^app:///{path}", @".*/{country}/d/{sku}.*",
+                          @"^(app|web)://product/{sku}", @"^app://product/x|^web://product/{sku}",
+                          @"^app://shop/{country}/d/{sku}\\?ref=.*", @"^web://product/{sku}"];
+    NSArray *strings = @[@"app://product/1", @"app://product/1/reviews?ref=x", @"myapp://product/1",
+                         @"app://product", @"app://products/1", @"app://product/12?x=1#top",
+                         @"app://product", @"app://product1", @"app://product//1", @"app:///a/b",
+                         @"web://product/1", @"app://shop/de/d/42?ref=push", @"x://y/app://product/2"];
+    
+    NSMutableArray *handlers = [NSMutableArray arrayWithCapacity:patterns.count];
+    __block NSMutableArray *calls;
+    for (NSUInteger idx = 0; idx < patterns.count; idx++) {
+        [handlers addObject:RIOpenURLRouterTestsHandler(patterns[idx], ^(NSDictionary *params) {
+            [calls addObject:@[@(idx), params]];
+        })];
+    }
+    RIOpenURLRouter *router = [[RIOpenURLRouter alloc] init];
+    [router addHandlers:handlers];
+    
+    for (NSString *string in strings) {
+        NSURL *url = [NSURL URLWithString:string];
+        
+        calls = [NSMutableArray array];
+        for (RIOpenURLHandler *handler in handlers) [handler handleOpenURL:url];
+        NSArray *expected = calls;
+        
+        calls = [NSMutableArray array];
+        [router handleOpenURL:url];
+        
+        NSAssert([calls isEqualToArray:expected], @"Expected router to call the handlers as the regex "
+                 @"loop for %@: %@ instead of %@", string, calls, expected);
+    }
+    
+    calls = [NSMutableArray array];
+    [router handleOpenURL:[NSURL URLWithString:@"app://product/1/reviews?ref=x"]];
+    NSAssert([calls[0] isEqualToArray:(@[@0, @{@"sku": @"1/reviews?ref=x", @"ref": @"x"}])],
+             @"Expected trailing capture to take the rest of the URL");
+    
+    calls = [NSMutableArray array];
+    [router handleOpenURL:[NSURL URLWithString:@"myapp://product/1"]];
+    NSAssert([calls isEqualToArray:(@[@[@0, @{@"sku": @"1"}]])],
+             @"Expected only the unanchored pattern to match within the scheme");
+}
+
+- (void)testRouterCachesMatchesAndEvictsLeastRecentlyUsed
+{
+    __block NSUInteger called = 0;
+    RIOpenURLRouter *router = [[RIOpenURLRouter alloc] init];
+    router.cacheCapacity = 2;
+    [router addHandler:RIOpenURLRouterTestsHandler(@"app://shop/d/{sku}", ^(NSDictionary *params) {
+        called++;
+    })];
+    
+    for (NSString *sku in @[@"1", @"2", @"1", @"3", @"2"]) {
+        NSString *string = [NSString stringWithFormat:@"app://shop/d/%@", sku];
+        [router handleOpenURL:[NSURL URLWithString:string]];
+    }
+    
+    NSAssert(5 == called, @"Expected handler to be called for cached URLs as well");
+    NSAssert(1 == router.cacheHitCount, @"Expected repeated recent URL to hit the cache");
+    NSAssert(4 == router.cacheMissCount, @"Expected new and evicted URLs to miss the cache");
+    NSAssert(2 == router.cacheEvictionCount, @"Expected least recently used URLs to be evicted");
+    
+    __block BOOL calledAdded = NO;
+    [router addHandler:RIOpenURLRouterTestsHandler(@"app://shop/d", ^(NSDictionary *params) {
+        calledAdded = YES;
+    })];
+    [router handleOpenURL:[NSURL URLWithString:@"app://shop/d/2"]];
+    
+    NSAssert(calledAdded && 5 == router.cacheMissCount,
+             @"Expected route table change to invalidate the cache");
+}
+
+- (void)testRouterBenchmarkAgainstPerHandlerRegexLoop
+{
+    static NSUInteger const kIterations = 1000;
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    
+    for (NSNumber *routeCount in @[@10, @100, @1000]) {
+        NSUInteger count = routeCount.unsignedIntegerValue;
+        __block NSUInteger called = 0;
+        NSMutableArray *handlers = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger idx = 0; idx < count; idx++) {
+            NSString *pattern = [NSString stringWithFormat:@"^app://shop/r%lu/{id}", (unsigned long)idx];
+            [handlers addObject:RIOpenURLRouterTestsHandler(pattern, ^(NSDictionary *params) {
+                called++;
+            })];
+        }
+        RIOpenURLRouter *router = [[RIOpenURLRouter alloc] init];
+        router.cacheCapacity = 0;
+        [router addHandlers:handlers];
+        NSURL *url = [NSURL URLWithString:[NSString stringWithFormat:@"app://shop/r%lu/42?x=1",
+                                           (unsigned long)count - 1]];
+        
+        uint64_t start = mach_absolute_time();
+        for (NSUInteger i = 0; i < kIterations; i++) {
+            for (RIOpenURLHandler *handler in handlers) [handler handleOpenURL:url];
+        }
+        uint64_t loop = (mach_absolute_time() - start) * timebase.numer / timebase.denom;
+        
+        start = mach_absolute_time();
+        for (NSUInteger i = 0; i < kIterations; i++) [router handleOpenURL:url];
+        uint64_t trie = (mach_absolute_time() - start) * timebase.numer / timebase.denom;
+        
+        NSLog(@"%4lu routes: regex loop %8.2fus/url, router %6.2fus/url",
+              (unsigned long)count, loop / 1000.0 / kIterations, trie / 1000.0 / kIterations);
+        NSAssert(2 * kIterations == called, @"Expected exactly one match per URL and pass");
+    }
+}
+
+@end
@@ -0,0 +1,37 @@
+//
+//  RIOpenURLViewTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RIOpenURLView.h"
+
+@interface RIOpenURLViewTests : XCTestCase
+
+@end
+
+@implementation RIOpenURLViewTests
+
+- (void)testViewSplitsComponentsAndDecodesQueryParameters
+{
+    NSURL *url = [NSURL URLWithString:@"app://shop.example:8080//de/d/42/?q=red%20shoes&flag&utm=push#top"];
+    RIOpenURLView *view = [[RIOpenURLView alloc] initWithURL:url];
+    
+    NSAssert([view.components isEqualToArray:(@[@"app", @"shop.example:8080", @"de", @"d", @"42"])],
+             @"Expected scheme, authority and non-empty path segments");
+    NSAssert([view.queryParameters isEqualToDictionary:(@{@"q": @"red shoes", @"utm": @"push"})],
+             @"Expected decoded query pairs without fragment");
+}
+
+- (void)testViewWithoutSchemeSeparatorHasNoComponents
+{
+    RIOpenURLView *view = [[RIOpenURLView alloc] initWithURL:[NSURL URLWithString:@"mailto:foo@bar.com"]];
+    
+    NSAssert(nil == view.components, @"Expected no components without scheme separator");
+    NSAssert(0 == view.queryParameters.count, @"Expected no query parameters");
+}
+
+@end
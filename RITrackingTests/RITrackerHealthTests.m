@@ -0,0 +1,258 @@
+//
+//  RITrackerHealthTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RITrackerHealth.h"
+#import "RIEventInbox.h"
+#import "RIEventBudget.h"
+#import "RITrackerMock.h"
+
+@interface RITrackerHealthTests : XCTestCase
+
+@property RITrackerHealth *health;
+@property NSMutableArray *states;
+
+@end
+
+@implementation RITrackerHealthTests
+
+- (void)setUp
+{
+    [super setUp];
+    RILogSetLevel(RILogLevelError);
+    self.health = [[RITrackerHealth alloc] initWithTrackerName:@"tracker"];
+    self.health.windowSize = 10;
+    self.health.failureRate = 0.5;
+    self.health.probeCount = 2;
+    
+    NSMutableArray *states = [NSMutableArray array];
+    self.states = states;
+    self.health.stateChangeHandler = ^(RITrackerHealth *health, RITrackerHealthState state) {
+        @synchronized (states) {
+            [states addObject:@(state)];
+        }
+    };
+}
+
+- (void)callFailing:(BOOL)failing count:(NSUInteger)count
+{
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        [self.health beginCall];
+        if (failing) RITrackerReportFailure();
+        [self.health endCall];
+    }
+}
+
+- (void)testCircuitOpensWhenFailureRateReached
+{
+    [self callFailing:NO count:6];
+    [self callFailing:YES count:4];
+    
+    NSAssert(RITrackerHealthStateClosed == self.health.state, @"Expected circuit below failure rate closed");
+    
+    [self callFailing:NO count:5];
+    [self callFailing:YES count:5];
+    
+    NSAssert(RITrackerHealthStateOpen == self.health.state, @"Expected circuit at failure rate open");
+    NSAssert(1 == self.health.tripCount && 9 == self.health.failureCount, @"Expected trip and failures counted");
+    NSAssert(![self.health admitCall] && 1 == self.health.rejectedCount,
+             @"Expected calls rejected while open");
+    NSAssert([self.states isEqualToArray:@[@(RITrackerHealthStateOpen)]], @"Expected state change reported");
+}
+
+- (void)testCircuitClosesAfterSuccessfulProbes
+{
+    self.health.cooldown = 0;
+    [self callFailing:YES count:10];
+    
+    NSAssert([self.health admitCall] && [self.health admitCall], @"Expected probes admitted after cooldown");
+    NSAssert(RITrackerHealthStateHalfOpen == self.health.state, @"Expected circuit half-open");
+    NSAssert(![self.health admitCall], @"Expected calls beyond the probes rejected");
+    
+    [self callFailing:NO count:2];
+    
+    NSAssert(RITrackerHealthStateClosed == self.health.state, @"Expected circuit closed after probes");
+    NSAssert([self.states isEqualToArray:@[@(RITrackerHealthStateOpen),
+                                           @(RITrackerHealthStateHalfOpen),
+                                           @(RITrackerHealthStateClosed)]],
+             @"Expected state changes reported in order");
+}
+
+- (void)testConcurrentProbesLimitedToProbeCount
+{
+    self.health.cooldown = 0.01;
+    [self callFailing:YES count:10];
+    [NSThread sleepForTimeInterval:0.02];
+    
+    __block int32_t admittedCount = 0;
+    RITrackerHealth *health = self.health;
+    dispatch_apply(1000, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t idx) {
+        if ([health admitCall]) __atomic_add_fetch(&admittedCount, 1, __ATOMIC_RELAXED);
+    });
+    
+    NSAssert(RITrackerHealthStateHalfOpen == self.health.state, @"Expected circuit half-open");
+    NSAssert(2 == admittedCount, @"Expected only the probes admitted by callers racing to probe");
+}
+
+- (void)testCircuitReopensOnFailedProbe
+{
+    self.health.cooldown = 0;
+    [self callFailing:YES count:10];
+    
+    NSAssert([self.health admitCall], @"Expected probe admitted after cooldown");
+    [self callFailing:YES count:1];
+    
+    NSAssert(RITrackerHealthStateOpen == self.health.state && 2 == self.health.tripCount,
+             @"Expected failed probe to open the circuit again");
+}
+
+- (void)testCircuitReopensWhenProbesDoNotFinish
+{
+    self.health.cooldown = 0;
+    self.health.wedgeTimeout = 0.01;
+    [self callFailing:YES count:10];
+    
+    NSAssert([self.health admitCall] && [self.health admitCall], @"Expected probes admitted after cooldown");
+    [NSThread sleepForTimeInterval:0.02];
+    
+    NSAssert(![self.health admitCall] && RITrackerHealthStateOpen == self.health.state &&
+             2 == self.health.tripCount,
+             @"Expected probes lost before processing to open the circuit again");
+    NSAssert([self.health admitCall] && RITrackerHealthStateHalfOpen == self.health.state,
+             @"Expected the tracker probed anew after the cooldown");
+}
+
+- (void)testCircuitOpensWhileCallIsWedged
+{
+    self.health.wedgeTimeout = 0.01;
+    [self.health beginCall];
+    [NSThread sleepForTimeInterval:0.02];
+    
+    BOOL admitted = YES;
+    for (NSUInteger idx = 0; idx < 64 && admitted; idx++) {
+        admitted = [self.health admitCall];
+    }
+    
+    NSAssert(!admitted && RITrackerHealthStateOpen == self.health.state,
+             @"Expected wedged call to open the circuit while in progress");
+    
+    [self.health endCall];
+}
+
+- (void)testInboxRejectsRecordsWhileCircuitOpen
+{
+    RITrackerMock *tracker = [[RITrackerMock alloc] init];
+    RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+    inbox.health.windowSize = 10;
+    tracker.failing = YES;
+    
+    for (NSUInteger idx = 0; idx < 30; idx++) {
+        RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"screen");
+        [inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)];
+        [tracker.queue waitUntilAllOperationsAreFinished];
+    }
+    
+    NSAssert(RITrackerHealthStateOpen == inbox.health.state, @"Expected failing tracker's circuit open");
+    NSAssert(10 == tracker.screenCount && 20 == inbox.health.rejectedCount,
+             @"Expected records after the circuit opened not to reach the tracker");
+}
+
+- (void)testInboxGivesBackProbeSlotOfShedRecord
+{
+    RITrackerMock *tracker = [[RITrackerMock alloc] init];
+    RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+    inbox.overflowPolicy = RIEventInboxOverflowPolicyDropNewest;
+    inbox.health.windowSize = 10;
+    inbox.health.probeCount = 1;
+    inbox.health.cooldown = 0;
+    tracker.failing = YES;
+    
+    for (NSUInteger idx = 0; idx < 10; idx++) {
+        RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"screen");
+        [inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)];
+        [tracker.queue waitUntilAllOperationsAreFinished];
+    }
+    tracker.failing = NO;
+    
+    NSAssert(RITrackerHealthStateOpen == inbox.health.state, @"Expected failing tracker's circuit open");
+    
+    // The probe is admitted, then shed as the budget has no room for a record
+    RIEventBudgetSetLimit(RIEventBudgetUsage() + 1);
+    RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"screen");
+    [inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)];
+    RIEventBudgetSetLimit(0);
+    
+    NSAssert(RITrackerHealthStateHalfOpen == inbox.health.state &&
+             1 == [inbox shedCountForRecordKind:RIEventRecordKindScreen],
+             @"Expected the probe shed while half-open");
+    
+    record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"screen");
+    [inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)];
+    [tracker.queue waitUntilAllOperationsAreFinished];
+    
+    NSAssert(11 == tracker.screenCount && RITrackerHealthStateClosed == inbox.health.state,
+             @"Expected the next record to take the shed probe's slot and close the circuit");
+}
+
+- (void)testInboxDeliversSpilledRecordsAfterCooldownWithoutTraffic
+{
+    RITrackerMock *tracker = [[RITrackerMock alloc] init];
+    RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+    inbox.spillPath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"RITrackerHealthTests/spill"];
+    inbox.overflowPolicy = RIEventInboxOverflowPolicySpill;
+    inbox.health.windowSize = 10;
+    inbox.health.probeCount = 1;
+    inbox.health.cooldown = 0.05;
+    tracker.failing = YES;
+    
+    for (NSUInteger idx = 0; idx < 15; idx++) {
+        RIEventRecord record = RIEventRecordMakeWithName(RIEventRecordKindScreen, @"screen");
+        [inbox addRecord:RIEventArenaRecordCreate(&record, 1, nil)];
+        [tracker.queue waitUntilAllOperationsAreFinished];
+        if (9 == idx) tracker.failing = NO;
+    }
+    
+    NSAssert(10 == tracker.screenCount && 5 == inbox.spilledCount,
+             @"Expected records rejected by the open circuit to be spilled");
+    
+    // No tracking call is made after the cooldown, the spilled records probe the tracker themselves
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5];
+    while (15 > tracker.screenCount && 0 < [deadline timeIntervalSinceNow]) {
+        [NSThread sleepForTimeInterval:0.01];
+        [tracker.queue waitUntilAllOperationsAreFinished];
+    }
+    
+    NSAssert(15 == tracker.screenCount, @"Expected spilled records delivered after the cooldown");
+    NSAssert(RITrackerHealthStateClosed == inbox.health.state, @"Expected the probe to close the circuit");
+}
+
+- (void)testInboxRejectsCallsMadeAsOperationsWhileCircuitOpen
+{
+    RITrackerMock *tracker = [[RITrackerMock alloc] init];
+    RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+    inbox.health.windowSize = 10;
+    tracker.failing = YES;
+    __block NSUInteger shedCount = 0;
+    
+    for (NSUInteger idx = 0; idx < 30; idx++) {
+        [inbox addCallWithBlock:^(BOOL shed) {
+            if (shed) {
+                shedCount++;
+            } else {
+                [tracker trackScreenWithName:@"screen"];
+            }
+        } count:1 priority:RIEventInboxPriorityNormal];
+        [tracker.queue waitUntilAllOperationsAreFinished];
+    }
+    
+    NSAssert(RITrackerHealthStateOpen == inbox.health.state, @"Expected failing tracker's circuit open");
+    NSAssert(10 == tracker.screenCount && 20 == shedCount && 20 == inbox.health.rejectedCount,
+             @"Expected calls after the circuit opened not to reach the tracker");
+}
+
+@end
@@ -0,0 +1,99 @@
+//
+//  RITrackerMetricsTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach_time.h>
+#import "RITrackerMetrics.h"
+#import "RIEventInbox.h"
+#import "RITrackerMock.h"
+
+static NSUInteger const kBenchmarkEventCount = 1000000;
+
+@interface RITrackerMetricsTests : XCTestCase
+
+@end
+
+@implementation RITrackerMetricsTests
+
+- (void)testHistogramPercentilesWithinRelativeError
+{
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    RILatencyHistogram *histogram = calloc(1, sizeof(RILatencyHistogram));
+    
+    for (uint64_t value = 1; value <= 100000; value++) {
+        RILatencyHistogramRecord(histogram, value);
+    }
+    
+    RILatencyHistogramSnapshot *snapshot = [[RILatencyHistogramSnapshot alloc] initWithHistogram:histogram];
+    free(histogram);
+    
+    double p50 = 50000.0 * timebase.numer / timebase.denom;
+    double p99 = 99000.0 * timebase.numer / timebase.denom;
+    
+    NSAssert(100000 == snapshot.count, @"Expected all values to be counted");
+    NSAssert(fabs([snapshot valueAtPercentile:50] - p50) <= p50 / 16, @"Expected median within 1/16");
+    NSAssert(fabs([snapshot valueAtPercentile:99] - p99) <= p99 / 16, @"Expected 99th percentile within 1/16");
+    NSAssert(snapshot.maximum == (uint64_t)(100000.0 * timebase.numer / timebase.denom),
+             @"Expected exact maximum");
+}
+
+- (void)testInboxRecordsDepthAndLatencies
+{
+    RITrackerMock *tracker = [[RITrackerMock alloc] init];
+    RIEventInbox *inbox = [[RIEventInbox alloc] initWithTracker:tracker];
+    
+    [tracker.queue setSuspended:YES];
+    for (NSUInteger idx = 0; idx < 100; idx++) {
+        [inbox addOperationWithBlock:^{
+            if (0 == idx) [NSThread sleepForTimeInterval:0.01];
+        }];
+    }
+    
+    RITrackerMetricsSnapshot *snapshot = [inbox metricsSnapshot];
+    
+    NSAssert(100 == snapshot.queueDepth && 100 == snapshot.peakQueueDepth,
+             @"Expected entries to wait in the inbox");
+    NSAssert(0 == snapshot.processedCount, @"Expected no entry processed while suspended");
+    
+    [NSThread sleepForTimeInterval:0.01];
+    [tracker.queue setSuspended:NO];
+    [tracker.queue waitUntilAllOperationsAreFinished];
+    snapshot = [inbox metricsSnapshot];
+    
+    NSAssert(0 == snapshot.queueDepth && 100 == snapshot.peakQueueDepth, @"Expected inbox to be drained");
+    NSAssert(100 == snapshot.processedCount && 0 == snapshot.droppedCount, @"Expected entries processed");
+    NSAssert(100 == snapshot.waitLatency.count && 100 == snapshot.serviceLatency.count,
+             @"Expected a latency per entry");
+    NSAssert([snapshot.waitLatency valueAtPercentile:0] >= 10 * NSEC_PER_MSEC * 15 / 16,
+             @"Expected entries to wait while suspended");
+    NSAssert(snapshot.serviceLatency.maximum >= 10 * NSEC_PER_MSEC,
+             @"Expected slowest entry to be recorded");
+}
+
+- (void)testBenchmarkInstrumentationPerEvent
+{
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    RITrackerMetrics *metrics = calloc(1, sizeof(RITrackerMetrics));
+    
+    uint64_t start = mach_absolute_time();
+    for (NSUInteger idx = 0; idx < kBenchmarkEventCount; idx++) {
+        // As an inbox does: a clock read on adding and one after processing each entry
+        uint64_t enqueueTime = RITrackerMetricsNow();
+        RITrackerMetricsRecordEnqueue(metrics);
+        uint64_t finishTime = RITrackerMetricsNow();
+        RITrackerMetricsRecordProcessed(metrics, enqueueTime, enqueueTime, finishTime);
+    }
+    double perEvent = (mach_absolute_time() - start) * timebase.numer / timebase.denom / (double)kBenchmarkEventCount;
+    
+    free(metrics);
+    NSLog(@"RITrackerMetricsBenchmark instrumentation=%.1fns/event", perEvent);
+}
+
+@end
@@ -0,0 +1,38 @@
+//
+//  RITrackerMock.h
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "RITracking.h"
+
+/**
+ *  Stand-in tracker with a serial queue, recording the tracking calls delivered to it, to test
+ *  the inboxes and executors handing them on
+ */
+@interface RITrackerMock : NSObject <RITracker, RIEventTracking, RIScreenTracking, RIExceptionTracking>
+
+/**
+ *  The event, screen and exception names tracked, in order, nil if calls are only counted
+ */
+@property NSMutableArray *names;
+
+/**
+ *  The number of screen views tracked
+ */
+@property (readonly) NSUInteger screenCount;
+
+/**
+ *  Whether every screen view tracked is reported as failure to the tracker's health monitor
+ */
+@property BOOL failing;
+
+/**
+ *  Whether the tracker was ever called while still processing another call
+ */
+@property (readonly) BOOL concurrent;
+
+@end
@@ -0,0 +1,68 @@
+//
+//  RITrackerMock.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import "RITrackerMock.h"
+#import "RITrackerHealth.h"
+
+@interface RITrackerMock ()
+
+@property (readwrite) NSUInteger screenCount;
+@property (readwrite) BOOL concurrent;
+
+@end
+
+@implementation RITrackerMock
+{
+    int32_t _calls;
+}
+
+@synthesize queue;
+
+- (instancetype)init
+{
+    if ((self = [super init])) {
+        self.queue = [[NSOperationQueue alloc] init];
+        self.queue.maxConcurrentOperationCount = 1;
+        self.names = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)applicationDidLaunchWithOptions:(NSDictionary *)options
+{
+}
+
+- (void)trackEvent:(NSString *)event
+             value:(NSNumber *)value
+            action:(NSString *)action
+          category:(NSString *)category
+              data:(NSDictionary *)data
+{
+    [self trackName:event];
+}
+
+- (void)trackScreenWithName:(NSString *)name
+{
+    self.screenCount++;
+    [self trackName:name];
+    if (self.failing) RITrackerReportFailure();
+}
+
+- (void)trackExceptionWithName:(NSString *)name
+{
+    [self trackName:name];
+}
+
+- (void)trackName:(NSString *)name
+{
+    if (1 != __atomic_add_fetch(&_calls, 1, __ATOMIC_SEQ_CST)) self.concurrent = YES;
+    [self.names addObject:name];
+    __atomic_sub_fetch(&_calls, 1, __ATOMIC_SEQ_CST);
+}
+
+@end
@@ -0,0 +1,114 @@
+//
+//  RITrackingCartTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RITracking.h"
+#import "RITrackingCart.h"
+
+@interface RITrackingCartTests : XCTestCase
+
+@property NSString *path;
+
+@end
+
+@implementation RITrackingCartTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:
+                 [NSString stringWithFormat:@"RITrackingCartTests-%@.plist", [[NSUUID UUID] UUIDString]]];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.path error:NULL];
+    [super tearDown];
+}
+
+- (RITrackingProduct *)productWithIdentifier:(NSString *)identifier
+                                       price:(NSString *)price
+                                    quantity:(NSNumber *)quantity
+{
+    RITrackingProduct *product = [[RITrackingProduct alloc] init];
+    product.identifier = identifier;
+    product.name = [@"Product " stringByAppendingString:identifier];
+    product.price = [NSDecimalNumber decimalNumberWithString:price];
+    product.quantity = quantity;
+    product.currency = @"EUR";
+    return product;
+}
+
+- (void)testCartKeepsQuantitiesAndValueUpToDate
+{
+    RITrackingCart *cart = [[RITrackingCart alloc] initWithPath:nil];
+    
+    [cart addProduct:[self productWithIdentifier:@"a" price:@"0.10" quantity:@3]];
+    [cart addProduct:[self productWithIdentifier:@"b" price:@"2.50" quantity:nil]];
+    [cart addProduct:[self productWithIdentifier:@"a" price:@"0.10" quantity:@2]];
+    
+    NSAssert(2 == cart.count && 6 == cart.quantity, @"Expected units of a product to add up");
+    NSAssert([cart.value isEqualToNumber:[NSDecimalNumber decimalNumberWithString:@"3.00"]],
+             @"Expected exact value of the cart");
+    
+    [cart removeProductWithIdentifier:@"a" quantity:@4];
+    [cart removeProductWithIdentifier:@"c" quantity:@1];
+    
+    NSAssert(2 == cart.count && 2 == cart.quantity, @"Expected units to be removed");
+    NSAssert([cart.value isEqualToNumber:[NSDecimalNumber decimalNumberWithString:@"2.60"]],
+             @"Expected value of removed units to be subtracted");
+    
+    [cart removeProductWithIdentifier:@"b" quantity:nil];
+    
+    NSAssert(1 == cart.count && 1 == cart.quantity, @"Expected product to be removed altogether");
+    
+    // Units in the cart take the latest price
+    [cart addProduct:[self productWithIdentifier:@"a" price:@"1.00" quantity:@1]];
+    
+    NSAssert([cart.value isEqualToNumber:[NSDecimalNumber decimalNumberWithString:@"2.00"]],
+             @"Expected value with latest price");
+}
+
+- (void)testCartCheckoutReturnsProductsAndEmptiesCart
+{
+    RITrackingCart *cart = [[RITrackingCart alloc] initWithPath:self.path];
+    
+    [cart addProduct:[self productWithIdentifier:@"a" price:@"1.00" quantity:@1]];
+    [cart addProduct:[self productWithIdentifier:@"b" price:@"2.00" quantity:@2]];
+    
+    NSArray *products = [cart checkout];
+    NSDictionary *quantities = [NSDictionary dictionaryWithObjects:[products valueForKey:@"quantity"]
+                                                           forKeys:[products valueForKey:@"identifier"]];
+    
+    NSAssert([quantities isEqualToDictionary:@{@"a": @1, @"b": @2}], @"Expected products on checkout");
+    NSAssert(0 == cart.count && 0 == cart.quantity && [cart.value isEqualToNumber:@0],
+             @"Expected empty cart after checkout");
+    NSAssert(![[NSFileManager defaultManager] fileExistsAtPath:self.path],
+             @"Expected no persisted cart after checkout");
+}
+
+- (void)testCartSurvivesRelaunch
+{
+    RITrackingCart *cart = [[RITrackingCart alloc] initWithPath:self.path];
+    
+    [cart addProduct:[self productWithIdentifier:@"a" price:@"1.25" quantity:@2]];
+    [cart addProduct:[self productWithIdentifier:@"b" price:@"4.00" quantity:@1]];
+    [cart removeProductWithIdentifier:@"a" quantity:@1];
+    
+    RITrackingCart *restored = [[RITrackingCart alloc] initWithPath:self.path];
+    RITrackingProduct *product = [[restored.products filteredArrayUsingPredicate:
+                                   [NSPredicate predicateWithFormat:@"identifier == 'a'"]] firstObject];
+    
+    NSAssert(2 == restored.count && 2 == restored.quantity, @"Expected products to be restored");
+    NSAssert([restored.value isEqualToNumber:[NSDecimalNumber decimalNumberWithString:@"5.25"]],
+             @"Expected value to be restored");
+    NSAssert([product.name isEqualToString:@"Product a"] && [product.currency isEqualToString:@"EUR"] &&
+             [product.quantity isEqualToNumber:@1], @"Expected product details to be restored");
+}
+
+@end
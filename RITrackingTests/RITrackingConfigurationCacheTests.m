@@ -0,0 +1,147 @@
+//
+//  RITrackingConfigurationCacheTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach_time.h>
+#import "RITrackingConfigurationCache.h"
+
+@interface RITrackingConfigurationCacheTests : XCTestCase
+
+@property NSString *path;
+@property NSString *directory;
+
+@end
+
+@implementation RITrackingConfigurationCacheTests
+
+- (void)setUp
+{
+    [super setUp];
+    NSString *base = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtPath:base
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:NULL];
+    self.path = [base stringByAppendingPathComponent:@"RITracking.plist"];
+    self.directory = [base stringByAppendingPathComponent:@"cache"];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:[self.path stringByDeletingLastPathComponent]
+                                               error:NULL];
+    [super tearDown];
+}
+
+- (void)testCompiledConfigurationKeepsValuesAndRecompilesOnChange
+{
+    NSDictionary *properties = @{@"string": @"foo",
+                                 @"integer": @42,
+                                 @"real": @0.5,
+                                 @"boolean": @YES,
+                                 @"routes": @[@"app://shop/d/{sku}", @{@"nested": @1}]};
+    [properties writeToFile:self.path atomically:YES];
+    
+    RITrackingConfigurationCache *cache = [RITrackingConfigurationCache
+                                           cacheForPropertyListAtPath:self.path
+                                           directory:self.directory];
+    
+    NSAssert([[cache dictionary] isEqualToDictionary:properties], @"Expected values to be kept");
+    NSAssert(nil == [cache objectForKey:@"missing"], @"Expected missing key to have no value");
+    NSAssert([[cache objectForKey:@"boolean"] isEqual:@YES], @"Expected boolean lookup");
+    
+    [@{@"string": @"bar"} writeToFile:self.path atomically:YES];
+    cache = [RITrackingConfigurationCache cacheForPropertyListAtPath:self.path directory:self.directory];
+    
+    NSAssert([[cache objectForKey:@"string"] isEqualToString:@"bar"] && 1 == cache.count,
+             @"Expected changed source to be compiled again");
+    
+    NSAssert(nil == [RITrackingConfigurationCache cacheForPropertyListAtPath:[self.path stringByAppendingString:@"x"]
+                                                                   directory:self.directory],
+             @"Expected missing source to give no configuration");
+}
+
+- (void)testTouchedSourceIsNotReadAgainOnLaterLoads
+{
+    NSDate *compiled = [NSDate dateWithTimeIntervalSince1970:1000000000];
+    NSDate *touched = [NSDate dateWithTimeIntervalSince1970:1000000100];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    
+    [@{@"string": @"foo"} writeToFile:self.path atomically:YES];
+    [fileManager setAttributes:@{NSFileModificationDate: compiled} ofItemAtPath:self.path error:NULL];
+    [RITrackingConfigurationCache cacheForPropertyListAtPath:self.path directory:self.directory];
+    
+    // Touching the source without changing it keeps the compiled file, with the new time
+    [fileManager setAttributes:@{NSFileModificationDate: touched} ofItemAtPath:self.path error:NULL];
+    RITrackingConfigurationCache *cache = [RITrackingConfigurationCache
+                                           cacheForPropertyListAtPath:self.path
+                                           directory:self.directory];
+    NSAssert([[cache objectForKey:@"string"] isEqualToString:@"foo"], @"Expected unchanged value");
+    
+    // Size and time matching the compiled file skip reading the source, so a change of the same
+    // size keeping the time goes unnoticed
+    [@{@"string": @"bar"} writeToFile:self.path atomically:YES];
+    [fileManager setAttributes:@{NSFileModificationDate: touched} ofItemAtPath:self.path error:NULL];
+    cache = [RITrackingConfigurationCache cacheForPropertyListAtPath:self.path directory:self.directory];
+    
+    NSAssert([[cache objectForKey:@"string"] isEqualToString:@"foo"],
+             @"Expected the compiled file to record the time of the touched source");
+}
+
+- (void)testStartupBenchmarkOfXMLAndCompiledConfiguration
+{
+    static NSUInteger const kIterations = 50;
+    
+    NSMutableDictionary *properties = [NSMutableDictionary dictionary];
+    for (NSUInteger idx = 0; idx < 500; idx++) {
+        properties[[NSString stringWithFormat:@"RITrackingSetting%lu", (unsigned long)idx]] =
+        [[NSUUID UUID] UUIDString];
+    }
+    NSMutableArray *routes = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 500; idx++) {
+        [routes addObject:@{@"pattern": [NSString stringWithFormat:@"app://shop/r%lu/{id}", (unsigned long)idx],
+                            @"sampling": @0.25}];
+    }
+    properties[@"RITrackingRoutes"] = routes;
+    [properties writeToFile:self.path atomically:YES];
+    
+    NSArray *keys = @[@"RITrackingSetting1", @"RITrackingSetting250", @"RITrackingSetting499"];
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    
+    uint64_t start = mach_absolute_time();
+    for (NSUInteger i = 0; i < kIterations; i++) {
+        NSDictionary *dictionary = [NSDictionary dictionaryWithContentsOfFile:self.path];
+        for (NSString *key in keys) NSAssert(dictionary[key], @"Expected value");
+    }
+    uint64_t current = (mach_absolute_time() - start) * timebase.numer / timebase.denom;
+    
+    start = mach_absolute_time();
+    for (NSUInteger i = 0; i < kIterations; i++) {
+        [[NSFileManager defaultManager] removeItemAtPath:self.directory error:NULL];
+        RITrackingConfigurationCache *cache = [RITrackingConfigurationCache
+                                               cacheForPropertyListAtPath:self.path
+                                               directory:self.directory];
+        for (NSString *key in keys) NSAssert([cache objectForKey:key], @"Expected value");
+    }
+    uint64_t cold = (mach_absolute_time() - start) * timebase.numer / timebase.denom;
+    
+    start = mach_absolute_time();
+    for (NSUInteger i = 0; i < kIterations; i++) {
+        RITrackingConfigurationCache *cache = [RITrackingConfigurationCache
+                                               cacheForPropertyListAtPath:self.path
+                                               directory:self.directory];
+        for (NSString *key in keys) NSAssert([cache objectForKey:key], @"Expected value");
+    }
+    uint64_t warm = (mach_absolute_time() - start) * timebase.numer / timebase.denom;
+    
+    NSLog(@"Configuration load: current XML %.1fus, cold XML and compile %.1fus, warm binary %.1fus",
+          current / 1000.0 / kIterations, cold / 1000.0 / kIterations, warm / 1000.0 / kIterations);
+}
+
+@end
@@ -0,0 +1,115 @@
+//
+//  RITrackingConfigurationTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RITrackingConfiguration.h"
+
+@interface RITrackingConfiguration ()
+
++ (void)clear;
+
+@end
+
+@interface RITrackingConfigurationTests : XCTestCase
+
+@property NSString *path;
+
+@end
+
+@implementation RITrackingConfigurationTests
+
+- (void)setUp
+{
+    [super setUp];
+    [RITrackingConfiguration clear];
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
+- (void)tearDown
+{
+    [[NSFileManager defaultManager] removeItemAtPath:self.path error:NULL];
+    [RITrackingConfiguration clear];
+    [super tearDown];
+}
+
+- (void)testReloadPublishesNewSnapshotAndNotifiesChangedKeys
+{
+    [@{@"foo": @"1", @"bar": @"1"} writeToFile:self.path atomically:YES];
+    NSAssert([RITrackingConfiguration loadFromPropertyListAtPath:self.path], @"Expected load");
+    RITrackingConfigurationSnapshot *snapshot = [RITrackingConfiguration snapshot];
+    
+    __block NSSet *changedKeys;
+    id observer = [[NSNotificationCenter defaultCenter]
+                   addObserverForName:kRITrackingConfigurationDidChangeNotification
+                   object:nil
+                   queue:nil
+                   usingBlock:^(NSNotification *notification) {
+                       changedKeys = notification.userInfo[kRITrackingConfigurationChangedKeysKey];
+                   }];
+    
+    [@{@"foo": @"1", @"bar": @"2", @"baz": @"3"} writeToFile:self.path atomically:YES];
+    NSAssert([RITrackingConfiguration loadFromPropertyListAtPath:self.path], @"Expected reload");
+    [[NSNotificationCenter defaultCenter] removeObserver:observer];
+    
+    NSAssert([[snapshot objectForKey:@"bar"] isEqualToString:@"1"],
+             @"Expected previous snapshot to stay unchanged");
+    NSAssert([[RITrackingConfiguration valueForKey:@"bar"] isEqualToString:@"2"],
+             @"Expected reloaded value");
+    NSAssert([RITrackingConfiguration snapshot].version == snapshot.version + 1,
+             @"Expected version to increase with reload");
+    NSAssert([changedKeys isEqualToSet:([NSSet setWithObjects:@"bar", @"baz", nil])],
+             @"Expected only changed keys to be notified");
+}
+
+- (void)testSupersededSnapshotIsFreedOnceNoReaderHoldsIt
+{
+    [@{@"foo": @"1"} writeToFile:self.path atomically:YES];
+    [RITrackingConfiguration loadFromPropertyListAtPath:self.path];
+    
+    __weak RITrackingConfigurationSnapshot *superseded;
+    __weak RITrackingConfigurationSnapshot *held;
+    RITrackingConfigurationSnapshot *reader;
+    @autoreleasepool {
+        superseded = [RITrackingConfiguration snapshot];
+        [RITrackingConfiguration loadFromPropertyListAtPath:self.path];
+        reader = [RITrackingConfiguration snapshot];
+        held = reader;
+        [RITrackingConfiguration loadFromPropertyListAtPath:self.path];
+    }
+    
+    NSAssert(!superseded, @"Expected a superseded snapshot without readers to be freed");
+    NSAssert(held && [[reader objectForKey:@"foo"] isEqualToString:@"1"],
+             @"Expected a superseded snapshot to stay valid while a reader holds it");
+    reader = nil;
+    NSAssert(!held, @"Expected a superseded snapshot to be freed once its reader released it");
+}
+
+- (void)testConcurrentReadersNeverSeeMissingValuesDuringReload
+{
+    [@{@"foo": @"1"} writeToFile:self.path atomically:YES];
+    [RITrackingConfiguration loadFromPropertyListAtPath:self.path];
+    
+    __block BOOL done = NO;
+    __block NSUInteger missing = 0;
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        while (!done) {
+            if (![RITrackingConfiguration valueForKey:@"foo"]) missing++;
+        }
+    });
+    
+    for (NSUInteger i = 0; i < 100; i++) {
+        [RITrackingConfiguration loadFromPropertyListAtPath:self.path];
+    }
+    done = YES;
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    
+    NSAssert(0 == missing, @"Readers should never see a partially loaded configuration");
+}
+
+@end
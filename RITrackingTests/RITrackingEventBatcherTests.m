@@ -0,0 +1,61 @@
+//
+//  RITrackingEventBatcherTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "RITrackingEventBatcher.h"
+#import "XCTestCase+AsyncTesting.h"
+
+@interface RITrackingEventBatcherTests : XCTestCase
+
+@end
+
+@implementation RITrackingEventBatcherTests
+
+- (void)testBatcherHandsOnBatchOnReachingMaxCount
+{
+    NSMutableArray *batches = [NSMutableArray array];
+    RITrackingEventBatcher *batcher = [[RITrackingEventBatcher alloc] initWithInterval:60
+                                                                              maxCount:3
+                                                                               handler:^(NSArray *events) {
+                                                                                   [batches addObject:events];
+                                                                               }];
+    for (NSUInteger idx = 0; idx < 7; idx++) {
+        [batcher addEvent:@(idx)];
+    }
+    
+    NSAssert(2 == batches.count, @"Expected two full batches to be handed on");
+    NSAssert([batches[0] isEqualToArray:(@[@0, @1, @2])], @"Expected first batch in tracking order");
+    NSAssert([batches[1] isEqualToArray:(@[@3, @4, @5])], @"Expected second batch in tracking order");
+    
+    [batcher flush];
+    
+    NSAssert(3 == batches.count && [batches[2] isEqualToArray:@[@6]],
+             @"Expected remaining event to be handed on when flushed");
+}
+
+- (void)testBatcherHandsOnBatchOnExpiringInterval
+{
+    __block NSArray *batch = nil;
+    RITrackingEventBatcher *batcher = [[RITrackingEventBatcher alloc] initWithInterval:0.1
+                                                                              maxCount:0
+                                                                               handler:^(NSArray *events) {
+                                                                                   batch = events;
+                                                                                   [self notify:XCTAsyncTestCaseStatusSucceeded];
+                                                                               }];
+    [batcher addEvent:@"foo"];
+    [batcher addEvent:@"bar"];
+    
+    NSAssert(nil == batch, @"Batch should not be handed on before its time window expired");
+    
+    [self waitForStatus:XCTAsyncTestCaseStatusSucceeded timeout:2];
+    
+    NSAssert([batch isEqualToArray:(@[@"foo", @"bar"])],
+             @"Expected all events of the time window to be handed on as one batch");
+}
+
+@end
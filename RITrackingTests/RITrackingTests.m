@@ -11,6 +11,7 @@
 #import "RITracking.h"
 #import "RIGoogleAnalyticsTracker.h"
 #import "RIBugSenseTracker.h"
+#import "RIEventRecord.h"
 #import "MBBlockSwizzle.h"
 #import "XCTestCase+AsyncTesting.h"
 #import <BugSense-iOS/BugSenseController.h>
@@ -21,6 +22,11 @@
 @interface RITracking ()
 
 @property NSArray *trackers;
+@property NSArray *eventTrackers;
+@property NSArray *screenTrackers;
+@property NSArray *exceptionTrackers;
+@property NSArray *openURLTrackers;
+@property id pipeline;
 
 + (void)reset;
 
@@ -32,6 +38,28 @@
 
 @end
 
+/**
+ *  Assertion handler counting failed assertions instead of raising, as in release builds
+ */
+@interface RITrackingTestsAssertionHandler : NSAssertionHandler
+
+@property NSUInteger failureCount;
+
+@end
+
+@implementation RITrackingTestsAssertionHandler
+
+- (void)handleFailureInMethod:(SEL)selector
+                       object:(id)object
+                         file:(NSString *)fileName
+                   lineNumber:(NSInteger)line
+                  description:(NSString *)format, ...
+{
+    self.failureCount++;
+}
+
+@end
+
 @interface RITrackingTests : XCTestCase
 
 @end
@@ -127,7 +155,7 @@ NSDictionary *kTestTrackingConfigurationPropertyListDictionary;
                              YES,
                              ^NSDictionary*(Class class, NSString *filePath)
                              {
-                                 return [NSDictionary dictionary];
+                                 return kTestTrackingConfigurationPropertyListDictionary;
                              }, ^{
                                  [[RITracking sharedInstance] startWithConfigurationFromPropertyListAtPath:@"foo"
                                                                                              launchOptions:launchOptions];
@@ -139,6 +167,297 @@ NSDictionary *kTestTrackingConfigurationPropertyListDictionary;
                              });
 }
 
+- (void)testTrackingStartCreatesOnlyTrackersEnabledByConfiguration
+{
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class class, NSString *filePath)
+                             {
+                                 return [NSDictionary dictionary];
+                             }, ^{
+                                 [[RITracking sharedInstance] startWithConfigurationFromPropertyListAtPath:@"foo"
+                                                                                             launchOptions:nil];
+                                 NSAssert(0 == [RITracking sharedInstance].trackers.count,
+                                          @"No tracker should be created without its configuration keys");
+                             });
+    
+    [RITracking reset];
+    
+    NSMutableDictionary *configuration = [kTestTrackingConfigurationPropertyListDictionary mutableCopy];
+    configuration[@"RIBugsenseEnabled"] = @NO;
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class class, NSString *filePath)
+                             {
+                                 return configuration;
+                             }, ^{
+                                 [[RITracking sharedInstance] startWithConfigurationFromPropertyListAtPath:@"foo"
+                                                                                             launchOptions:nil];
+                                 NSArray *trackers = [RITracking sharedInstance].trackers;
+                                 NSAssert(1 == trackers.count &&
+                                          [trackers[0] isKindOfClass:RIGoogleAnalyticsTracker.class],
+                                          @"Disabled Bugsense tracker should not be created");
+                             });
+}
+
+- (void)testTrackingStartBuildsPerProtocolDispatchTables
+{
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class c, NSString *filePath)
+                             {
+                                 return kTestTrackingConfigurationPropertyListDictionary;
+                             }, ^{
+                                 [[RITracking sharedInstance] startWithConfigurationFromPropertyListAtPath:@"foo"
+                                                                                             launchOptions:nil];
+                                 RITracking *tracking = [RITracking sharedInstance];
+                                 NSAssert(2 == tracking.exceptionTrackers.count,
+                                          @"Google Analytics and Bugsense trackers should track exceptions");
+                                 NSAssert(1 == tracking.eventTrackers.count &&
+                                          [tracking.eventTrackers[0] isKindOfClass:RIGoogleAnalyticsTracker.class],
+                                          @"Only the Google Analytics tracker should track events");
+                                 NSAssert(1 == tracking.screenTrackers.count &&
+                                          [tracking.screenTrackers[0] isKindOfClass:RIGoogleAnalyticsTracker.class],
+                                          @"Only the Google Analytics tracker should track screens");
+                                 NSAssert(0 == tracking.openURLTrackers.count,
+                                          @"No tracker should track open URLs");
+                             });
+}
+
+- (void)testTrackingCallsBeforeStartAreReplayedInOrderOnStart
+{
+    NSString * const kScreenName = [[NSUUID UUID] UUIDString];
+    NSString * const kEvent = [[NSUUID UUID] UUIDString];
+    NSMutableArray *calls = [NSMutableArray array];
+    
+    MBSwizzleRevertBlock revertScreen =
+    MBSwizzleWithBlock(NSStringFromClass(RIGoogleAnalyticsTracker.class),
+                       @selector(trackScreenWithName:),
+                       NO,
+                       ^(id tracker, NSString *name)
+                       {
+                           @synchronized(calls) { [calls addObject:name]; }
+                       });
+    MBSwizzleRevertBlock revertEvent =
+    MBSwizzleWithBlock(NSStringFromClass(RIGoogleAnalyticsTracker.class),
+                       @selector(trackEventRecord:),
+                       NO,
+                       ^(id tracker, const RIEventRecord *record)
+                       {
+                           @synchronized(calls) { [calls addObject:RIEventRecordName(record)]; }
+                       });
+    
+    [[RITracking sharedInstance] trackScreenWithName:kScreenName];
+    [[RITracking sharedInstance] trackEvent:kEvent value:nil action:nil category:nil data:nil];
+    
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class c, NSString *filePath)
+                             {
+                                 return kTestTrackingConfigurationPropertyListDictionary;
+                             }, ^{
+                                 [[RITracking sharedInstance] startWithConfigurationFromPropertyListAtPath:@"foo"
+                                                                                             launchOptions:nil];
+                                 [self waitForTimeout:1];
+                                 @synchronized(calls) {
+                                     NSAssert([calls isEqualToArray:(@[kScreenName, kEvent])],
+                                              @"Tracking calls made before start should be replayed in order");
+                                 }
+                                 NSAssert(0 == [RITracking sharedInstance].preStartDroppedCount,
+                                          @"No tracking call should be dropped");
+                                 revertScreen();
+                                 revertEvent();
+                             });
+}
+
+- (void)testEcommerceCallsBeforeStartAreReplayedAfterOtherTrackingCalls
+{
+    NSString * const kScreenName = [[NSUUID UUID] UUIDString];
+    NSString * const kTransactionId = [[NSUUID UUID] UUIDString];
+    NSMutableArray *calls = [NSMutableArray array];
+    
+    MBSwizzleRevertBlock revertScreen =
+    MBSwizzleWithBlock(NSStringFromClass(RIGoogleAnalyticsTracker.class),
+                       @selector(trackScreenWithName:),
+                       NO,
+                       ^(id tracker, NSString *name)
+                       {
+                           @synchronized(calls) { [calls addObject:name]; }
+                       });
+    MBSwizzleRevertBlock revertCheckout =
+    MBSwizzleWithBlock(NSStringFromClass(RIGoogleAnalyticsTracker.class),
+                       @selector(trackCheckoutWithTransactionId:total:),
+                       NO,
+                       ^(id tracker, NSString *idTransaction, RITrackingTotal *total)
+                       {
+                           @synchronized(calls) { [calls addObject:idTransaction]; }
+                       });
+    
+    [[RITracking sharedInstance] trackCheckoutWithTransactionId:kTransactionId total:nil];
+    [[RITracking sharedInstance] trackScreenWithName:kScreenName];
+    
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class c, NSString *filePath)
+                             {
+                                 return kTestTrackingConfigurationPropertyListDictionary;
+                             }, ^{
+                                 [[RITracking sharedInstance] startWithConfigurationFromPropertyListAtPath:@"foo"
+                                                                                             launchOptions:nil];
+                                 [self waitForTimeout:1];
+                                 @synchronized(calls) {
+                                     NSAssert([calls isEqualToArray:(@[kScreenName, kTransactionId])],
+                                              @"E-commerce calls made before start should be replayed");
+                                 }
+                                 NSAssert(0 == [RITracking sharedInstance].preStartDroppedCount,
+                                          @"No tracking call should be dropped");
+                                 revertScreen();
+                                 revertCheckout();
+                             });
+}
+
+- (void)testTrackingCallsAfterFailedStartFailInsteadOfBeingHeld
+{
+    NSMutableDictionary *threadDictionary = [NSThread currentThread].threadDictionary;
+    RITrackingTestsAssertionHandler *assertionHandler = [[RITrackingTestsAssertionHandler alloc] init];
+    threadDictionary[NSAssertionHandlerKey] = assertionHandler;
+    
+    [[RITracking sharedInstance] trackScreenWithName:[[NSUUID UUID] UUIDString]];
+    [[RITracking sharedInstance] startWithConfigurationFromPropertyListAtPath:[[NSUUID UUID] UUIDString]
+                                                                launchOptions:nil];
+    NSUInteger failureCount = assertionHandler.failureCount;
+    [[RITracking sharedInstance] trackScreenWithName:[[NSUUID UUID] UUIDString]];
+    
+    [threadDictionary removeObjectForKey:NSAssertionHandlerKey];
+    
+    NSAssert(0 < failureCount, @"Loading the configuration should fail");
+    NSAssert(1 == [RITracking sharedInstance].preStartDroppedCount,
+             @"The tracking call held for the failed start should be dropped");
+    NSAssert(failureCount < assertionHandler.failureCount,
+             @"A tracking call after the failed start should raise an error");
+}
+
+- (void)testRestartStopsPreviousPipeline
+{
+    NSMutableDictionary *properties = [kTestTrackingConfigurationPropertyListDictionary mutableCopy];
+    properties[kRITrackingPipelineMode] = kRITrackingPipelineModeRing;
+    
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class c, NSString *filePath)
+                             {
+                                 return properties;
+                             }, ^{
+                                 RITracking *tracking = [RITracking sharedInstance];
+                                 [tracking startWithConfigurationFromPropertyListAtPath:@"foo" launchOptions:nil];
+                                 __weak id previousPipeline;
+                                 @autoreleasepool {
+                                     previousPipeline = tracking.pipeline;
+                                 }
+                                 [tracking startWithConfigurationFromPropertyListAtPath:@"foo" launchOptions:nil];
+                                 
+                                 // The drain thread releases its pipeline once stopped
+                                 NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:2];
+                                 BOOL stopped = NO;
+                                 while (!stopped && 0 < [deadline timeIntervalSinceNow]) {
+                                     [NSThread sleepForTimeInterval:0.01];
+                                     @autoreleasepool {
+                                         stopped = !previousPipeline;
+                                     }
+                                 }
+                                 NSAssert(stopped, @"The pipeline of the previous start should be stopped");
+                             });
+}
+
+- (void)testRestartHandsOnEventsBatchedByPreviousStart
+{
+    NSString * const kEvent = [[NSUUID UUID] UUIDString];
+    NSMutableArray *calls = [NSMutableArray array];
+    NSMutableDictionary *properties = [kTestTrackingConfigurationPropertyListDictionary mutableCopy];
+    properties[kRITrackingEventBatchInterval] = @60;
+    
+    MBSwizzleRevertBlock revertEvents =
+    MBSwizzleWithBlock(NSStringFromClass(RIGoogleAnalyticsTracker.class),
+                       @selector(trackEvents:),
+                       NO,
+                       ^(id tracker, NSArray *events)
+                       {
+                           @synchronized(calls) {
+                               for (RITrackingEvent *event in events) [calls addObject:event.event];
+                           }
+                       });
+    
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class c, NSString *filePath)
+                             {
+                                 return properties;
+                             }, ^{
+                                 RITracking *tracking = [RITracking sharedInstance];
+                                 [tracking startWithConfigurationFromPropertyListAtPath:@"foo" launchOptions:nil];
+                                 [tracking trackEvent:kEvent value:nil action:nil category:nil data:nil];
+                                 [tracking startWithConfigurationFromPropertyListAtPath:@"foo" launchOptions:nil];
+                                 [self waitForTimeout:1];
+                                 @synchronized(calls) {
+                                     NSAssert([calls isEqualToArray:@[kEvent]],
+                                              @"Event batched before the restart should be tracked");
+                                 }
+                             });
+    revertEvents();
+}
+
+- (void)testAsynchronousStartQueuesCallsAndReportsPhaseDurations
+{
+    NSString * const kScreenName = [[NSUUID UUID] UUIDString];
+    NSMutableArray *calls = [NSMutableArray array];
+    
+    MBSwizzleRevertBlock revertScreen =
+    MBSwizzleWithBlock(NSStringFromClass(RIGoogleAnalyticsTracker.class),
+                       @selector(trackScreenWithName:),
+                       NO,
+                       ^(id tracker, NSString *name)
+                       {
+                           @synchronized(calls) { [calls addObject:name]; }
+                       });
+    
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class c, NSString *filePath)
+                             {
+                                 return kTestTrackingConfigurationPropertyListDictionary;
+                             }, ^{
+                                 __block NSDictionary *durations;
+                                 [[RITracking sharedInstance]
+                                  startAsynchronouslyWithConfigurationFromPropertyListAtPath:@"foo"
+                                  launchOptions:nil
+                                  completion:^(BOOL ready, NSDictionary *phaseDurations) {
+                                      NSAssert(ready, @"Tracking should be ready after start");
+                                      durations = phaseDurations;
+                                      [self notify:XCTAsyncTestCaseStatusSucceeded];
+                                  }];
+                                 [[RITracking sharedInstance] trackScreenWithName:kScreenName];
+                                 [self waitForStatus:XCTAsyncTestCaseStatusSucceeded timeout:5];
+                                 [self waitForTimeout:1];
+                                 NSSet *phases = [NSSet setWithObjects:kRITrackingStartPhaseConfiguration,
+                                                  kRITrackingStartPhaseTrackers, kRITrackingStartPhasePipeline,
+                                                  kRITrackingStartPhaseReplay, nil];
+                                 NSAssert([[NSSet setWithArray:durations.allKeys] isEqualToSet:phases],
+                                          @"Completion should report the duration of each start phase");
+                                 @synchronized(calls) {
+                                     NSAssert([calls isEqualToArray:@[kScreenName]],
+                                              @"Tracking call made during start should be tracked");
+                                 }
+                             });
+    revertScreen();
+}
 
 - (void)testTrackingConfigurationLoadingFromPropertyListFile
 {
@@ -305,6 +624,42 @@ NSDictionary *kTestTrackingConfigurationPropertyListDictionary;
                              });
 }
 
+- (void)testTrackingOnEvalOpenURLCallsHandlersRegisteredAsRouteTable
+{
+    NSString * const kProductSKU = [[NSUUID UUID] UUIDString];
+    NSMutableArray *calls = [NSMutableArray array];
+    MBSwizzleWithBlockAndRun(@"NSDictionary",
+                             @selector(dictionaryWithContentsOfFile:),
+                             YES,
+                             ^NSDictionary*(Class c, NSString *filePath)
+                             {
+                                 return kTestTrackingConfigurationPropertyListDictionary;
+                             }, ^{
+                                 [[RITracking sharedInstance] startWithConfigurationFromPropertyListAtPath:@"foo"
+                                                                                             launchOptions:nil];
+                                 [[RITracking sharedInstance] registerHandlersForOpenURLPatterns:@[
+                                     @[@".*/d/{sku}", ^(NSDictionary *params) {
+                                         NSAssert([params[@"sku"] isEqualToString:kProductSKU], @"Expected sku "
+                                                  @"parameter to be captured from open URL");
+                                         [calls addObject:@"sku"];
+                                     }],
+                                     @[@".*/c/{category}", ^(NSDictionary *params) {
+                                         NSAssert(NO, @"Unexpected call of non-matching registered open URL handler");
+                                     }],
+                                     @[@"^foobar://{host}/d/.*", ^(NSDictionary *params) {
+                                         [calls addObject:@"host"];
+                                     }],
+                                     @[@".*", ^(NSDictionary *params) {
+                                         [calls addObject:@"any"];
+                                     }]
+                                 ]];
+                                 NSString *urlString = [NSString stringWithFormat:@"foobar://com.foobar/d/%@", kProductSKU];
+                                 [[RITracking sharedInstance] trackOpenURL:[NSURL URLWithString:urlString]];
+                                 NSAssert([calls isEqualToArray:(@[@"sku", @"host", @"any"])],
+                                          @"Expected matching route table handlers to be called once in table order");
+                             });
+}
+
 - (void)testGoogleAnalyticsTrackerInitialization
 {
     id trackerMock = [OCMockObject mockForProtocol:@protocol(GAITracker)];
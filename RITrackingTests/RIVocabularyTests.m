@@ -0,0 +1,199 @@
+//
+//  RIVocabularyTests.m
+//  RITracking
+//
+//  Created by Martin Biermann on 17/10/26.
+//  Copyright (c) 2026 Martin Biermann. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach_time.h>
+#import <malloc/malloc.h>
+#import "RIVocabulary.h"
+#import "RIEventRecord.h"
+
+static NSUInteger const kBenchmarkEventCount = 1000000;
+static NSUInteger const kBenchmarkVocabularySize = 50;
+
+/**
+ *  Event names as carried before interning, each record retaining its own strings
+ */
+typedef struct RIBenchmarkStringRecord {
+    const void *names[RI_EVENT_RECORD_NAMES];
+} RIBenchmarkStringRecord;
+
+static size_t RIBenchmarkBytesInUse(void)
+{
+    malloc_statistics_t statistics;
+    malloc_zone_statistics(NULL, &statistics);
+    return statistics.size_in_use;
+}
+
+@interface RIVocabularyTests : XCTestCase
+
+@end
+
+@implementation RIVocabularyTests
+
+- (void)testVocabularyInternsEqualNamesToTheSameIdentifier
+{
+    NSString *name = [NSString stringWithFormat:@"RIVocabularyTests-%@", @"event"];
+    RIVocabularyIdentifier identifier = RIVocabularyIntern(name);
+    
+    NSAssert(RIVocabularyIdentifierNone != identifier, @"Expected name to be interned");
+    NSAssert(identifier == RIVocabularyIntern([name mutableCopy]),
+             @"Expected equal names to share an identifier");
+    NSAssert(identifier != RIVocabularyIntern(@"RIVocabularyTests-action"),
+             @"Expected different names to have different identifiers");
+    NSAssert([RIVocabularyName(identifier) isEqualToString:name], @"Expected name to be resolved");
+    NSAssert(RIVocabularyCount() >= identifier, @"Expected identifier to be counted");
+}
+
+- (void)testVocabularyKeepsNilAndCopiesMutableNames
+{
+    NSAssert(RIVocabularyIdentifierNone == RIVocabularyIntern(nil), @"Expected nil to have no identifier");
+    NSAssert(nil == RIVocabularyName(RIVocabularyIdentifierNone), @"Expected no identifier to be nil");
+    NSAssert(nil == RIVocabularyName(UINT32_MAX), @"Expected unknown identifier to be nil");
+    
+    NSMutableString *name = [NSMutableString stringWithString:@"RIVocabularyTests-mutable"];
+    RIVocabularyIdentifier identifier = RIVocabularyIntern(name);
+    [name appendString:@"-changed"];
+    
+    NSAssert([RIVocabularyName(identifier) isEqualToString:@"RIVocabularyTests-mutable"],
+             @"Expected interned name not to change with its source");
+}
+
+- (void)testVocabularyInternsConcurrently
+{
+    NSMutableArray *names = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 100; idx++) {
+        [names addObject:[NSString stringWithFormat:@"RIVocabularyTests-concurrent-%lu", (unsigned long)idx]];
+    }
+    
+    RIVocabularyIdentifier (*identifiers)[100] = calloc(8, sizeof(*identifiers));
+    dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t thread) {
+        for (NSUInteger idx = 0; idx < names.count; idx++) {
+            identifiers[thread][idx] = RIVocabularyIntern(names[(idx + thread * 13) % names.count]);
+        }
+    });
+    
+    for (size_t thread = 0; thread < 8; thread++) {
+        for (NSUInteger idx = 0; idx < names.count; idx++) {
+            NSString *name = names[(idx + thread * 13) % names.count];
+            NSAssert([RIVocabularyName(identifiers[thread][idx]) isEqualToString:name],
+                     @"Expected every thread to resolve the same identifier per name");
+        }
+    }
+    free(identifiers);
+}
+
+- (void)testEventRecordCarriesInternedNames
+{
+    RIEventRecord record = RIEventRecordMakeEvent(@"event", @1, @"action", @"category", nil);
+    
+    NSAssert(record.names[0] == RIVocabularyIntern(@"event") &&
+             record.names[1] == RIVocabularyIntern(@"action") &&
+             record.names[2] == RIVocabularyIntern(@"category"),
+             @"Expected record names to be interned");
+    NSAssert([RIEventRecordName(&record) isEqualToString:@"event"], @"Expected record name to be resolved");
+    
+    RIEventRecordDispose(&record);
+}
+
+- (void)testEventRecordCarriesNamesBeyondCapacityAsStrings
+{
+    RIVocabularyIdentifier interned = RIVocabularyIntern(@"RIVocabularyTests-interned");
+    RIVocabularySetCapacity(RIVocabularyCount());
+    
+    NSString *event = [[NSUUID UUID] UUIDString];
+    RIEventRecord record = RIEventRecordMakeEvent(event, nil, @"RIVocabularyTests-interned", nil, nil);
+    NSUInteger count = RIVocabularyCount();
+    RIVocabularySetCapacity(4096);
+    
+    NSAssert(RIVocabularyIdentifierNone == record.names[0] && interned == record.names[1],
+             @"Expected only names already interned to be interned once the vocabulary is full");
+    NSAssert(count == RIVocabularyCount(), @"Expected no name to be interned beyond the capacity");
+    NSAssert([RIEventRecordNameAtIndex(&record, 0) isEqualToString:event] &&
+             [RIEventRecordNameAtIndex(&record, 1) isEqualToString:@"RIVocabularyTests-interned"] &&
+             nil == RIEventRecordNameAtIndex(&record, 2),
+             @"Expected names beyond the capacity to be carried as strings");
+    NSAssert([RIEventRecordName(&record) isEqualToString:event], @"Expected record name to be resolved");
+    
+    RIEventRecordDispose(&record);
+}
+
+/**
+ *  Hold 1M synthetic events, with names built at runtime from a 50 word vocabulary, once as retained
+ *  strings and once as interned identifiers, and report CPU time and heap growth of both.
+ */
+- (void)testBenchmarkInternedNamesAgainstStrings
+{
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    
+    // Warm the vocabulary, as a running app would have
+    for (NSUInteger idx = 0; idx < kBenchmarkVocabularySize; idx++) {
+        RIVocabularyIntern([NSString stringWithFormat:@"benchmark-%lu", (unsigned long)idx]);
+    }
+    
+    for (NSNumber *interned in @[@NO, @YES]) {
+        size_t bytes = RIBenchmarkBytesInUse();
+        uint64_t start = mach_absolute_time();
+        uint64_t hash = 0;
+        
+        RIBenchmarkStringRecord *strings = NULL;
+        RIEventRecord *records = NULL;
+        if (interned.boolValue) {
+            records = calloc(kBenchmarkEventCount, sizeof(RIEventRecord));
+        } else {
+            strings = calloc(kBenchmarkEventCount, sizeof(RIBenchmarkStringRecord));
+        }
+        
+        for (NSUInteger idx = 0; idx < kBenchmarkEventCount; idx++) {
+            @autoreleasepool {
+                for (NSUInteger name = 0; name < RI_EVENT_RECORD_NAMES; name++) {
+                    NSString *string = [NSString stringWithFormat:@"benchmark-%lu",
+                                        (unsigned long)((idx + name * 17) % kBenchmarkVocabularySize)];
+                    if (interned.boolValue) {
+                        records[idx].kind = RIEventRecordKindEvent;
+                        records[idx].names[name] = RIVocabularyIntern(string);
+                    } else {
+                        strings[idx].names[name] = CFBridgingRetain(string);
+                    }
+                }
+            }
+        }
+        
+        size_t heldBytes = RIBenchmarkBytesInUse() - bytes;
+        
+        // Hand every event on as a tracker would, comparing names against a known one
+        NSString *probe = @"benchmark-7";
+        RIVocabularyIdentifier probeIdentifier = RIVocabularyIntern(probe);
+        for (NSUInteger idx = 0; idx < kBenchmarkEventCount; idx++) {
+            if (interned.boolValue) {
+                hash += records[idx].names[0] == probeIdentifier;
+            } else {
+                hash += [(__bridge NSString *)strings[idx].names[0] isEqualToString:probe];
+            }
+        }
+        
+        double seconds = (mach_absolute_time() - start) * timebase.numer / timebase.denom / 1e9;
+        
+        for (NSUInteger idx = 0; strings && idx < kBenchmarkEventCount; idx++) {
+            for (NSUInteger name = 0; name < RI_EVENT_RECORD_NAMES; name++) {
+                CFRelease(strings[idx].names[name]);
+            }
+        }
+        free(strings);
+        free(records);
+        
+        NSAssert(kBenchmarkEventCount / kBenchmarkVocabularySize == hash,
+                 @"Expected every 50th event to match the probe");
+        NSLog(@"RIVocabularyBenchmark %@ events=%lu cpu=%.3fs heap=%.1fMB (%.1fB/event)",
+              interned.boolValue ? @"interned" : @"strings ",
+              (unsigned long)kBenchmarkEventCount, seconds, heldBytes / 1e6,
+              (double)heldBytes / kBenchmarkEventCount);
+    }
+}
+
+@end